@@ -0,0 +1,158 @@
+/*
+ * Copyright 2021 Arteris IP
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace atp {
+/**
+ * @brief a model of the read or write FIFO of an ATP traffic profile
+ *
+ * A read FIFO is drained by its consumer with a constant rate and refilled by read transactions, a write FIFO is filled
+ * by its producer with a constant rate and drained by write transactions. The model is cycle based: the owner updates
+ * the fill level with the current clock cycle, asks how long to wait before the next transaction can be issued and
+ * reports issued and completed transactions. Cycles where the consumer finds the read FIFO empty are counted as
+ * underrun, cycles where the producer finds the write FIFO full are counted as overrun. Both indicate that the
+ * interconnect does not sustain the requested rate.
+ */
+class fifo_model {
+public:
+    /**
+     * @brief the constructor
+     * @param read true if this models a read FIFO, false for a write FIFO
+     * @param bytes_per_cycle the rate of the consumer (read) or producer (write)
+     * @param size the size of the FIFO in bytes
+     * @param start_full true if the FIFO starts full, otherwise it starts empty
+     * @param start_cycle the clock cycle the model starts
+     */
+    fifo_model(bool read, double bytes_per_cycle, uint64_t size, bool start_full, uint64_t start_cycle)
+    : read(read)
+    , bytes_per_cycle(bytes_per_cycle)
+    , size(size)
+    , level(start_full ? size : 0)
+    , start_cycle(start_cycle)
+    , last_cycle(start_cycle)
+    , end_cycle(start_cycle) {}
+
+    bool is_read() const { return read; }
+    /**
+     * @brief advance the model to the given cycle by draining (read) or filling (write) the FIFO
+     * @param cycle the current clock cycle
+     */
+    void update(uint64_t cycle) {
+        if(cycle <= last_cycle || finished)
+            return;
+        auto delta = (cycle - last_cycle) * bytes_per_cycle;
+        last_cycle = cycle;
+        if(read) {
+            if(delta > level) {
+                underrun += (delta - level) / bytes_per_cycle;
+                level = 0;
+            } else
+                level -= delta;
+        } else {
+            auto space = size - level;
+            if(delta > space) {
+                overrun += (delta - space) / bytes_per_cycle;
+                level = size;
+            } else
+                level += delta;
+        }
+    }
+    /**
+     * @brief the number of cycles to wait until a transaction of the given size can be issued
+     *
+     * A read can be issued if the FIFO has room for its data in addition to the data of all outstanding reads, a write
+     * can be issued if the FIFO holds enough data.
+     * @param txn_size the number of bytes of the transaction
+     * @return the number of cycles, 0 if the transaction can be issued immediately
+     */
+    uint64_t wait_cycles(unsigned txn_size) const {
+        auto missing = read ? level + reserved + txn_size - size : txn_size - level;
+        return missing > 0 ? static_cast<uint64_t>(std::ceil(missing / bytes_per_cycle)) : 0;
+    }
+    /**
+     * @brief register the issue of a transaction
+     * @param txn_size the number of bytes of the transaction
+     */
+    void issue(unsigned txn_size) {
+        if(read)
+            reserved += txn_size;
+        else
+            level = std::max(0.0, level - txn_size);
+    }
+    /**
+     * @brief register the completion of a transaction, for reads the data enters the FIFO
+     * @param cycle the current clock cycle
+     * @param txn_size the number of bytes of the transaction
+     */
+    void complete(uint64_t cycle, unsigned txn_size) {
+        update(cycle);
+        if(read) {
+            reserved -= std::min<uint64_t>(reserved, txn_size);
+            level = std::min<double>(size, level + txn_size);
+        }
+        transferred += txn_size;
+        end_cycle = std::max(end_cycle, cycle);
+    }
+    /**
+     * @brief stop the model, afterwards the level and the statistics do not change anymore
+     * @param cycle the current clock cycle
+     */
+    void finish(uint64_t cycle) {
+        update(cycle);
+        end_cycle = std::max(end_cycle, cycle);
+        finished = true;
+    }
+
+    bool is_finished() const { return finished; }
+
+    double get_level() const { return level; }
+
+    uint64_t get_size() const { return size; }
+
+    uint64_t get_transferred_bytes() const { return transferred; }
+
+    double get_underrun_cycles() const { return underrun; }
+
+    double get_overrun_cycles() const { return overrun; }
+
+    double get_requested_bytes_per_cycle() const { return bytes_per_cycle; }
+    /**
+     * @brief the bandwidth achieved from the start of the model until the last completion or finish
+     */
+    double get_achieved_bytes_per_cycle() const {
+        return end_cycle > start_cycle ? static_cast<double>(transferred) / (end_cycle - start_cycle) : 0.0;
+    }
+
+private:
+    bool const read;
+    double const bytes_per_cycle;
+    uint64_t const size;
+    double level;
+    uint64_t reserved{0};
+    uint64_t const start_cycle;
+    uint64_t last_cycle;
+    uint64_t end_cycle;
+    uint64_t transferred{0};
+    double underrun{0.0}, overrun{0.0};
+    bool finished{false};
+};
+
+} // namespace atp
@@ -17,18 +17,32 @@
 #pragma once
 
 #include <tlm>
+#include <vector>
 
 namespace atp {
 
+/**
+ * @brief the ATP timing of a transaction, overriding the timing configured in the initiator
+ *
+ * Extensions can be obtained from a free list using create(). An extension is returned to the free list once it is
+ * freed, e.g. as auto extension of a memory managed payload, so that attaching timings to each transaction of a
+ * generator does not allocate memory. The free list is not thread-safe as the SystemC kernel is single threaded.
+ */
 struct timing_params : public tlm::tlm_extension<timing_params> {
     tlm_extension_base* clone() const override {
-        timing_params* e = new timing_params(artv, awtv, wbv, rbr, br, start_soonest);
+        auto* e = create();
+        *e = *this;
         return e;
     }
 
-    void copy_from(tlm_extension_base const& from) override { assert(false && "copy_from() not supported"); }
+    void copy_from(tlm_extension_base const& from) override { *this = static_cast<timing_params const&>(from); }
+    //! return the extension to the free list instead of deleting it
+    void free() override {
+        reset();
+        free_list().push_back(this);
+    }
 
-    timing_params() = delete;
+    timing_params() = default;
 
     timing_params(unsigned artv, unsigned awtv, unsigned wbv, unsigned rbr, unsigned br, uint64_t start_soonest = 0)
     : artv(artv)
@@ -40,13 +54,54 @@ struct timing_params : public tlm::tlm_extension<timing_params> {
 
     explicit timing_params(uint64_t start_soonest)
     : start_soonest(start_soonest) {}
+    /**
+     * @brief get an extension from the free list or allocate a new one if the list is empty
+     * @return the extension with all timings set to 0
+     */
+    static timing_params* create() {
+        auto& fl = free_list();
+        if(fl.empty())
+            return new timing_params();
+        auto* e = fl.back();
+        fl.pop_back();
+        return e;
+    }
+
+    static timing_params* create(unsigned artv, unsigned awtv, unsigned wbv, unsigned rbr, unsigned br, uint64_t start_soonest = 0) {
+        auto* e = create();
+        e->artv = artv;
+        e->awtv = awtv;
+        e->wbv = wbv;
+        e->rbr = rbr;
+        e->br = br;
+        e->start_soonest = start_soonest;
+        return e;
+    }
 
-    const unsigned artv{0};
-    const unsigned awtv{0};
-    const unsigned wbv{0};
-    const unsigned rbr{0};
-    const unsigned br{0};
-    const uint64_t start_soonest{0};
+    static timing_params* create(uint64_t start_soonest) {
+        auto* e = create();
+        e->start_soonest = start_soonest;
+        return e;
+    }
+
+    void reset() {
+        artv = awtv = wbv = rbr = br = 0;
+        start_soonest = 0;
+    }
+
+    unsigned artv{0};
+    unsigned awtv{0};
+    unsigned wbv{0};
+    unsigned rbr{0};
+    unsigned br{0};
+    uint64_t start_soonest{0};
+
+private:
+    //! the pool is never destroyed so that extensions can be freed during static destruction, e.g. by memory managers
+    static std::vector<timing_params*>& free_list() {
+        static auto* pool = new std::vector<timing_params*>();
+        return *pool;
+    }
 };
 
 } // namespace atp
@@ -0,0 +1,779 @@
+/*
+ * Copyright 2021 Arteris IP
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "traffic_profile_unit.h"
+#include <algorithm>
+#include <array>
+#include <atp/timing_params.h>
+#include <axi/axi_tlm.h>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <random>
+#include <regex>
+#include <scc/report.h>
+#include <sstream>
+#include <tlm/scc/tlm_mm.h>
+#include <vector>
+#include <yaml-cpp/yaml.h>
+
+namespace atp {
+namespace {
+enum timing_e { ARTV, AWTV, WBV, RBR, BR, TIMING_CNT };
+const std::array<char const*, TIMING_CNT> timing_names{{"ARTV", "AWTV", "WBV", "RBR", "BR"}};
+//! ATP timings which have no counterpart in timing_params
+const std::array<char const*, 17> unsupported_timing_names{
+    {"ARR", "RIV", "RBV", "RLA", "AWV", "AWR", "WIV", "WBR", "BV", "BA", "ACTV", "ACR", "CRV", "CRR", "CDIV", "CDBR", "CDBV"}};
+
+enum signal_e { AXADDR, AXBURST, AXCACHE, AXID, AXLEN, AXLOCK, AXPROT, AXQOS, AXREGION, AXSIZE, WDATA, AWATOP, AWSTASHNID, AWSTASHLPID, SIGNAL_CNT };
+const std::array<char const*, SIGNAL_CNT> signal_names{{"AxADDR", "AxBURST", "AxCACHE", "AxID", "AxLEN", "AxLOCK", "AxPROT", "AxQOS",
+                                                        "AxREGION", "AxSIZE", "WDATA", "AWATOP", "AWSTASHNID", "AWSTASHLPID"}};
+//! signals driven by the target which can't be set by the TPU
+const std::array<char const*, 4> unsupported_signal_names{{"BRESP", "RDATA", "RRESP", "WSTRB"}};
+
+struct tx_type {
+    char const* name;
+    tlm::tlm_command cmd;
+    bool ace;
+    axi::snoop_e snoop;
+};
+// clang-format off
+const std::array<tx_type, 30> tx_types{{
+    {"READ",                 tlm::TLM_READ_COMMAND,  false, axi::snoop_e::READ_NO_SNOOP},
+    {"WRITE",                tlm::TLM_WRITE_COMMAND, false, axi::snoop_e::WRITE_NO_SNOOP},
+    {"ReadNoSnp",            tlm::TLM_READ_COMMAND,  true,  axi::snoop_e::READ_NO_SNOOP},
+    {"ReadNoSnoop",          tlm::TLM_READ_COMMAND,  true,  axi::snoop_e::READ_NO_SNOOP},
+    {"ReadOnce",             tlm::TLM_READ_COMMAND,  true,  axi::snoop_e::READ_ONCE},
+    {"ReadOnceCleanInvalid", tlm::TLM_READ_COMMAND,  true,  axi::snoop_e::READ_ONCE_CLEAN_INVALID},
+    {"ReadOnceMakeInvalid",  tlm::TLM_READ_COMMAND,  true,  axi::snoop_e::READ_ONCE_MAKE_INVALID},
+    {"ReadClean",            tlm::TLM_READ_COMMAND,  true,  axi::snoop_e::READ_CLEAN},
+    {"ReadNotSharedDirty",   tlm::TLM_READ_COMMAND,  true,  axi::snoop_e::READ_NOT_SHARED_DIRTY},
+    {"ReadShared",           tlm::TLM_READ_COMMAND,  true,  axi::snoop_e::READ_SHARED},
+    {"ReadUnique",           tlm::TLM_READ_COMMAND,  true,  axi::snoop_e::READ_UNIQUE},
+    {"WriteNoSnpFull",       tlm::TLM_WRITE_COMMAND, true,  axi::snoop_e::WRITE_NO_SNOOP},
+    {"WriteNoSnoop",         tlm::TLM_WRITE_COMMAND, true,  axi::snoop_e::WRITE_NO_SNOOP},
+    {"WriteUniqueFull",      tlm::TLM_WRITE_COMMAND, true,  axi::snoop_e::WRITE_UNIQUE},
+    {"WriteLineUniqueFull",  tlm::TLM_WRITE_COMMAND, true,  axi::snoop_e::WRITE_LINE_UNIQUE},
+    {"WriteBackFull",        tlm::TLM_WRITE_COMMAND, true,  axi::snoop_e::WRITE_BACK},
+    {"WriteClean",           tlm::TLM_WRITE_COMMAND, true,  axi::snoop_e::WRITE_CLEAN},
+    {"WriteEvict",           tlm::TLM_WRITE_COMMAND, true,  axi::snoop_e::WRITE_EVICT},
+    {"Evict",                tlm::TLM_WRITE_COMMAND, true,  axi::snoop_e::EVICT},
+    {"CleanShared",          tlm::TLM_READ_COMMAND,  true,  axi::snoop_e::CLEAN_SHARED},
+    {"CleanInvalid",         tlm::TLM_READ_COMMAND,  true,  axi::snoop_e::CLEAN_INVALID},
+    {"CleanSharedPersist",   tlm::TLM_READ_COMMAND,  true,  axi::snoop_e::CLEAN_SHARED_PERSIST},
+    {"MakeInvalid",          tlm::TLM_READ_COMMAND,  true,  axi::snoop_e::MAKE_INVALID},
+    {"CleanUnique",          tlm::TLM_READ_COMMAND,  true,  axi::snoop_e::CLEAN_UNIQUE},
+    {"MakeUnique",           tlm::TLM_READ_COMMAND,  true,  axi::snoop_e::MAKE_UNIQUE},
+    {"StashOnceUnique",      tlm::TLM_WRITE_COMMAND, true,  axi::snoop_e::STASH_ONCE_UNIQUE},
+    {"StashOnceShared",      tlm::TLM_WRITE_COMMAND, true,  axi::snoop_e::STASH_ONCE_SHARED},
+    {"WriteUniqueFullStash", tlm::TLM_WRITE_COMMAND, true,  axi::snoop_e::WRITE_UNIQUE_FULL_STASH},
+    {"WriteUniquePtlStash",  tlm::TLM_WRITE_COMMAND, true,  axi::snoop_e::WRITE_UNIQUE_PTL_STASH},
+    {"WriteNoSnp",           tlm::TLM_WRITE_COMMAND, true,  axi::snoop_e::WRITE_NO_SNOOP}
+}};
+// clang-format on
+
+bool iequals(std::string const& a, char const* b) {
+    auto len = std::strlen(b);
+    if(a.size() != len)
+        return false;
+    for(size_t i = 0; i < len; ++i)
+        if(std::tolower(a[i]) != std::tolower(b[i]))
+            return false;
+    return true;
+}
+
+template <size_t N> int find_name(std::string const& name, std::array<char const*, N> const& names) {
+    for(size_t i = 0; i < N; ++i)
+        if(iequals(name, names[i]))
+            return i;
+    return -1;
+}
+/**
+ * convert a YAML scalar to an unsigned integer accepting decimal, octal (0o or 0 prefix) and hexadecimal notation
+ */
+uint64_t to_uint(YAML::Node const& n) {
+    auto s = n.as<std::string>();
+    if(s.size() > 2 && s[0] == '0' && (s[1] == 'o' || s[1] == 'O'))
+        return strtoull(s.c_str() + 2, nullptr, 8);
+    return strtoull(s.c_str(), nullptr, 0);
+}
+
+std::vector<uint64_t> to_uint_list(YAML::Node const& n) {
+    std::vector<uint64_t> res;
+    if(n.IsSequence())
+        for(auto const& e : n)
+            res.push_back(to_uint(e));
+    else
+        res.push_back(to_uint(n));
+    return res;
+}
+/**
+ * convert a rate specification like '20 GBps', '1.5MB/s' or '800 Mbps' into bytes per second, returns a negative value
+ * if the unit is not recognized
+ */
+double to_bytes_per_sec(std::string const& spec) {
+    char* end;
+    auto val = strtod(spec.c_str(), &end);
+    while(*end && std::isspace(*end))
+        ++end;
+    std::string unit(end);
+    double scale = 1.0;
+    if(unit.size() && std::string("kKMGT").find(unit[0]) != std::string::npos) {
+        auto binary = unit.size() > 1 && unit[1] == 'i';
+        auto exp = std::string("kKMGT").find(unit[0]);
+        exp = exp ? exp : 1;
+        scale = std::pow(binary ? 1024.0 : 1000.0, exp);
+        unit = unit.substr(binary ? 2 : 1);
+    }
+    if(unit == "Bps" || unit == "B/s")
+        return val * scale;
+    if(unit == "bps" || unit == "b/s")
+        return val * scale / 8;
+    return -1.0;
+}
+
+std::string expand_variables(std::string const& content, std::unordered_map<std::string, std::string> const& vars) {
+    std::string res;
+    res.reserve(content.size());
+    size_t pos = 0;
+    while(true) {
+        auto start = content.find("${", pos);
+        if(start == std::string::npos)
+            break;
+        auto end = content.find('}', start);
+        if(end == std::string::npos)
+            break;
+        res.append(content, pos, start - pos);
+        auto it = vars.find(content.substr(start + 2, end - start - 2));
+        if(it != vars.end())
+            res.append(it->second);
+        else
+            res.append(content, start, end - start + 1);
+        pos = end + 1;
+    }
+    res.append(content, pos, std::string::npos);
+    return res;
+}
+
+std::string dir_name(std::string const& file_name) {
+    auto pos = file_name.find_last_of('/');
+    return pos == std::string::npos ? std::string() : file_name.substr(0, pos + 1);
+}
+/**
+ * the synchronizer collecting the messages posted by all TPUs
+ */
+struct synchronizer {
+    static synchronizer& get() {
+        static synchronizer inst;
+        return inst;
+    }
+    std::vector<std::string> tpus;
+    std::vector<std::pair<std::string, std::string>> posts;
+    sc_core::sc_event posted_evt;
+
+    bool is_posted(std::regex const* inst, std::regex const& evt) const {
+        auto match = [this, &evt](std::string const* src) {
+            for(auto const& p : posts)
+                if((!src || p.first == *src) && std::regex_search(p.second, evt))
+                    return true;
+            return false;
+        };
+        if(!inst)
+            return match(nullptr);
+        for(auto const& tpu : tpus)
+            if(std::regex_search(tpu, *inst) && !match(&tpu))
+                return false;
+        return true;
+    }
+};
+//! FNV-1a hash of a profile name, std::hash is not used as it differs between standard libraries
+uint64_t name_hash(std::string const& name) {
+    uint64_t h = 14695981039346656037ULL;
+    for(auto c : name)
+        h = (h ^ static_cast<uint8_t>(c)) * 1099511628211ULL;
+    return h;
+}
+} // namespace
+
+struct traffic_profile_unit::profile {
+    std::string name;
+    std::vector<tx_type const*> types;
+    //! the number of transactions to generate, 0 means unlimited
+    uint64_t count{0};
+    unsigned loop{1};
+    unsigned txn_limit{1};
+    unsigned txn_size{64};
+    //! the rate in bytes per second, 0 means unthrottled
+    double rate{0.0};
+    uint64_t fifo_full{0};
+    bool fifo_start_full{false};
+    enum { CYCLE, UNIQUE } id_type{CYCLE};
+    unsigned id_lower{0}, id_upper{1};
+    enum { SEQUENTIAL, RANDOM, TWODIM } addr_type{SEQUENTIAL};
+    uint64_t addr_base{0}, addr_range{1ULL << 32}, addr_xrange{0}, addr_stride{0};
+    //! the alignment of the addresses, 0 means the bus width and -1 means unaligned
+    int64_t addr_alignment{-1};
+    std::array<std::vector<uint64_t>, TIMING_CNT> timing;
+    std::array<std::vector<uint64_t>, SIGNAL_CNT> signals;
+};
+
+struct traffic_profile_unit::action {
+    enum { LIST, PROFILE, DELAY, POST, WAIT, MESSAGE, EXEC_STL } type{LIST};
+    bool parallel{true};
+    std::vector<std::unique_ptr<action>> children;
+    std::unique_ptr<profile> prof;
+    uint64_t cycles{0};
+    std::string text;
+    std::unique_ptr<std::regex> inst_re, event_re;
+};
+/**
+ * the state of a profile being executed
+ */
+struct traffic_profile_unit::profile_exec {
+    profile const& p;
+    std::mt19937_64 rng;
+    uint64_t issued{0};
+    unsigned outstanding{0};
+    uint64_t offset{0}, row{0};
+    std::deque<unsigned> free_ids;
+    //! the FIFO model if the profile is rate limited
+    fifo_model* fifo{nullptr};
+    sc_core::sc_event done_evt;
+
+    //! each profile draws its own random stream derived from the unit seed and its name
+    profile_exec(profile const& p, unsigned seed)
+    : p(p)
+    , rng(seed ^ name_hash(p.name)) {}
+
+    template <typename T> T get(std::vector<T> const& v) const { return v[issued % v.size()]; }
+};
+
+traffic_profile_unit::traffic_profile_unit(sc_core::sc_module_name const& nm, unsigned transfer_width)
+: sc_core::sc_module(nm)
+, transfer_width_in_bytes(transfer_width / 8) {
+#if SYSTEMC_VERSION < 20250221
+    SC_HAS_PROCESS(traffic_profile_unit);
+#endif
+    SC_THREAD(run);
+    synchronizer::get().tpus.push_back(name());
+}
+
+traffic_profile_unit::~traffic_profile_unit() = default;
+
+void traffic_profile_unit::end_of_elaboration() { clk_if = dynamic_cast<sc_core::sc_clock*>(clk_i.get_interface()); }
+
+void traffic_profile_unit::end_of_simulation() {
+    if(fifos.empty())
+        return;
+    auto const cycle = get_cycle();
+    auto const to_gbps = 1e-9 / clk_if->period().to_seconds();
+    for(auto& e : fifos) {
+        auto& fifo = e.second;
+        fifo.finish(cycle);
+        auto requested = fifo.get_requested_bytes_per_cycle() * to_gbps;
+        auto achieved = fifo.get_achieved_bytes_per_cycle() * to_gbps;
+        SCCINFO(SCMOD) << "profile " << e.first << ": requested " << requested << " GB/s, achieved " << achieved << " GB/s ("
+                       << (requested > 0 ? 100.0 * achieved / requested : 0.0) << "%), " << fifo.get_transferred_bytes()
+                       << " bytes transferred, " << (fifo.is_read() ? "read FIFO underrun " : "write FIFO overrun ")
+                       << static_cast<uint64_t>(std::ceil(fifo.is_read() ? fifo.get_underrun_cycles() : fifo.get_overrun_cycles()))
+                       << " cycles";
+    }
+}
+
+uint64_t traffic_profile_unit::get_cycle() const { return clk_if ? sc_core::sc_time_stamp().value() / clk_if->period().value() : 0; }
+
+void traffic_profile_unit::start_of_simulation() {
+    if(!profile_file_name.get_value().length())
+        return;
+    if(!clk_if)
+        SCCERR(SCMOD) << "The TPU requires a clock, only transactions without delays and rates can be generated";
+    try {
+        root = parse_file(profile_file_name.get_value(), {}, true);
+    } catch(YAML::Exception& e) {
+        SCCERR(SCMOD) << "Could not parse profile file " << profile_file_name.get_value() << ": " << e.what();
+        root.reset();
+    }
+}
+
+std::unique_ptr<traffic_profile_unit::action>
+traffic_profile_unit::parse_file(std::string const& file_name, std::unordered_map<std::string, std::string> const& vars, bool parallel) {
+    std::ifstream ifs(file_name);
+    if(!ifs.is_open()) {
+        SCCERR(SCMOD) << "Could not open profile file " << file_name;
+        return nullptr;
+    }
+    std::stringstream ss;
+    ss << ifs.rdbuf();
+    auto const base_dir = dir_name(file_name);
+    // the location of a node for diagnostics
+    auto loc = [&file_name](YAML::Node const& n) {
+        std::ostringstream os;
+        os << file_name << ":" << n.Mark().line + 1 << ":" << n.Mark().column + 1 << ": ";
+        return os.str();
+    };
+
+    std::function<std::unique_ptr<profile>(YAML::Node const&)> parse_profile = [&](YAML::Node const& item) {
+        std::unique_ptr<profile> p(new profile);
+        p->name = item["profile"].as<std::string>();
+        for(auto const& kv : item) {
+            auto key = kv.first.as<std::string>();
+            auto const& val = kv.second;
+            if(key == "profile" || key == "data") {
+                if(key == "data" && val.as<std::string>() != "random")
+                    SCCWARN(SCMOD) << loc(val) << "only random data is supported";
+            } else if(key == "type") {
+                std::vector<YAML::Node> names;
+                if(val.IsSequence())
+                    for(auto const& t : val)
+                        names.push_back(t);
+                else
+                    names.push_back(val);
+                for(auto const& t : names) {
+                    auto name = t.as<std::string>();
+                    auto it = std::find_if(std::begin(tx_types), std::end(tx_types), [&name](tx_type const& e) { return iequals(name, e.name); });
+                    if(it != std::end(tx_types))
+                        p->types.push_back(&*it);
+                    else
+                        SCCERR(SCMOD) << loc(t) << "unknown transaction type " << name;
+                }
+            } else if(key == "count") {
+                p->count = to_uint(val);
+            } else if(key == "loop") {
+                p->loop = to_uint(val);
+            } else if(key == "generator") {
+                for(auto const& g : val) {
+                    auto gkey = g.first.as<std::string>();
+                    if(gkey == "TxnLimit")
+                        p->txn_limit = std::max<unsigned>(1, to_uint(g.second));
+                    else if(gkey == "TxnSize")
+                        p->txn_size = to_uint(g.second);
+                    else if(gkey == "Rate")
+                        p->rate = to_bytes_per_sec(g.second.as<std::string>());
+                    else if(gkey == "Full")
+                        p->fifo_full = to_uint(g.second);
+                    else if(gkey == "Start") {
+                        auto lvl = g.second.as<std::string>();
+                        if(lvl != "full" && lvl != "empty")
+                            SCCERR(SCMOD) << loc(g.second) << "illegal FIFO start level " << lvl;
+                        p->fifo_start_full = lvl == "full";
+                    } else
+                        SCCERR(SCMOD) << loc(g.first) << "unknown generator key " << gkey;
+                }
+                if(p->rate < 0)
+                    SCCERR(SCMOD) << loc(val) << "illegal rate specification";
+            } else if(key == "trans_id") {
+                if(val["type"].IsDefined())
+                    p->id_type = val["type"].as<std::string>() == "unique" ? profile::UNIQUE : profile::CYCLE;
+                if(val["range"].IsDefined()) {
+                    p->id_lower = to_uint(val["range"][0]);
+                    p->id_upper = to_uint(val["range"][1]);
+                }
+            } else if(key == "address") {
+                if(val["type"].IsDefined()) {
+                    auto type = val["type"].as<std::string>();
+                    if(type == "sequential")
+                        p->addr_type = profile::SEQUENTIAL;
+                    else if(type == "random")
+                        p->addr_type = profile::RANDOM;
+                    else if(type == "twodim")
+                        p->addr_type = profile::TWODIM;
+                    else
+                        SCCERR(SCMOD) << loc(val["type"]) << "unknown address type " << type;
+                }
+                if(val["range"].IsDefined()) {
+                    p->addr_base = to_uint(val["range"][0]);
+                    p->addr_range = to_uint(val["range"][1]);
+                }
+                if(val["alignment"].IsDefined())
+                    p->addr_alignment = to_uint(val["alignment"]);
+                if(val["xrange"].IsDefined())
+                    p->addr_xrange = to_uint(val["xrange"]);
+                if(val["stride"].IsDefined())
+                    p->addr_stride = to_uint(val["stride"]);
+            } else if(key == "timing") {
+                for(auto const& t : val) {
+                    auto tname = t.first.as<std::string>();
+                    auto idx = find_name(tname, timing_names);
+                    if(idx >= 0)
+                        p->timing[idx] = to_uint_list(t.second);
+                    else if(find_name(tname, unsupported_timing_names) < 0) {
+                        SCCERR(SCMOD) << loc(t.first) << "unknown timing " << tname;
+                    } else
+                        SCCWARN(SCMOD) << loc(t.first) << "timing " << tname << " is not supported by the initiators and ignored";
+                }
+            } else if(key == "signals") {
+                for(auto const& s : val) {
+                    auto sname = s.first.as<std::string>();
+                    auto idx = find_name(sname, signal_names);
+                    if(idx >= 0)
+                        p->signals[idx] = to_uint_list(s.second);
+                    else if(find_name(sname, unsupported_signal_names) < 0) {
+                        SCCERR(SCMOD) << loc(s.first) << "unknown signal " << sname;
+                    } else
+                        SCCWARN(SCMOD) << loc(s.first) << "signal " << sname << " can not be set by the TPU and is ignored";
+                }
+            } else
+                SCCERR(SCMOD) << loc(kv.first) << "unknown profile key " << key;
+        }
+        if(p->types.empty()) {
+            SCCERR(SCMOD) << loc(item) << "profile " << p->name << " has no valid transaction type";
+            return std::unique_ptr<profile>();
+        }
+        if(!p->txn_size || (p->txn_size & (p->txn_size - 1)))
+            SCCERR(SCMOD) << loc(item) << "TxnSize of profile " << p->name << " is not a power of 2";
+        if(p->id_upper <= p->id_lower)
+            p->id_upper = p->id_lower + 1;
+        if(p->rate > 0) {
+            auto cmd = p->types.front()->cmd;
+            if(std::any_of(p->types.begin(), p->types.end(), [cmd](tx_type const* t) { return t->cmd != cmd; }))
+                SCCERR(SCMOD) << loc(item) << "profile " << p->name << " specifies a rate but mixes reads and writes";
+            if(!item["generator"]["Start"].IsDefined())
+                p->fifo_start_full = cmd == tlm::TLM_READ_COMMAND;
+            if(!p->fifo_full)
+                p->fifo_full = static_cast<uint64_t>(p->txn_size) * p->txn_limit;
+            if(p->fifo_full < p->txn_size)
+                SCCERR(SCMOD) << loc(item) << "FIFO size of profile " << p->name << " is smaller than TxnSize";
+        }
+        return p;
+    };
+
+    std::function<std::unique_ptr<action>(YAML::Node const&, bool)> parse_list = [&](YAML::Node const& list, bool par) {
+        std::unique_ptr<action> res(new action);
+        res->parallel = par;
+        if(!list.IsSequence()) {
+            SCCERR(SCMOD) << loc(list) << "expected a list";
+            return res;
+        }
+        for(auto const& item : list) {
+            if(!item.IsMap()) {
+                SCCERR(SCMOD) << loc(item) << "expected a dictionary";
+                continue;
+            }
+            if(item["parallel_execution"].IsDefined()) {
+                res->parallel = item["parallel_execution"].as<bool>();
+            } else if(item["profile"].IsDefined()) {
+                if(auto p = parse_profile(item)) {
+                    std::unique_ptr<action> a(new action);
+                    a->type = action::PROFILE;
+                    a->prof = std::move(p);
+                    res->children.emplace_back(std::move(a));
+                }
+            } else if(item["profile_list"].IsDefined()) {
+                res->children.emplace_back(parse_list(item["profile_list"], true));
+            } else if(item["include"].IsDefined()) {
+                auto const& inc = item["include"];
+                auto const& spec = inc.IsMap() ? inc : item;
+                auto name = inc.IsScalar() ? inc.as<std::string>() : spec["filename"].IsDefined() ? spec["filename"].as<std::string>() : "";
+                if(!name.length()) {
+                    SCCERR(SCMOD) << loc(item) << "include without filename";
+                    continue;
+                }
+                auto inc_vars = vars;
+                auto const& var_node = spec["variables"];
+                if(var_node.IsMap())
+                    for(auto const& v : var_node)
+                        inc_vars[v.first.as<std::string>()] = v.second.as<std::string>();
+                else if(var_node.IsSequence())
+                    for(auto const& e : var_node)
+                        for(auto const& v : e)
+                            inc_vars[v.first.as<std::string>()] = v.second.as<std::string>();
+                if(name[0] != '/')
+                    name = base_dir + name;
+                if(auto a = parse_file(name, inc_vars, res->parallel))
+                    res->children.emplace_back(std::move(a));
+            } else {
+                std::unique_ptr<action> a(new action);
+                if(item["delay"].IsDefined()) {
+                    a->type = action::DELAY;
+                    a->cycles = to_uint(item["delay"]);
+                } else if(item["post"].IsDefined()) {
+                    a->type = action::POST;
+                    a->text = item["post"].as<std::string>();
+                } else if(item["message"].IsDefined()) {
+                    a->type = action::MESSAGE;
+                    a->text = item["message"].as<std::string>();
+                } else if(item["exec_stl"].IsDefined()) {
+                    a->type = action::EXEC_STL;
+                    a->text = item["exec_stl"].as<std::string>();
+                } else if(item["wait"].IsDefined()) {
+                    a->type = action::WAIT;
+                    auto const& w = item["wait"];
+                    try {
+                        if(w["inst"].IsDefined())
+                            a->inst_re.reset(new std::regex(w["inst"].as<std::string>()));
+                        a->event_re.reset(new std::regex(w["event"].IsDefined() ? w["event"].as<std::string>() : ".*"));
+                        a->text = w["event"].IsDefined() ? w["event"].as<std::string>() : "";
+                    } catch(std::regex_error& e) {
+                        SCCERR(SCMOD) << loc(w) << "illegal regular expression: " << e.what();
+                        continue;
+                    }
+                } else {
+                    SCCERR(SCMOD) << loc(item) << "unknown key " << item.begin()->first.as<std::string>();
+                    continue;
+                }
+                res->children.emplace_back(std::move(a));
+            }
+        }
+        return res;
+    };
+    return parse_list(YAML::Load(expand_variables(ss.str(), vars)), parallel);
+}
+
+void traffic_profile_unit::run() {
+    wait(sc_core::SC_ZERO_TIME);
+    if(!root)
+        return;
+    if(clk_if)
+        wait(clk_i.posedge_event());
+    execute(*root);
+    SCCINFO(SCMOD) << "finished executing " << profile_file_name.get_value() << ", issued " << issued.get() << " transactions";
+    finished = true;
+    finished_evt.notify(sc_core::SC_ZERO_TIME);
+}
+
+void traffic_profile_unit::execute(action const& a) {
+    switch(a.type) {
+    case action::LIST:
+        if(a.parallel && a.children.size() > 1) {
+            unsigned running = a.children.size();
+            sc_core::sc_event done_evt;
+            for(auto const& c : a.children)
+                sc_core::sc_spawn([this, &c, &running, &done_evt]() {
+                    execute(*c);
+                    if(--running == 0)
+                        done_evt.notify();
+                });
+            wait(done_evt);
+        } else
+            for(auto const& c : a.children)
+                execute(*c);
+        break;
+    case action::PROFILE:
+        for(auto i = 0U; i < a.prof->loop; ++i)
+            execute_profile(*a.prof);
+        break;
+    case action::DELAY:
+        if(clk_if)
+            wait(clk_if->period() * static_cast<double>(a.cycles));
+        break;
+    case action::POST:
+        synchronizer::get().posts.emplace_back(name(), a.text);
+        synchronizer::get().posted_evt.notify(sc_core::SC_ZERO_TIME);
+        break;
+    case action::WAIT:
+        SCCDEBUG(SCMOD) << "waiting for event " << a.text;
+        while(!synchronizer::get().is_posted(a.inst_re.get(), *a.event_re))
+            wait(synchronizer::get().posted_evt);
+        break;
+    case action::MESSAGE:
+        SCCINFO(SCMOD) << a.text;
+        break;
+    case action::EXEC_STL:
+        SCCWARN(SCMOD) << "exec_stl is not supported by this TPU, skipping " << a.text;
+        break;
+    }
+}
+
+void traffic_profile_unit::execute_profile(profile const& p) {
+    SCCDEBUG(SCMOD) << "starting profile " << p.name;
+    profile_exec exec(p, seed.get_value());
+    if(p.id_type == profile::UNIQUE)
+        for(auto id = p.id_lower; id < p.id_upper; ++id)
+            exec.free_ids.push_back(id);
+    auto const clk_period = clk_if ? clk_if->period() : sc_core::SC_ZERO_TIME;
+    if(p.rate > 0 && clk_if) {
+        fifos.emplace_back(p.name, fifo_model(p.types.front()->cmd == tlm::TLM_READ_COMMAND, p.rate * clk_period.to_seconds(),
+                                              p.fifo_full, p.fifo_start_full, get_cycle()));
+        exec.fifo = &fifos.back().second;
+    }
+    while(!p.count || exec.issued < p.count) {
+        while(exec.outstanding >= p.txn_limit || (p.id_type == profile::UNIQUE && exec.free_ids.empty()))
+            wait(exec.done_evt);
+        if(exec.fifo) {
+            exec.fifo->update(get_cycle());
+            while(auto cycles = exec.fifo->wait_cycles(p.txn_size)) {
+                wait(clk_period * static_cast<double>(cycles), exec.done_evt);
+                exec.fifo->update(get_cycle());
+            }
+            exec.fifo->issue(p.txn_size);
+        }
+        unsigned id;
+        if(p.signals[AXID].size())
+            id = exec.get(p.signals[AXID]);
+        else if(p.id_type == profile::UNIQUE) {
+            id = exec.free_ids.front();
+            exec.free_ids.pop_front();
+        } else
+            id = p.id_lower + exec.issued % (p.id_upper - p.id_lower);
+        jobs.emplace_back(create_payload(exec, id), &exec, id);
+        exec.issued++;
+        exec.outstanding++;
+        issued++;
+        if(jobs.size() > idle_workers)
+            sc_core::sc_spawn([this]() { worker_thread(); }, sc_core::sc_gen_unique_name("worker"));
+        job_evt.notify();
+        if(clk_if)
+            wait(clk_i.posedge_event());
+        else
+            wait(sc_core::SC_ZERO_TIME);
+    }
+    while(exec.outstanding)
+        wait(exec.done_evt);
+    if(exec.fifo)
+        exec.fifo->finish(get_cycle());
+    SCCDEBUG(SCMOD) << "finished profile " << p.name << " after " << exec.issued << " transactions";
+}
+
+void traffic_profile_unit::worker_thread() {
+    while(true) {
+        while(jobs.empty()) {
+            idle_workers++;
+            wait(job_evt);
+            idle_workers--;
+        }
+        tlm::scc::tlm_gp_shared_ptr trans;
+        profile_exec* exec_ptr;
+        unsigned id;
+        std::tie(trans, exec_ptr, id) = jobs.front();
+        jobs.pop_front();
+        auto& exec = *exec_ptr;
+        outstanding++;
+        fw_o->transport(*trans, false);
+        outstanding--;
+        if(exec.p.id_type == profile::UNIQUE && exec.p.signals[AXID].empty())
+            exec.free_ids.push_back(id);
+        if(exec.fifo)
+            exec.fifo->complete(get_cycle(), exec.p.txn_size);
+        exec.outstanding--;
+        exec.done_evt.notify();
+    }
+}
+
+tlm::scc::tlm_gp_shared_ptr traffic_profile_unit::create_payload(profile_exec& exec, unsigned id) {
+    auto const& p = exec.p;
+    auto const& sig = p.signals;
+    auto const& type = *exec.get(p.types);
+    // determine the burst geometry
+    unsigned beat_bytes = std::min(p.txn_size, transfer_width_in_bytes);
+    unsigned size = 0;
+    while((1U << size) < beat_bytes)
+        ++size;
+    unsigned length = p.txn_size / beat_bytes - 1;
+    if(sig[AXSIZE].size())
+        size = exec.get(sig[AXSIZE]);
+    if(sig[AXLEN].size())
+        length = exec.get(sig[AXLEN]);
+    auto const len = (length + 1U) << size;
+    // determine the address
+    uint64_t addr;
+    if(sig[AXADDR].size()) {
+        addr = exec.get(sig[AXADDR]);
+    } else {
+        switch(p.addr_type) {
+        case profile::RANDOM:
+            addr = p.addr_base + (p.addr_range > len ? exec.rng() % (p.addr_range - len + 1) : 0);
+            break;
+        case profile::TWODIM:
+            if(exec.offset + len > (p.addr_xrange ? p.addr_xrange : p.addr_range)) {
+                exec.offset = 0;
+                exec.row += p.addr_stride;
+            }
+            if(exec.row + exec.offset + len > p.addr_range)
+                exec.row = 0;
+            addr = p.addr_base + exec.row + exec.offset;
+            exec.offset += len;
+            break;
+        default:
+            if(exec.offset + len > p.addr_range)
+                exec.offset = 0;
+            addr = p.addr_base + exec.offset;
+            exec.offset += len;
+            break;
+        }
+        if(p.addr_alignment >= 0) {
+            auto align = p.addr_alignment ? p.addr_alignment : transfer_width_in_bytes;
+            addr -= addr % align;
+        }
+    }
+
+    tlm::scc::tlm_gp_shared_ptr trans;
+    axi::request* req{nullptr};
+    if(type.ace) {
+        auto* gp = tlm::scc::tlm_mm<>::get().allocate<axi::ace_extension>(len);
+        auto* ext = gp->get_extension<axi::ace_extension>();
+        auto no_snoop = type.snoop == axi::snoop_e::READ_NO_SNOOP || type.snoop == axi::snoop_e::WRITE_NO_SNOOP;
+        ext->set_domain(no_snoop ? axi::domain_e::NON_SHAREABLE : axi::domain_e::INNER_SHAREABLE);
+        ext->set_snoop(type.snoop);
+        ext->set_barrier(axi::bar_e::RESPECT_BARRIER);
+        ext->set_id(id);
+        req = ext;
+        trans = gp;
+    } else {
+        auto* gp = tlm::scc::tlm_mm<>::get().allocate<axi::axi4_extension>(len);
+        auto* ext = gp->get_extension<axi::axi4_extension>();
+        ext->set_id(id);
+        req = ext;
+        trans = gp;
+    }
+    trans->set_command(type.cmd);
+    trans->set_address(addr);
+    trans->set_data_length(len);
+    trans->set_streaming_width(len);
+    req->set_length(length);
+    req->set_size(size);
+    req->set_burst(sig[AXBURST].size() ? axi::into<axi::burst_e>(exec.get(sig[AXBURST])) : axi::burst_e::INCR);
+    if(sig[AXCACHE].size())
+        req->set_cache(exec.get(sig[AXCACHE]));
+    if(sig[AXLOCK].size())
+        static_cast<axi::axi4*>(req)->set_exclusive(exec.get(sig[AXLOCK]));
+    if(sig[AXPROT].size())
+        req->set_prot(exec.get(sig[AXPROT]));
+    if(sig[AXQOS].size())
+        req->set_qos(exec.get(sig[AXQOS]));
+    if(sig[AXREGION].size())
+        req->set_region(exec.get(sig[AXREGION]));
+    if(sig[AWATOP].size() && type.cmd == tlm::TLM_WRITE_COMMAND)
+        req->set_atop(exec.get(sig[AWATOP]));
+    if(sig[AWSTASHNID].size())
+        req->set_stash_nid(exec.get(sig[AWSTASHNID]));
+    if(sig[AWSTASHLPID].size())
+        req->set_stash_lpid(exec.get(sig[AWSTASHLPID]));
+    if(type.cmd == tlm::TLM_WRITE_COMMAND) {
+        auto* data = trans->get_data_ptr();
+        if(sig[WDATA].size()) {
+            auto val = exec.get(sig[WDATA]);
+            for(unsigned i = 0; i < len; ++i)
+                data[i] = static_cast<uint8_t>(val >> (8 * (i % sizeof(val))));
+        } else {
+            for(unsigned i = 0; i < len; i += sizeof(uint64_t)) {
+                auto val = exec.rng();
+                std::memcpy(data + i, &val, std::min<size_t>(sizeof(val), len - i));
+            }
+        }
+    }
+    auto const& t = p.timing;
+    if(std::any_of(t.begin(), t.end(), [](std::vector<uint64_t> const& v) { return !v.empty(); })) {
+        auto get_timing = [&exec, &t](timing_e e, unsigned dflt) { return t[e].size() ? static_cast<unsigned>(exec.get(t[e])) : dflt; };
+        trans->set_auto_extension(
+            atp::timing_params::create(get_timing(ARTV, 1), get_timing(AWTV, 1), get_timing(WBV, 1), get_timing(RBR, 0), get_timing(BR, 0)));
+    }
+    return trans;
+}
+
+} // namespace atp
@@ -0,0 +1,102 @@
+/*
+ * Copyright 2021 Arteris IP
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#ifndef SC_INCLUDE_DYNAMIC_PROCESSES
+#define SC_INCLUDE_DYNAMIC_PROCESSES
+#endif
+
+#include <atp/fifo_model.h>
+#include <cci_configuration>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <scc/sc_variable.h>
+#include <string>
+#include <systemc>
+#include <tlm/scc/pe/intor_if.h>
+#include <tlm/scc/tlm_gp_shared.h>
+#include <tuple>
+#include <unordered_map>
+
+namespace atp {
+/**
+ * @brief a traffic profile unit (TPU) executing the profiles of a YAML profile file (YPRF)
+ *
+ * The TPU implements the file format described in doc/yaml-atp/YAML_ATP_input_spec.md. It generates AXI4 or ACE
+ * payloads and sends them via fw_o to an initiator protocol engine (e.g. axi::pe::axi_initiator_b or
+ * chi::pe::chi_rn_initiator_b which converts them to CHI). The number of outstanding transactions of a profile is
+ * limited by TxnLimit, if a Rate is given the issue of transactions is throttled by modeling the fill level of the
+ * read or write FIFO (see atp::fifo_model). Timings specified in a profile are attached to each transaction as
+ * atp::timing_params. At the end of simulation the TPU reports the requested and achieved bandwidth as well as the
+ * FIFO underrun or overrun cycles of each rate limited profile.
+ */
+class traffic_profile_unit : public sc_core::sc_module {
+public:
+    sc_core::sc_in<bool> clk_i{"clk_i"};
+
+    sc_core::sc_port<tlm::scc::pe::intor_fw_b> fw_o{"fw_o"};
+    //! the YAML profile file to execute
+    cci::cci_param<std::string> profile_file_name{"profile_file_name", ""};
+    //! the seed of the random generators used for addresses and data, each profile combines it with its name
+    cci::cci_param<unsigned> seed{"seed", 0};
+    /**
+     * @brief the constructor
+     * @param nm the module name
+     * @param transfer_width the width of the data bus in bits
+     */
+    traffic_profile_unit(sc_core::sc_module_name const& nm, unsigned transfer_width);
+
+    virtual ~traffic_profile_unit();
+    /**
+     * get the event being notified once all profiles are executed and all transactions are finished
+     *
+     * @return reference to sc_event
+     */
+    const sc_core::sc_event& finished_event() { return finished_evt; }
+
+    bool is_finished() const { return finished; }
+
+protected:
+    struct profile;
+    struct action;
+    struct profile_exec;
+    void end_of_elaboration() override;
+    void start_of_simulation() override;
+    void end_of_simulation() override;
+    uint64_t get_cycle() const;
+    std::unique_ptr<action> parse_file(std::string const& file_name, std::unordered_map<std::string, std::string> const& vars,
+                                       bool parallel);
+    void run();
+    void execute(action const& a);
+    void execute_profile(profile const& p);
+    void worker_thread();
+    tlm::scc::tlm_gp_shared_ptr create_payload(profile_exec& exec, unsigned id);
+    unsigned const transfer_width_in_bytes;
+    sc_core::sc_clock* clk_if{nullptr};
+    std::unique_ptr<action> root;
+    std::deque<std::tuple<tlm::scc::tlm_gp_shared_ptr, profile_exec*, unsigned>> jobs;
+    //! the FIFO models of all rate limited profiles executed so far
+    std::deque<std::pair<std::string, fifo_model>> fifos;
+    unsigned idle_workers{0};
+    sc_core::sc_event job_evt, finished_evt;
+    bool finished{false};
+    scc::sc_variable<unsigned> outstanding{"Outstanding", 0};
+    scc::sc_variable<uint64_t> issued{"Issued", 0};
+};
+
+} // namespace atp
@@ -19,59 +19,114 @@
 namespace axi {
 namespace checker {
 
+axi_protocol::~axi_protocol() { flush(); }
+
 void axi_protocol::fw_pre(const axi_protocol::payload_type& trans, const axi_protocol::phase_type& phase) {
+    if(!sampler.accept(trans, phase, check_kind::FW_PRE))
+        return;
     auto cmd = trans.get_command();
     if(cmd == tlm::TLM_IGNORE_COMMAND)
         SCCERR(name) << "Illegal command: tlm::TLM_IGNORE_COMMAND on forward path";
-    if(check_phase_change(trans, phase))
-#ifndef NCSC
-        SCCERR(name) << "Illegal phase transition: " << phase.get_name() << " on forward path";
-#else
-        SCCERR(name) << "Illegal phase transition: " << phase << " on forward path";
-#endif
+    // the properties are checked immediately as they need the complete payload
+    if(phase == tlm::BEGIN_REQ)
+        check_properties(trans);
+    check(trans, phase, check_kind::FW_PRE, false);
 }
 
 void axi_protocol::fw_post(const axi_protocol::payload_type& trans, const axi_protocol::phase_type& phase, tlm::tlm_sync_enum rstat) {
-    if(rstat == tlm::TLM_ACCEPTED)
+    if(rstat == tlm::TLM_ACCEPTED || !sampler.accept(trans, phase, check_kind::FW_POST))
         return;
-    auto cmd = trans.get_command();
-    if(req_beat[cmd] == tlm::BEGIN_REQ && (phase == tlm::BEGIN_RESP || phase == axi::BEGIN_PARTIAL_RESP))
-        req_beat[cmd] = tlm::UNINITIALIZED_PHASE;
-    if(check_phase_change(trans, phase))
-#ifndef NCSC
-        SCCERR(name) << "Illegal phase transition: " << phase.get_name() << " on return in forward path";
-#else
-        SCCERR(name) << "Illegal phase transition: " << phase << " on return in forward path";
-#endif
+    check(trans, phase, check_kind::FW_POST, rstat == tlm::TLM_COMPLETED);
 }
 
 void axi_protocol::bw_pre(const axi_protocol::payload_type& trans, const axi_protocol::phase_type& phase) {
+    if(!sampler.accept(trans, phase, check_kind::BW_PRE))
+        return;
     auto cmd = trans.get_command();
     if(cmd == tlm::TLM_IGNORE_COMMAND)
         SCCERR(name) << "Illegal command:  tlm::TLM_IGNORE_COMMAND on forward path";
-    if(check_phase_change(trans, phase))
-#ifndef NCSC
-        SCCERR(name) << "Illegal phase transition: " << phase.get_name() << " on backward path";
-#else
-        SCCERR(name) << "Illegal phase transition: " << phase << " on backward path";
-#endif
+    check(trans, phase, check_kind::BW_PRE, false);
 }
 
 void axi_protocol::bw_post(const axi_protocol::payload_type& trans, const axi_protocol::phase_type& phase, tlm::tlm_sync_enum rstat) {
-    if(rstat == tlm::TLM_ACCEPTED)
+    if(rstat == tlm::TLM_ACCEPTED || !sampler.accept(trans, phase, check_kind::BW_POST))
         return;
-    if(check_phase_change(trans, phase))
+    check(trans, phase, check_kind::BW_POST, rstat == tlm::TLM_COMPLETED);
+}
+
+void axi_protocol::flush() {
+    for(auto& e : events)
+        process(e);
+    events.clear();
+}
+
+void axi_protocol::check(payload_type const& trans, phase_type const& phase, check_kind kind, bool completed) {
+    check_event e{reinterpret_cast<uintptr_t>(&trans), phase, axi::get_axi_id(trans), axi::get_burst_length(trans), trans.get_command(),
+                  kind, sc_core::sc_time_stamp()};
+    if(batch_size) {
+        events.push_back(e);
+        if(events.size() >= batch_size)
+            flush();
+    } else
+        process(e);
+    if(watchdog.is_active()) {
+        if((phase == tlm::BEGIN_REQ || phase == axi::BEGIN_PARTIAL_REQ) && kind == check_kind::FW_PRE)
+            watchdog.arm(e.tx, e.id,
+                         e.cmd == tlm::TLM_WRITE_COMMAND ? response_watchdog::tx_kind::WRITE : response_watchdog::tx_kind::READ);
+        else if(completed || phase == tlm::BEGIN_RESP || phase == axi::BEGIN_PARTIAL_RESP)
+            watchdog.disarm(e.tx);
+    }
+    if(completed || phase == tlm::END_RESP)
+        sampler.finish(e.tx);
+}
+
+void axi_protocol::process(check_event const& e) {
+    auto const& phase = e.phase;
+    switch(e.kind) {
+    case check_kind::FW_PRE:
+        if(check_phase_change(e))
+#ifndef NCSC
+            SCCERR(name) << "Illegal phase transition: " << phase.get_name() << " on forward path" << event_time{e.time};
+#else
+            SCCERR(name) << "Illegal phase transition: " << phase << " on forward path" << event_time{e.time};
+#endif
+        break;
+    case check_kind::FW_POST:
+        if(req_beat[e.cmd] == tlm::BEGIN_REQ && (phase == tlm::BEGIN_RESP || phase == axi::BEGIN_PARTIAL_RESP))
+            req_beat[e.cmd] = tlm::UNINITIALIZED_PHASE;
+        if(check_phase_change(e))
+#ifndef NCSC
+            SCCERR(name) << "Illegal phase transition: " << phase.get_name() << " on return in forward path"
+                         << event_time{e.time};
+#else
+            SCCERR(name) << "Illegal phase transition: " << phase << " on return in forward path" << event_time{e.time};
+#endif
+        break;
+    case check_kind::BW_PRE:
+        if(check_phase_change(e))
+#ifndef NCSC
+            SCCERR(name) << "Illegal phase transition: " << phase.get_name() << " on backward path" << event_time{e.time};
+#else
+            SCCERR(name) << "Illegal phase transition: " << phase << " on backward path" << event_time{e.time};
+#endif
+        break;
+    case check_kind::BW_POST:
+        if(check_phase_change(e))
 #ifndef NCSC
-        SCCERR(name) << "Illegal phase transition: " << phase.get_name() << " on return in backward path";
+            SCCERR(name) << "Illegal phase transition: " << phase.get_name() << " on return in backward path"
+                         << event_time{e.time};
 #else
-        SCCERR(name) << "Illegal phase transition: " << phase << " on return in backward path";
+            SCCERR(name) << "Illegal phase transition: " << phase << " on return in backward path" << event_time{e.time};
 #endif
+        break;
+    }
 }
 
-bool axi_protocol::check_phase_change(payload_type const& trans, const axi_protocol::phase_type& phase) {
+bool axi_protocol::check_phase_change(check_event const& e) {
+    auto const& phase = e.phase;
     // phase tests
-    auto cur_req = req_beat[trans.get_command()];
-    auto cur_resp = resp_beat[trans.get_command()];
+    auto cur_req = req_beat[e.cmd];
+    auto cur_resp = resp_beat[e.cmd];
     bool error{false};
     if(phase == tlm::BEGIN_REQ || phase == axi::BEGIN_PARTIAL_REQ) {
         error |= cur_req != tlm::UNINITIALIZED_PHASE;
@@ -94,21 +149,21 @@ bool axi_protocol::check_phase_change(payload_type const& trans, const axi_proto
     } else {
         error |= true;
     }
-    if(req_beat[trans.get_command()] != cur_req) {
-        req_beat[trans.get_command()] = cur_req;
-        request_update(trans);
+    if(req_beat[e.cmd] != cur_req) {
+        req_beat[e.cmd] = cur_req;
+        request_update(e);
     }
-    if(resp_beat[trans.get_command()] != cur_resp) {
-        resp_beat[trans.get_command()] = cur_resp;
-        response_update(trans);
+    if(resp_beat[e.cmd] != cur_resp) {
+        resp_beat[e.cmd] = cur_resp;
+        response_update(e);
     }
     return error;
 }
 
-void axi_protocol::request_update(const payload_type& trans) {
-    auto axi_id = axi::get_axi_id(trans);
-    auto axi_burst_len = axi::get_burst_length(trans);
-    if(trans.is_write()) {
+void axi_protocol::request_update(check_event const& e) {
+    auto axi_id = e.id;
+    auto axi_burst_len = e.burst_len;
+    if(e.cmd == tlm::TLM_WRITE_COMMAND) {
         if(req_beat[tlm::TLM_WRITE_COMMAND] == tlm::UNINITIALIZED_PHASE) {
             req_id[tlm::TLM_WRITE_COMMAND] = umax;
         } else {
@@ -117,73 +172,77 @@ void axi_protocol::request_update(const payload_type& trans) {
                 wr_req_beat_count++;
             } else if(req_id[tlm::TLM_WRITE_COMMAND] != axi_id) {
                 SCCERR(name) << "Illegal ordering: a transaction with AWID:0x" << std::hex << axi_id
-                             << " starts while a transaction with AWID:0x" << req_id[tlm::TLM_WRITE_COMMAND] << " is active";
+                             << " starts while a transaction with AWID:0x" << req_id[tlm::TLM_WRITE_COMMAND] << " is active"
+                             << event_time{e.time};
             }
             if(req_beat[tlm::TLM_WRITE_COMMAND] == tlm::BEGIN_REQ) {
                 if(wr_req_beat_count != axi_burst_len) {
                     SCCERR(name) << "Illegal AXI settings: number of transferred beats (" << wr_req_beat_count
-                                 << ") does not comply with AWLEN:0x" << std::hex << axi::get_burst_length(trans) - 1;
+                                 << ") does not comply with AWLEN:0x" << std::hex << e.burst_len - 1 << event_time{e.time};
                 }
                 wr_req_beat_count = 0;
-                open_tx_by_id[tlm::TLM_WRITE_COMMAND][axi_id].push_back(reinterpret_cast<uintptr_t>(&trans));
-                check_properties(trans);
+                open_tx_by_id[tlm::TLM_WRITE_COMMAND][axi_id].push_back(e.tx);
             }
         }
-    } else if(trans.is_read()) {
+    } else if(e.cmd == tlm::TLM_READ_COMMAND) {
         if(req_beat[tlm::TLM_READ_COMMAND] == tlm::UNINITIALIZED_PHASE) {
             req_id[tlm::TLM_READ_COMMAND] = umax;
         } else if(req_beat[tlm::TLM_READ_COMMAND] == tlm::BEGIN_REQ) {
             if(req_id[tlm::TLM_READ_COMMAND] == umax) {
                 req_id[tlm::TLM_READ_COMMAND] = axi_id;
-                open_tx_by_id[tlm::TLM_READ_COMMAND][axi_id].push_back(reinterpret_cast<uintptr_t>(&trans));
+                open_tx_by_id[tlm::TLM_READ_COMMAND][axi_id].push_back(e.tx);
             } else if(req_id[tlm::TLM_READ_COMMAND] != axi_id) {
-                SCCERR(name) << "Illegal phase: a read transaction uses a phase with id " << req_beat[tlm::TLM_READ_COMMAND];
+                SCCERR(name) << "Illegal phase: a read transaction uses a phase with id " << req_beat[tlm::TLM_READ_COMMAND]
+                             << event_time{e.time};
             }
-            check_properties(trans);
         } else {
-            SCCERR(name) << "Illegal phase: a read transaction uses a phase with id " << req_beat[tlm::TLM_READ_COMMAND];
+            SCCERR(name) << "Illegal phase: a read transaction uses a phase with id " << req_beat[tlm::TLM_READ_COMMAND]
+                         << event_time{e.time};
         }
     }
 }
 
-void axi_protocol::response_update(const payload_type& trans) {
-    auto axi_id = axi::get_axi_id(trans);
-    auto axi_burst_len = axi::get_burst_length(trans);
-    if(trans.is_write()) {
+void axi_protocol::response_update(check_event const& e) {
+    auto axi_id = e.id;
+    auto axi_burst_len = e.burst_len;
+    if(e.cmd == tlm::TLM_WRITE_COMMAND) {
         if(resp_beat[tlm::TLM_WRITE_COMMAND] == tlm::UNINITIALIZED_PHASE) {
             resp_id[tlm::TLM_WRITE_COMMAND] = umax;
         } else if(resp_beat[tlm::TLM_WRITE_COMMAND] == tlm::BEGIN_RESP) {
             if(resp_id[tlm::TLM_WRITE_COMMAND] == umax) {
                 resp_id[tlm::TLM_WRITE_COMMAND] = axi_id;
-                if(open_tx_by_id[tlm::TLM_WRITE_COMMAND][axi_id].front() != reinterpret_cast<uintptr_t>(&trans)) {
+                if(open_tx_by_id[tlm::TLM_WRITE_COMMAND][axi_id].front() != e.tx) {
                     SCCERR(name) << "Write response ordering violation: a response with AWID:0x" << std::hex << axi_id
-                                 << " starts before the previous response with the same id finished";
+                                 << " starts before the previous response with the same id finished" << event_time{e.time};
                 }
             } else if(resp_id[tlm::TLM_WRITE_COMMAND] != axi_id) {
-                SCCERR(name) << "Illegal phase: a read transaction uses a phase with id " << resp_beat[tlm::TLM_WRITE_COMMAND];
+                SCCERR(name) << "Illegal phase: a read transaction uses a phase with id " << resp_beat[tlm::TLM_WRITE_COMMAND]
+                             << event_time{e.time};
             }
             open_tx_by_id[tlm::TLM_WRITE_COMMAND][axi_id].pop_front();
         } else {
-            SCCERR(name) << "Illegal phase: a read transaction uses a phase with id " << resp_beat[tlm::TLM_WRITE_COMMAND];
+            SCCERR(name) << "Illegal phase: a read transaction uses a phase with id " << resp_beat[tlm::TLM_WRITE_COMMAND]
+                         << event_time{e.time};
         }
-    } else if(trans.is_read()) {
+    } else if(e.cmd == tlm::TLM_READ_COMMAND) {
         if(resp_beat[tlm::TLM_READ_COMMAND] == tlm::UNINITIALIZED_PHASE) {
             resp_id[tlm::TLM_READ_COMMAND] = umax;
         } else {
             if(resp_id[tlm::TLM_READ_COMMAND] == umax) {
                 resp_id[tlm::TLM_READ_COMMAND] = axi_id;
-                if(open_tx_by_id[tlm::TLM_READ_COMMAND][axi_id].front() != reinterpret_cast<uintptr_t>(&trans)) {
+                if(open_tx_by_id[tlm::TLM_READ_COMMAND][axi_id].front() != e.tx) {
                     SCCERR(name) << "Read response ordering violation: a response with ARID:0x" << std::hex << axi_id
-                                 << " starts before the previous response with the same id finished";
+                                 << " starts before the previous response with the same id finished" << event_time{e.time};
                 }
                 rd_resp_beat_count[axi_id]++;
             } else if(resp_id[tlm::TLM_READ_COMMAND] != axi_id) {
-                SCCERR(name) << "Illegal phase: a read transaction uses a phase with id " << resp_beat[tlm::TLM_READ_COMMAND];
+                SCCERR(name) << "Illegal phase: a read transaction uses a phase with id " << resp_beat[tlm::TLM_READ_COMMAND]
+                             << event_time{e.time};
             }
             if(resp_beat[tlm::TLM_READ_COMMAND] == tlm::BEGIN_RESP) {
                 if(rd_resp_beat_count[axi_id] != axi_burst_len) {
                     SCCERR(name) << "Illegal AXI settings: number of transferred beats (" << wr_req_beat_count
-                                 << ") does not comply with AWLEN:0x" << std::hex << axi::get_burst_length(trans) - 1;
+                                 << ") does not comply with AWLEN:0x" << std::hex << e.burst_len - 1 << event_time{e.time};
                 }
                 open_tx_by_id[tlm::TLM_READ_COMMAND][axi_id].pop_front();
                 rd_resp_beat_count[axi_id] = 0;
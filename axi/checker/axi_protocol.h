@@ -17,12 +17,15 @@
 #ifndef _AXI_CHECKER_AXI_PROTOCOL_H_
 #define _AXI_CHECKER_AXI_PROTOCOL_H_
 
+#include "check_event.h"
 #include "checker_if.h"
+#include "response_watchdog.h"
 #include <array>
 #include <axi/axi_tlm.h>
 #include <deque>
 #include <tlm/scc/tlm_gp_shared.h>
 #include <unordered_map>
+#include <vector>
 
 namespace axi {
 namespace checker {
@@ -33,12 +36,30 @@ class axi_protocol : public checker_if<axi::axi_protocol_types> {
     constexpr static unsigned umax = std::numeric_limits<unsigned>::max();
 
 public:
-    axi_protocol(std::string const& name, unsigned bus_width_in_bytes, unsigned rd_response_timeout, unsigned wr_response_timeout)
+    /**
+     * @brief the constructor of the checker
+     *
+     * @param name the name used in the reports
+     * @param bus_width_in_bytes the width of the data bus
+     * @param rd_response_timeout the time in ns a read or snoop may wait for its response, 0 disables the check
+     * @param wr_response_timeout the time in ns a write may wait for its response, 0 disables the check
+     * @param sample_rate only every n-th transaction is checked, 0 or 1 checks all transactions
+     * @param batch_size the number of phases which are collected before they are checked in a batch, 0 checks each
+     * phase immediately
+     */
+    axi_protocol(std::string const& name, unsigned bus_width_in_bytes, unsigned rd_response_timeout, unsigned wr_response_timeout,
+                 unsigned sample_rate = 1, unsigned batch_size = 0)
     : name(name)
     , bw(bus_width_in_bytes)
     , rd_response_timeout(rd_response_timeout)
-    , wr_response_timeout(wr_response_timeout) {}
-    virtual ~axi_protocol() = default;
+    , wr_response_timeout(wr_response_timeout)
+    , batch_size(batch_size)
+    , sampler(sample_rate)
+    , watchdog(name, sc_core::sc_time(rd_response_timeout, sc_core::SC_NS),
+               sc_core::sc_time(wr_response_timeout, sc_core::SC_NS)) {
+        events.reserve(batch_size);
+    }
+    virtual ~axi_protocol();
     axi_protocol(const axi_protocol& other) = delete;
     axi_protocol(axi_protocol&& other) = delete;
     axi_protocol& operator=(const axi_protocol& other) = delete;
@@ -47,12 +68,19 @@ public:
     void fw_post(payload_type const& trans, phase_type const& phase, tlm::tlm_sync_enum rstat) override;
     void bw_pre(payload_type const& trans, phase_type const& phase) override;
     void bw_post(payload_type const& trans, phase_type const& phase, tlm::tlm_sync_enum rstat) override;
+    //! checks the phases collected so far, called automatically when a batch is full, at the end of the simulation
+    //! and on destruction
+    void flush() override;
     std::string const name;
     unsigned const bw;
     unsigned const rd_response_timeout;
     unsigned const wr_response_timeout;
+    unsigned const batch_size;
 
 private:
+    tx_sampler sampler;
+    response_watchdog watchdog;
+    std::vector<check_event> events;
     std::array<phase_type, 3> req_beat;
     std::array<phase_type, 3> resp_beat;
     phase_type dataless_req;
@@ -62,9 +90,11 @@ private:
     std::array<std::unordered_map<unsigned, std::deque<uintptr_t>>, 3> open_tx_by_id;
     std::unordered_map<unsigned, std::deque<uintptr_t>> resp_by_id;
     std::unordered_map<unsigned, unsigned> rd_resp_beat_count;
-    bool check_phase_change(payload_type const& trans, const phase_type& phase);
-    void request_update(payload_type const& trans);
-    void response_update(payload_type const& trans);
+    void check(payload_type const& trans, phase_type const& phase, check_kind kind, bool completed);
+    void process(check_event const& e);
+    bool check_phase_change(check_event const& e);
+    void request_update(check_event const& e);
+    void response_update(check_event const& e);
     void check_properties(payload_type const& trans);
     void check_datawith_settings(payload_type const& trans);
 };
@@ -0,0 +1,116 @@
+/*
+ * Copyright 2023 Arteris IP
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _AXI_CHECKER_CHECK_EVENT_H_
+#define _AXI_CHECKER_CHECK_EVENT_H_
+
+#include <axi/axi_tlm.h>
+#include <cstdint>
+#include <unordered_set>
+
+namespace axi {
+namespace checker {
+//! the checker call a phase was observed in
+enum class check_kind : uint8_t { FW_PRE, FW_POST, BW_PRE, BW_POST };
+/**
+ * @brief the compact record of a checked phase
+ *
+ * It holds everything the phase and ordering checks need so that they can be run after the payload has been changed or
+ * reused.
+ */
+struct check_event {
+    uintptr_t tx;
+    tlm::tlm_phase phase;
+    unsigned id;
+    unsigned burst_len;
+    tlm::tlm_command cmd;
+    check_kind kind;
+    //! the simulation time the phase was observed at
+    sc_core::sc_time time;
+};
+//! appends the time a phase was observed at to a report if it is checked later e.g. in a batch
+struct event_time {
+    sc_core::sc_time const& time;
+};
+inline std::ostream& operator<<(std::ostream& os, event_time const& t) {
+    if(t.time != sc_core::sc_time_stamp())
+        os << " (observed at " << t.time << ")";
+    return os;
+}
+/**
+ * @brief selects every n-th transaction for checking
+ *
+ * The decision is taken at the first request phase of a transaction, i.e. on the forward path or for ACE snoops on the
+ * backward path, and kept for all its phases until the transaction is finished. Requests and snoops share the count.
+ */
+class tx_sampler {
+public:
+    /**
+     * @param rate the sampling rate, 0 or 1 selects all transactions
+     */
+    explicit tx_sampler(unsigned rate)
+    : rate(rate) {}
+    /**
+     * @brief checks if a phase belongs to a selected transaction
+     *
+     * @param trans the payload of the transaction
+     * @param phase the phase
+     * @param kind the checker call the phase is observed in
+     * @return true if the phase needs to be checked
+     */
+    inline bool accept(tlm::tlm_generic_payload const& trans, tlm::tlm_phase const& phase, check_kind kind) {
+        if(rate < 2)
+            return true;
+        auto tx = reinterpret_cast<uintptr_t>(&trans);
+        if(sampled.count(tx))
+            return true;
+        if(kind != check_kind::FW_PRE && kind != check_kind::BW_PRE)
+            return false;
+        if(phase != tlm::BEGIN_REQ && phase != axi::BEGIN_PARTIAL_REQ)
+            return false;
+        // the write beats of a transaction are not interleaved with other transactions
+        if(tx == skipped_write) {
+            if(phase == tlm::BEGIN_REQ)
+                skipped_write = 0;
+            return false;
+        }
+        if(count++ % rate) {
+            if(phase == axi::BEGIN_PARTIAL_REQ)
+                skipped_write = tx;
+            return false;
+        }
+        sampled.insert(tx);
+        return true;
+    }
+    /**
+     * @brief releases the decision of a finished transaction
+     *
+     * @param tx the identity of the transaction
+     */
+    inline void finish(uintptr_t tx) {
+        if(rate > 1)
+            sampled.erase(tx);
+    }
+
+private:
+    unsigned const rate;
+    uint64_t count{0};
+    uintptr_t skipped_write{0};
+    std::unordered_set<uintptr_t> sampled;
+};
+} // namespace checker
+} // namespace axi
+#endif /* _AXI_CHECKER_CHECK_EVENT_H_ */
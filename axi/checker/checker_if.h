@@ -27,6 +27,8 @@ template <typename TYPES> struct checker_if {
     virtual void bw_pre(typename TYPES::tlm_payload_type const& trans, typename TYPES::tlm_phase_type const& phase) = 0;
     virtual void bw_post(typename TYPES::tlm_payload_type const& trans, typename TYPES::tlm_phase_type const& phase,
                          tlm::tlm_sync_enum rstat) = 0;
+    //! checks the phases a checker has collected but not yet checked, called at the end of the simulation
+    virtual void flush() {}
     virtual ~checker_if() = default;
 };
 } // namespace checker
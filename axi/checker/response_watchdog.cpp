@@ -0,0 +1,123 @@
+/*
+ * Copyright 2023 Arteris IP
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SC_INCLUDE_DYNAMIC_PROCESSES
+#define SC_INCLUDE_DYNAMIC_PROCESSES
+#endif
+#include <algorithm>
+#include <axi/checker/response_watchdog.h>
+#include <scc/report.h>
+
+namespace axi {
+namespace checker {
+
+response_watchdog::response_watchdog(std::string const& name, sc_core::sc_time const& rd_timeout, sc_core::sc_time const& wr_timeout)
+: name(name)
+, timeouts{{rd_timeout.value(), wr_timeout.value(), rd_timeout.value()}} {
+    uint64_t shortest = 0;
+    for(auto t : timeouts)
+        if(t && (!shortest || t < shortest))
+            shortest = t;
+    if(!shortest)
+        return;
+    tick = std::max<uint64_t>(1, shortest / 16);
+    current_tick = sc_core::sc_time_stamp().value() / tick;
+    sc_core::sc_spawn_options opts;
+    opts.spawn_method();
+    proc = sc_core::sc_spawn([this]() { run(); }, sc_core::sc_gen_unique_name("response_watchdog"), &opts);
+}
+
+response_watchdog::~response_watchdog() {
+    if(proc.valid() && !proc.terminated() && sc_core::sc_is_running())
+        proc.kill();
+}
+
+void response_watchdog::arm(uintptr_t tx, unsigned id, tx_kind kind) {
+    auto timeout = timeouts[static_cast<unsigned>(kind)];
+    if(!timeout)
+        return;
+    auto now = sc_core::sc_time_stamp().value();
+    advance(now);
+    auto res = watched.emplace(tx, watched_tx{now, now + timeout, next_seq, id, kind});
+    if(!res.second)
+        return;
+    wheel[((now + timeout) / tick) % SLOTS].push_back({tx, next_seq++});
+    if(idle) {
+        idle = false;
+        wakeup.notify(until_next_tick(now));
+    }
+}
+
+void response_watchdog::disarm(uintptr_t tx) { watched.erase(tx); }
+
+void response_watchdog::run() {
+    auto now = sc_core::sc_time_stamp().value();
+    advance(now);
+    // the dynamic sensitivity keeps the process from waking up while no transaction is outstanding
+    if(watched.empty()) {
+        idle = true;
+        sc_core::next_trigger(wakeup);
+    } else
+        sc_core::next_trigger(until_next_tick(now));
+}
+
+void response_watchdog::advance(uint64_t now) {
+    // a tick is checked once it is complete so that all deadlines falling into it have passed
+    auto target = now / tick;
+    if(target <= current_tick)
+        return;
+    auto count = std::min<uint64_t>(target - current_tick, SLOTS);
+    for(uint64_t i = 0; i < count; ++i)
+        expire(wheel[(current_tick + i) % SLOTS], now);
+    current_tick = target;
+}
+
+void response_watchdog::expire(std::vector<slot_entry>& slot, uint64_t now) {
+    size_t kept = 0;
+    for(size_t i = 0; i < slot.size(); ++i) {
+        auto it = watched.find(slot[i].tx);
+        // entries of disarmed transactions are dropped lazily
+        if(it == watched.end() || it->second.seq != slot[i].seq)
+            continue;
+        if(it->second.deadline > now) {
+            slot[kept++] = slot[i];
+            continue;
+        }
+        report(it->second, now);
+        watched.erase(it);
+    }
+    slot.resize(kept);
+}
+
+void response_watchdog::report(watched_tx const& w, uint64_t now) {
+    auto start = sc_core::sc_time::from_value(w.start);
+    auto age = sc_core::sc_time::from_value(now - w.start);
+    switch(w.kind) {
+    case tx_kind::READ:
+        SCCERR(name) << "Response timeout: the read with ARID:0x" << std::hex << w.id << std::dec << " started at " << start
+                     << " has not received a response after " << age;
+        break;
+    case tx_kind::WRITE:
+        SCCERR(name) << "Response timeout: the write with AWID:0x" << std::hex << w.id << std::dec << " started at " << start
+                     << " has not received a response after " << age;
+        break;
+    case tx_kind::SNOOP:
+        SCCERR(name) << "Response timeout: the snoop started at " << start << " has not received a response after " << age;
+        break;
+    }
+}
+} // namespace checker
+} // namespace axi
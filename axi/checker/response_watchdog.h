@@ -0,0 +1,109 @@
+/*
+ * Copyright 2023 Arteris IP
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _AXI_CHECKER_RESPONSE_WATCHDOG_H_
+#define _AXI_CHECKER_RESPONSE_WATCHDOG_H_
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <systemc>
+#include <unordered_map>
+#include <vector>
+
+namespace axi {
+namespace checker {
+/**
+ * @brief reports transactions which do not receive a response within a timeout
+ *
+ * The outstanding transactions are kept in a hashed timing wheel. Its slots are checked when a transaction is armed
+ * and by a single method process which is triggered once per tick of the wheel as long as transactions are outstanding
+ * and sleeps otherwise. A timed out transaction is reported once with its ID and age. Timeouts are detected with the
+ * accuracy of a tick which is 1/16 of the shortest timeout.
+ */
+class response_watchdog {
+public:
+    enum class tx_kind : uint8_t { READ, WRITE, SNOOP };
+    /**
+     * @brief the constructor of the watchdog, the method process is only spawned if a timeout is set
+     *
+     * @param name the name used in the reports
+     * @param rd_timeout the response timeout of reads and snoops, SC_ZERO_TIME disables the watchdog for them
+     * @param wr_timeout the response timeout of writes, SC_ZERO_TIME disables the watchdog for them
+     */
+    response_watchdog(std::string const& name, sc_core::sc_time const& rd_timeout, sc_core::sc_time const& wr_timeout);
+
+    ~response_watchdog();
+
+    response_watchdog(const response_watchdog& other) = delete;
+    response_watchdog(response_watchdog&& other) = delete;
+    response_watchdog& operator=(const response_watchdog& other) = delete;
+    response_watchdog& operator=(response_watchdog&& other) = delete;
+    //! \return true if at least one timeout is set
+    inline bool is_active() const { return tick != 0; }
+    /**
+     * @brief starts watching a transaction, does nothing if the transaction is already watched
+     *
+     * @param tx the identity of the transaction
+     * @param id the AXI ID of the transaction
+     * @param kind the kind of the transaction selecting the timeout
+     */
+    void arm(uintptr_t tx, unsigned id, tx_kind kind);
+    /**
+     * @brief stops watching a transaction as its response has been seen
+     *
+     * @param tx the identity of the transaction
+     */
+    void disarm(uintptr_t tx);
+
+private:
+    static constexpr unsigned SLOTS = 64;
+    struct watched_tx {
+        uint64_t start;
+        uint64_t deadline;
+        uint64_t seq;
+        unsigned id;
+        tx_kind kind;
+    };
+    struct slot_entry {
+        uintptr_t tx;
+        uint64_t seq;
+    };
+    void run();
+    void advance(uint64_t now);
+    void expire(std::vector<slot_entry>& slot, uint64_t now);
+    void report(watched_tx const& w, uint64_t now);
+    //! the time until the current tick is complete
+    inline sc_core::sc_time until_next_tick(uint64_t now) const {
+        return sc_core::sc_time::from_value((current_tick + 1) * tick - now);
+    }
+    std::string const name;
+    std::array<uint64_t, 3> timeouts;
+    //! the duration of a tick of the wheel in units of the time resolution
+    uint64_t tick{0};
+    //! the next tick to be checked
+    uint64_t current_tick{0};
+    uint64_t next_seq{0};
+    std::array<std::vector<slot_entry>, SLOTS> wheel;
+    std::unordered_map<uintptr_t, watched_tx> watched;
+    sc_core::sc_event wakeup;
+    sc_core::sc_process_handle proc;
+    //! the method process waits for the wakeup event as no transaction is outstanding
+    bool idle{false};
+};
+} // namespace checker
+} // namespace axi
+#endif /* _AXI_CHECKER_RESPONSE_WATCHDOG_H_ */
@@ -0,0 +1,103 @@
+/*
+ * Copyright 2023 Arteris IP
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "interned_attributes.h"
+#include <algorithm>
+#include <tlm>
+#include <vector>
+
+namespace axi {
+/**
+ * @brief the compact list of the extension recorders a recorder calls for each recorded phase
+ *
+ * The list is built once from the slots of an extension recording registry which are indexed by the id of the recorded
+ * extension. Empty slots are dropped. Optionally the list learns during a warm-up which extensions are present in the
+ * payloads at all and drops the recorders of the extensions never seen afterwards. The list also carries the interning
+ * setting of its recorder to the shared extension recorders.
+ */
+template <typename RECORDER> class extension_recorder_list {
+public:
+    /**
+     * @brief builds the list from the slots of a registry
+     *
+     * @param registry the slots of the registry indexed by the extension id
+     * @param warm_up the number of recorded phases after which the recorders of the extensions not seen are dropped, 0
+     * keeps all recorders
+     */
+    template <typename SLOTS> void init(SLOTS const& registry, unsigned warm_up) {
+        entries.clear();
+        unsigned id = 0;
+        for(auto& rec : registry) {
+            if(rec)
+                entries.push_back({rec, id, false});
+            ++id;
+        }
+        remaining = warm_up;
+        initialized = true;
+    }
+    //! \return true if the list has been built
+    inline bool is_initialized() const { return initialized; }
+    //! set if the extension recorders shall record enumerations as integer ids
+    inline void set_interned(bool v) { interned = v; }
+    /**
+     * @brief calls the begin recording of all active extension recorders
+     *
+     * @param h the handle of the transaction
+     * @param trans the payload of the transaction
+     * @param count false if the phase has already been counted for the warm-up, e.g. when recording the timed view of
+     * a transaction
+     */
+    template <typename HANDLE, typename PAYLOAD> inline void record_begin(HANDLE& h, PAYLOAD& trans, bool count = true) {
+        if(remaining && count)
+            learn(trans);
+        interning_active() = interned;
+        for(auto& e : entries)
+            e.rec->recordBeginTx(h, trans);
+    }
+    /**
+     * @brief calls the end recording of all active extension recorders
+     *
+     * @param h the handle of the transaction
+     * @param trans the payload of the transaction
+     */
+    template <typename HANDLE, typename PAYLOAD> inline void record_end(HANDLE& h, PAYLOAD& trans) {
+        interning_active() = interned;
+        for(auto& e : entries)
+            e.rec->recordEndTx(h, trans);
+    }
+
+private:
+    struct entry {
+        RECORDER* rec;
+        unsigned id;
+        bool seen;
+    };
+    void learn(tlm::tlm_generic_payload const& trans) {
+        for(auto& e : entries)
+            if(!e.seen && trans.get_extension(e.id))
+                e.seen = true;
+        if(--remaining == 0)
+            entries.erase(std::remove_if(std::begin(entries), std::end(entries), [](entry const& e) { return !e.seen; }),
+                          std::end(entries));
+    }
+    std::vector<entry> entries;
+    unsigned remaining{0};
+    bool initialized{false};
+    bool interned{false};
+};
+} // namespace axi
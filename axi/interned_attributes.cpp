@@ -0,0 +1,97 @@
+/*
+ * Copyright 2023 Arteris IP
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "interned_attributes.h"
+#include "axi_tlm.h"
+#include <sstream>
+#include <unordered_map>
+
+namespace axi {
+namespace {
+template <typename E> std::vector<dictionary_entry> enum_entries(unsigned count) {
+    std::vector<dictionary_entry> ret;
+    for(auto i = 0U; i < count; ++i)
+        ret.push_back({static_cast<int>(i), to_char(static_cast<E>(i))});
+    return ret;
+}
+
+std::vector<enum_dictionary> create_dictionary(bool with_tlm_enums) {
+    std::vector<enum_dictionary> ret;
+    ret.emplace_back("burst", enum_entries<burst_e>(3));
+    ret.emplace_back("resp", enum_entries<resp_e>(4));
+    ret.emplace_back("domain", enum_entries<domain_e>(4));
+    ret.emplace_back("barrier", enum_entries<bar_e>(4));
+    std::vector<dictionary_entry> snoops;
+    for(auto i = 0U; i < 0x80; ++i) {
+        std::string name = to_char(static_cast<snoop_e>(i));
+        if(name != "reserved")
+            snoops.push_back({static_cast<int>(i), name});
+    }
+    ret.emplace_back("snoop", std::move(snoops));
+    if(!with_tlm_enums)
+        return ret;
+    std::vector<dictionary_entry> phases;
+    for(auto& p : {tlm::tlm_phase(tlm::UNINITIALIZED_PHASE), tlm::tlm_phase(tlm::BEGIN_REQ), tlm::tlm_phase(tlm::END_REQ),
+                   tlm::tlm_phase(tlm::BEGIN_RESP), tlm::tlm_phase(tlm::END_RESP), tlm::tlm_phase(axi::BEGIN_PARTIAL_REQ),
+                   tlm::tlm_phase(axi::END_PARTIAL_REQ), tlm::tlm_phase(axi::BEGIN_PARTIAL_RESP), tlm::tlm_phase(axi::END_PARTIAL_RESP),
+                   tlm::tlm_phase(axi::ACK)})
+        phases.push_back({static_cast<int>(static_cast<unsigned>(p)), phase_name(p)});
+    ret.emplace_back("tlm_phase", std::move(phases));
+    ret.emplace_back("tlm_command", std::vector<dictionary_entry>{{tlm::TLM_READ_COMMAND, "tlm::TLM_READ_COMMAND"},
+                                                                  {tlm::TLM_WRITE_COMMAND, "tlm::TLM_WRITE_COMMAND"},
+                                                                  {tlm::TLM_IGNORE_COMMAND, "tlm::TLM_IGNORE_COMMAND"}});
+    ret.emplace_back("tlm_response_status",
+                     std::vector<dictionary_entry>{{tlm::TLM_OK_RESPONSE, "tlm::TLM_OK_RESPONSE"},
+                                                   {tlm::TLM_INCOMPLETE_RESPONSE, "tlm::TLM_INCOMPLETE_RESPONSE"},
+                                                   {tlm::TLM_GENERIC_ERROR_RESPONSE, "tlm::TLM_GENERIC_ERROR_RESPONSE"},
+                                                   {tlm::TLM_ADDRESS_ERROR_RESPONSE, "tlm::TLM_ADDRESS_ERROR_RESPONSE"},
+                                                   {tlm::TLM_COMMAND_ERROR_RESPONSE, "tlm::TLM_COMMAND_ERROR_RESPONSE"},
+                                                   {tlm::TLM_BURST_ERROR_RESPONSE, "tlm::TLM_BURST_ERROR_RESPONSE"},
+                                                   {tlm::TLM_BYTE_ENABLE_ERROR_RESPONSE, "tlm::TLM_BYTE_ENABLE_ERROR_RESPONSE"}});
+    ret.emplace_back("tlm_sync_enum", std::vector<dictionary_entry>{{tlm::TLM_ACCEPTED, "tlm::TLM_ACCEPTED"},
+                                                                    {tlm::TLM_UPDATED, "tlm::TLM_UPDATED"},
+                                                                    {tlm::TLM_COMPLETED, "tlm::TLM_COMPLETED"}});
+    return ret;
+}
+} // namespace
+
+std::vector<enum_dictionary> const& get_attribute_dictionary(bool with_tlm_enums) {
+    static std::vector<enum_dictionary> const ext_dictionary = create_dictionary(false);
+    static std::vector<enum_dictionary> const dictionary = create_dictionary(true);
+    return with_tlm_enums ? dictionary : ext_dictionary;
+}
+
+std::string const& phase_name(tlm::tlm_phase const& p) {
+    static std::vector<std::string> names;
+    unsigned id = p;
+    if(id >= names.size())
+        names.resize(id + 1);
+    if(names[id].empty()) {
+        std::ostringstream os;
+        os << p;
+        names[id] = os.str();
+    }
+    return names[id];
+}
+
+char const* attribute_name(std::string const& prefix, char const* name) {
+    static std::unordered_map<std::string, std::unordered_map<char const*, std::string>> names;
+    auto& entry = names[prefix][name];
+    if(entry.empty())
+        entry = prefix + name;
+    return entry.c_str();
+}
+} // namespace axi
@@ -0,0 +1,71 @@
+/*
+ * Copyright 2023 Arteris IP
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <string>
+#include <tlm>
+#include <utility>
+#include <vector>
+
+namespace axi {
+//! an entry of the attribute dictionary
+struct dictionary_entry {
+    int id;
+    std::string name;
+};
+//! the dictionary of an enumeration: its name and the names of its values
+using enum_dictionary = std::pair<char const*, std::vector<dictionary_entry>>;
+/**
+ * @brief the dictionary of the enumerations the recorders can record as integer ids (interned attributes)
+ *
+ * Covers the AXI burst, resp, domain, snoop and barrier enumerations of the extensions and, if requested, the TLM phases
+ * used by AXI/ACE, tlm_command, tlm_response_status and tlm_sync_enum. The recorders write it once into the database
+ * so that a viewer can map the ids back to names.
+ *
+ * @param with_tlm_enums true if the recorder interns the TLM enumerations of the payload and the phases as well
+ * @return the dictionaries of the interned enumerations
+ */
+std::vector<enum_dictionary> const& get_attribute_dictionary(bool with_tlm_enums);
+/**
+ * @brief the interning setting of the recorder currently calling the extension recorders
+ *
+ * The extension recorders are shared by all recorders, so the extension_recorder_list passes the setting of its
+ * recorder with this flag. It is thread local as the recording may happen in a separate thread.
+ * @return true if the extension recorders record enumerations as integer ids
+ */
+inline bool& interning_active() {
+    static thread_local bool flag{false};
+    return flag;
+}
+/**
+ * @brief the name of a phase
+ *
+ * The names are cached so that they are not formatted for each recorded transaction.
+ * @param p the phase
+ * @return the name of the phase
+ */
+std::string const& phase_name(tlm::tlm_phase const& p);
+/**
+ * @brief the interned attribute name consisting of prefix and name
+ *
+ * The names are cached so that they are not formatted for each recorded transaction.
+ * @param prefix the prefix of the attribute like "trans.axi4."
+ * @param name the name of the attribute, needs to be a string literal
+ * @return the attribute name, valid for the lifetime of the program
+ */
+char const* attribute_name(std::string const& prefix, char const* name);
+} // namespace axi
@@ -23,9 +23,13 @@
 #include <array>
 #include <axi/axi_tlm.h>
 #include <axi/checker/axi_protocol.h>
+#include <axi/extension_recorder_list.h>
+#include <axi/lwtr/async_writer.h>
+#include <axi/trace_file.h>
 #include <cci_configuration>
 #include <regex>
 #include <scc/peq.h>
+#include <scc/report.h>
 #include <string>
 #include <tlm/scc/lwtr/tlm2_lwtr.h>
 #include <tlm/scc/tlm_mm.h>
@@ -50,6 +54,12 @@ struct nb_ace_rec_entry : public nb_rec_entry {
     , snoop(snoop) {}
 };
 extern bool registered;
+/**
+ * @brief records the dictionary of the interned enumerations once into the given database
+ *
+ * @param db the database to record into
+ */
+void record_attribute_dictionary(tx_db* db);
 
 /*! \brief The TLM2 transaction recorder
  *
@@ -60,7 +70,9 @@ extern bool registered;
  * e.g. further down the path can link to it.
  */
 template <typename TYPES = axi::axi_protocol_types>
-class ace_lwtr : public virtual axi::ace_fw_transport_if<TYPES>, public virtual axi::ace_bw_transport_if<TYPES> {
+class ace_lwtr : public virtual axi::ace_fw_transport_if<TYPES>,
+                 public virtual axi::ace_bw_transport_if<TYPES>,
+                 private async_job_handler {
 public:
     //! \brief the attribute to selectively enable/disable recording of blocking protocol tx
     cci::cci_param<bool> enableBlTracing;
@@ -71,9 +83,31 @@ public:
     //! \brief the attribute to selectively enable/disable timed recording
     cci::cci_param<bool> enableTimedTracing{"enableTimedTracing", true};
 
+    //! \brief the number of recorded phases after which the recorders of extensions never found in a payload are skipped,
+    //! 0 calls all registered extension recorders
+    cci::cci_param<unsigned> extensionRecordingWarmUp{"extensionRecordingWarmUp", 0};
+
     //! \brief the attribute to selectively enable/disable DMI recording
     cci::cci_param<bool> enableDmiTracing{"enableDmiTracing", false};
 
+    //! \brief the attribute to record the AXI/ACE enumerations of the extensions as integer ids
+    //! the names of the ids are recorded once as dictionary stream into the database
+    cci::cci_param<bool> enableInternedAttributes{"enableInternedAttributes", false};
+
+    /*! \brief the attribute to enable/disable asynchronous recording of non-blocking tx
+     *
+     * If enabled the non-blocking tx are recorded by the background thread of the async_writer, the recorder only
+     * takes a snapshot of the payload. All recorders writing to the same database need to use the same setting.
+     */
+    cci::cci_param<bool> enableAsyncTracing{"enableAsyncTracing", false};
+
+    /*! \brief the name of a compact binary trace file, if set the tx are written there instead of the database
+     *
+     * The trace holds one fixed-width record per phase in delta and varint encoded columns (see axi::trace_writer).
+     * Recorders using the same file name share the file.
+     */
+    cci::cci_param<std::string> traceFile{"traceFile", ""};
+
     /*! \brief The constructor of the component
      *
      * \param name is the SystemC module name of the recorder
@@ -94,10 +128,16 @@ public:
         opts.dont_initialize();
         opts.set_sensitivity(&nb_timed_peq.event());
         sc_core::sc_spawn([this]() { nbtx_cb(); }, nullptr, &opts);
+        opts.set_sensitivity(&nb_async_peq.event());
+        sc_core::sc_spawn([this]() { nbtx_async_cb(); }, nullptr, &opts);
         initialize_streams();
     }
 
     virtual ~ace_lwtr() override {
+        if(async) {
+            async_writer::get().flush();
+            async_writer::get().drop(this);
+        }
         nbtx_req_handle_map.clear();
         nbtx_last_req_handle_map.clear();
         nbtx_resp_handle_map.clear();
@@ -111,6 +151,8 @@ public:
         delete nb_streamHandle;
         for(auto* p : nb_trHandle)
             delete p; // NOLINT
+        for(auto* p : nb_trAsyncHandle)
+            delete p; // NOLINT
         delete nb_streamHandleTimed;
         for(auto* p : nb_trTimedHandle)
             delete p; // NOLINT
@@ -189,13 +231,13 @@ public:
      * \return if true transaction recording is enabled otherwise transaction
      * recording is bypassed
      */
-    inline bool isRecordingBlockingTxEnabled() const { return m_db && enableBlTracing.get_value(); }
+    inline bool isRecordingBlockingTxEnabled() const { return (m_db || trace) && enableBlTracing.get_value(); }
     /*! \brief get the current state of transaction recording
      *
      * \return if true transaction recording is enabled otherwise transaction
      * recording is bypassed
      */
-    inline bool isRecordingNonBlockingTxEnabled() const { return m_db && enableNbTracing.get_value(); }
+    inline bool isRecordingNonBlockingTxEnabled() const { return (m_db || trace) && enableNbTracing.get_value(); }
 
 protected:
     //! \brief the port where fw accesses are forwarded to
@@ -206,6 +248,13 @@ protected:
 
 private:
     std::string const full_name;
+    //! the registered extension recorders, built when the first transaction is recorded
+    axi::extension_recorder_list<lwtr4tlm2_extension_registry_if<TYPES>> ext_recorder_list;
+    inline axi::extension_recorder_list<lwtr4tlm2_extension_registry_if<TYPES>>& ext_recorders() {
+        if(!ext_recorder_list.is_initialized())
+            ext_recorder_list.init(lwtr4tlm2_extension_registry<TYPES>::inst().get(), extensionRecordingWarmUp.get_value());
+        return ext_recorder_list;
+    }
     //! event queue to hold time points of non-blocking transactions
     ::scc::peq<nb_ace_rec_entry> nb_timed_peq;
     /*! \brief The thread processing the non-blocking requests with their
@@ -213,7 +262,43 @@ private:
      * to generate the timed view of non-blocking tx
      */
     void nbtx_cb();
+    //! records a timed non-blocking phase at the current time (at == nullptr) or at the given time
+    void nbtx_record(tlm::tlm_phase const& ph, uint64_t id, tx_handle parent, tlm::tlm_generic_payload& tr, sc_core::sc_time const* at);
+    //! event queue to hold time points of non-blocking transactions in async mode
+    ::scc::peq<async_rec_entry> nb_async_peq;
+    //! hands the timed non-blocking phases over to the async_writer
+    void nbtx_async_cb();
+    //! the non-blocking transport in async mode
+    tlm::tlm_sync_enum nb_transport_async(uint8_t dir, typename TYPES::tlm_payload_type& trans, typename TYPES::tlm_phase_type& phase,
+                                          sc_core::sc_time& delay);
+    //! executes the jobs posted in async mode on the recording thread
+    void process(async_job& job) override;
+    //! the compact trace the tx are written to instead of the database, nullptr if traceFile is not set
+    axi::trace_writer* trace{nullptr};
+    //! the stream id of this recorder in the compact trace
+    uint16_t trace_stream{0};
+    //! writes a phase to the compact trace
+    void trace_phase(uint8_t flags, typename TYPES::tlm_payload_type& trans, tlm::tlm_phase const& phase, sc_core::sc_time const& delay);
+    //! the non-blocking transport writing to the compact trace
+    tlm::tlm_sync_enum nb_transport_trace(uint8_t dir, typename TYPES::tlm_payload_type& trans, typename TYPES::tlm_phase_type& phase,
+                                          sc_core::sc_time& delay);
+    //! waits for the recording thread before recording on the simulation thread
+    void sync_recording() {
+        if(async)
+            async_writer::get().flush();
+    }
+    tx_handle timed_begin(tx_generator<>* gen, tx_handle const& parent, sc_core::sc_time const* at) {
+        return at ? gen->begin_tx_delayed(*at, par_chld_hndl, parent) : gen->begin_tx(par_chld_hndl, parent);
+    }
+    void timed_end(tx_handle& h, sc_core::sc_time const* at) {
+        if(at)
+            h.end_tx_delayed(*at);
+        else
+            h.end_tx();
+    }
     const unsigned bus_width{0};
+    //! true if the non-blocking tx are recorded asynchronously
+    bool async{false};
     //! transaction recording database
     tx_db* m_db{nullptr};
     //! the relationship name handles
@@ -235,6 +320,8 @@ private:
     tx_fiber* nb_streamHandleTimed{nullptr};
     //! transaction generator handle for non-blocking transactions
     std::array<tx_generator<std::string, std::string>*, 3> nb_trHandle{{nullptr, nullptr, nullptr}};
+    //! transaction generator handle for non-blocking transactions in async mode, the phases are recorded as attributes
+    std::array<tx_generator<>*, 2> nb_trAsyncHandle{{nullptr, nullptr}};
     //! transaction generator handle for non-blocking transactions with annotated delays
     std::array<tx_generator<>*, 3> nb_trTimedHandle{{nullptr, nullptr, nullptr}};
     std::unordered_map<uint64_t, tx_handle> nbtx_req_handle_map;
@@ -248,12 +335,32 @@ private:
     tx_generator<sc_dt::uint64, sc_dt::uint64>* dmi_trInvalidateHandle{nullptr};
 
 protected:
+    //! checks the phases the protocol checker still holds, called by the module wrapping the recorder at the end of
+    //! the simulation so that the reports carry simulation time
+    void end_of_simulation() {
+        if(checker)
+            checker->flush();
+    }
+
     void initialize_streams() {
+        if(!trace && !traceFile.get_value().empty()) {
+            auto& writer = axi::trace_writer::get(traceFile.get_value());
+            if(writer.is_open()) {
+                trace = &writer;
+                trace_stream = writer.add_stream(full_name);
+            } else {
+                SCCERR(full_name.c_str()) << "could not open trace file '" << traceFile.get_value() << "', recording to the database";
+            }
+        }
+        if(m_db && enableInternedAttributes.get_value()) {
+            ext_recorders().set_interned(true);
+            record_attribute_dictionary(m_db);
+        }
         if(m_db) {
             pred_succ_hndl = m_db->create_relation("PREDECESSOR_SUCCESSOR");
             par_chld_hndl = m_db->create_relation("PARENT_CHILD");
         }
-        if(isRecordingBlockingTxEnabled() && !b_streamHandle) {
+        if(m_db && !trace && isRecordingBlockingTxEnabled() && !b_streamHandle) {
             b_streamHandle = new tx_fiber((full_name + "_bl").c_str(), "[TLM][ace][b]", m_db);
             b_trHandle[tlm::TLM_READ_COMMAND] =
                 new tx_generator<sc_core::sc_time, sc_core::sc_time>("read", *b_streamHandle, "start_delay", "end_delay");
@@ -268,10 +375,16 @@ protected:
                 b_trTimedHandle[tlm::TLM_IGNORE_COMMAND] = new tx_generator<>("ignore", *b_streamHandleTimed);
             }
         }
-        if(isRecordingNonBlockingTxEnabled() && !nb_streamHandle) {
+        if(m_db && !trace && isRecordingNonBlockingTxEnabled() && !nb_streamHandle) {
             nb_streamHandle = new tx_fiber((full_name + "_nb").c_str(), "[TLM][ace][nb]", m_db);
-            nb_trHandle[FW] = new tx_generator<std::string, std::string>("fw", *nb_streamHandle, "tlm_phase", "tlm_phase[return_path]");
-            nb_trHandle[BW] = new tx_generator<std::string, std::string>("bw", *nb_streamHandle, "tlm_phase", "tlm_phase[return_path]");
+            async = enableAsyncTracing.get_value();
+            if(async) {
+                nb_trAsyncHandle[FW] = new tx_generator<>("fw", *nb_streamHandle);
+                nb_trAsyncHandle[BW] = new tx_generator<>("bw", *nb_streamHandle);
+            } else {
+                nb_trHandle[FW] = new tx_generator<std::string, std::string>("fw", *nb_streamHandle, "tlm_phase", "tlm_phase[return_path]");
+                nb_trHandle[BW] = new tx_generator<std::string, std::string>("bw", *nb_streamHandle, "tlm_phase", "tlm_phase[return_path]");
+            }
             if(enableTimedTracing.get_value()) {
                 nb_streamHandleTimed = new tx_fiber((full_name + "_nb_timed").c_str(), "[TLM][ace][nb][timed]", m_db);
                 nb_trTimedHandle[FW] = new tx_generator<>("request", *nb_streamHandleTimed);
@@ -306,6 +419,9 @@ public:
         this->bw_port(ts.get_base_port());
         this->fw_port(is.get_base_port());
     }
+
+private:
+    void end_of_simulation() override { ace_lwtr<TYPES>::end_of_simulation(); }
 };
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // implementations of functions
@@ -316,6 +432,13 @@ template <typename TYPES> void ace_lwtr<TYPES>::b_transport(typename TYPES::tlm_
         fw_port->b_transport(trans, delay);
         return;
     }
+    if(trace) {
+        trace_phase(axi::TRACE_BLOCKING, trans, tlm::BEGIN_REQ, delay);
+        fw_port->b_transport(trans, delay);
+        trace_phase(axi::TRACE_BLOCKING | axi::TRACE_RETURN, trans, tlm::END_RESP, delay);
+        return;
+    }
+    sync_recording();
     // Get a handle for the new transaction
     tx_handle h = b_trHandle[trans.get_command()]->begin_tx(delay);
     tx_handle htim;
@@ -325,13 +448,11 @@ template <typename TYPES> void ace_lwtr<TYPES>::b_transport(typename TYPES::tlm_
     if(b_streamHandleTimed)
         htim = b_trTimedHandle[trans.get_command()]->begin_tx_delayed(sc_core::sc_time_stamp() + delay, par_chld_hndl, h);
 
-    if(registered)
-        for(auto& extensionRecording : lwtr4tlm2_extension_registry<TYPES>::inst().get())
-            if(extensionRecording) {
-                extensionRecording->recordBeginTx(h, trans);
-                if(htim.is_valid())
-                    extensionRecording->recordBeginTx(htim, trans);
-            }
+    if(registered) {
+        ext_recorders().record_begin(h, trans);
+        if(htim.is_valid())
+            ext_recorders().record_begin(htim, trans, false);
+    }
     link_pred_ext* preExt = nullptr;
 
     trans.get_extension(preExt);
@@ -347,6 +468,7 @@ template <typename TYPES> void ace_lwtr<TYPES>::b_transport(typename TYPES::tlm_
     tx_handle preTx(preExt->txHandle);
     preExt->txHandle = h;
     fw_port->b_transport(trans, delay);
+    sync_recording();
     trans.get_extension(preExt);
     if(preExt->creator == this) {
         // clean-up the extension if this is the original creator
@@ -359,13 +481,11 @@ template <typename TYPES> void ace_lwtr<TYPES>::b_transport(typename TYPES::tlm_
     }
 
     h.record_attribute("trans", trans);
-    if(registered)
-        for(auto& extensionRecording : lwtr4tlm2_extension_registry<TYPES>::inst().get())
-            if(extensionRecording) {
-                extensionRecording->recordEndTx(h, trans);
-                if(htim.is_active())
-                    extensionRecording->recordEndTx(htim, trans);
-            }
+    if(registered) {
+        ext_recorders().record_end(h, trans);
+        if(htim.is_active())
+            ext_recorders().record_end(htim, trans);
+    }
     // End the transaction
     h.end_tx(delay);
     // and now the stuff for the timed tx
@@ -376,10 +496,17 @@ template <typename TYPES> void ace_lwtr<TYPES>::b_transport(typename TYPES::tlm_
 }
 
 template <typename TYPES> void ace_lwtr<TYPES>::b_snoop(typename TYPES::tlm_payload_type& trans, sc_core::sc_time& delay) {
+    if(trace && enableBlTracing.get_value()) {
+        trace_phase(axi::TRACE_BLOCKING | axi::TRACE_BW | axi::TRACE_SNOOP, trans, tlm::BEGIN_REQ, delay);
+        bw_port->b_snoop(trans, delay);
+        trace_phase(axi::TRACE_BLOCKING | axi::TRACE_BW | axi::TRACE_SNOOP | axi::TRACE_RETURN, trans, tlm::END_RESP, delay);
+        return;
+    }
     if(!b_streamHandleTimed) {
         bw_port->b_snoop(trans, delay);
         return;
     }
+    sync_recording();
     // Get a handle for the new transaction
     tx_handle h = b_trHandle[trans.get_command()]->begin_tx(delay);
     tx_handle htim;
@@ -389,13 +516,11 @@ template <typename TYPES> void ace_lwtr<TYPES>::b_snoop(typename TYPES::tlm_payl
     if(b_streamHandleTimed)
         htim = b_trTimedHandle[trans.get_command()]->begin_tx_delayed(sc_core::sc_time_stamp() + delay, par_chld_hndl, h);
 
-    if(registered)
-        for(auto& extensionRecording : lwtr4tlm2_extension_registry<TYPES>::inst().get())
-            if(extensionRecording) {
-                extensionRecording->recordBeginTx(h, trans);
-                if(htim.is_valid())
-                    extensionRecording->recordBeginTx(htim, trans);
-            }
+    if(registered) {
+        ext_recorders().record_begin(h, trans);
+        if(htim.is_valid())
+            ext_recorders().record_begin(htim, trans, false);
+    }
     link_pred_ext* preExt = nullptr;
 
     trans.get_extension(preExt);
@@ -408,6 +533,7 @@ template <typename TYPES> void ace_lwtr<TYPES>::b_snoop(typename TYPES::tlm_payl
     tx_handle preTx(preExt->txHandle);
     preExt->txHandle = h;
     bw_port->b_snoop(trans, delay);
+    sync_recording();
     trans.get_extension(preExt);
     if(preExt->creator == this) {
         // clean-up the extension if this is the original creator
@@ -419,13 +545,11 @@ template <typename TYPES> void ace_lwtr<TYPES>::b_snoop(typename TYPES::tlm_payl
     }
 
     h.record_attribute("trans", trans);
-    if(registered)
-        for(auto& extensionRecording : lwtr4tlm2_extension_registry<TYPES>::inst().get())
-            if(extensionRecording) {
-                extensionRecording->recordEndTx(h, trans);
-                if(htim.is_active())
-                    extensionRecording->recordEndTx(htim, trans);
-            }
+    if(registered) {
+        ext_recorders().record_end(h, trans);
+        if(htim.is_active())
+            ext_recorders().record_end(htim, trans);
+    }
     // End the transaction
     h.end_tx(delay);
     // and now the stuff for the timed tx
@@ -441,6 +565,10 @@ tlm::tlm_sync_enum ace_lwtr<TYPES>::nb_transport_fw(typename TYPES::tlm_payload_
     if(!isRecordingNonBlockingTxEnabled()) {
         return fw_port->nb_transport_fw(trans, phase, delay);
     }
+    if(trace)
+        return nb_transport_trace(FW, trans, phase, delay);
+    if(async)
+        return nb_transport_async(FW, trans, phase, delay);
     /*************************************************************************
      * prepare recording
      *************************************************************************/
@@ -464,9 +592,7 @@ tlm::tlm_sync_enum ace_lwtr<TYPES>::nb_transport_fw(typename TYPES::tlm_payload_
     preExt->txHandle = h;
     h.record_attribute("delay", delay);
     if(registered)
-        for(auto& extensionRecording : lwtr4tlm2_extension_registry<TYPES>::inst().get())
-            if(extensionRecording)
-                extensionRecording->recordBeginTx(h, trans);
+        ext_recorders().record_begin(h, trans);
     /*************************************************************************
      * do the timed notification
      *************************************************************************/
@@ -491,9 +617,7 @@ tlm::tlm_sync_enum ace_lwtr<TYPES>::nb_transport_fw(typename TYPES::tlm_payload_
     h.record_attribute("delay[return_path]", delay);
     h.record_attribute("trans", trans);
     if(registered)
-        for(auto& extensionRecording : lwtr4tlm2_extension_registry<TYPES>::inst().get())
-            if(extensionRecording)
-                extensionRecording->recordEndTx(h, trans);
+        ext_recorders().record_end(h, trans);
     // get the extension and free the memory if it was mine
     if(status == tlm::TLM_COMPLETED || (phase == axi::ACK)) {
         trans.get_extension(preExt);
@@ -535,6 +659,10 @@ tlm::tlm_sync_enum ace_lwtr<TYPES>::nb_transport_bw(typename TYPES::tlm_payload_
         } else
             return bw_port->nb_transport_bw(trans, phase, delay);
     }
+    if(trace)
+        return nb_transport_trace(BW, trans, phase, delay);
+    if(async)
+        return nb_transport_async(BW, trans, phase, delay);
     /*************************************************************************
      * prepare recording
      *************************************************************************/
@@ -557,9 +685,7 @@ tlm::tlm_sync_enum ace_lwtr<TYPES>::nb_transport_bw(typename TYPES::tlm_payload_
     }
     // and set the extension handle to this transaction
     h.record_attribute("delay", delay);
-    for(auto& extensionRecording : lwtr4tlm2_extension_registry<TYPES>::inst().get())
-        if(extensionRecording)
-            extensionRecording->recordBeginTx(h, trans);
+    ext_recorders().record_begin(h, trans);
     /*************************************************************************
      * do the timed notification
      *************************************************************************/
@@ -583,9 +709,7 @@ tlm::tlm_sync_enum ace_lwtr<TYPES>::nb_transport_bw(typename TYPES::tlm_payload_
     h.record_attribute("delay[return_path]", delay);
     h.record_attribute("trans", trans);
     if(registered)
-        for(auto& extensionRecording : lwtr4tlm2_extension_registry<TYPES>::inst().get())
-            if(extensionRecording)
-                extensionRecording->recordEndTx(h, trans);
+        ext_recorders().record_end(h, trans);
     // End the transaction
     nb_trHandle[BW]->end_tx(h, phase.get_name());
     // get the extension and free the memory if it was mine
@@ -618,70 +742,204 @@ template <typename TYPES> void ace_lwtr<TYPES>::nbtx_cb() {
     auto opt = nb_timed_peq.get_next();
     if(opt) {
         auto& e = opt.get();
-        tx_handle h;
-        // Now process outstanding recordings
-        if(e.ph == tlm::BEGIN_REQ || e.ph == axi::BEGIN_PARTIAL_REQ) {
-            h = nb_trTimedHandle[REQ]->begin_tx(par_chld_hndl, e.parent);
-            nbtx_req_handle_map[e.id] = h;
-        } else if(e.ph == tlm::END_REQ || e.ph == axi::END_PARTIAL_REQ) {
-            auto it = nbtx_req_handle_map.find(e.id);
-            if(it != nbtx_req_handle_map.end()) {
-                h = it->second;
-                nbtx_req_handle_map.erase(it);
-                h.record_attribute("trans", *e.tr);
-                h.end_tx();
-                nbtx_last_req_handle_map[e.id] = h;
-            }
-        } else if(e.ph == tlm::BEGIN_RESP || e.ph == axi::BEGIN_PARTIAL_RESP) {
-            auto it = nbtx_req_handle_map.find(e.id);
-            if(it != nbtx_req_handle_map.end()) {
-                h = it->second;
-                nbtx_req_handle_map.erase(it);
-                h.record_attribute("trans", *e.tr);
-                h.end_tx();
-                nbtx_last_req_handle_map[e.id] = h;
-            }
-            h = nb_trTimedHandle[RESP]->begin_tx(par_chld_hndl, e.parent);
-            nbtx_resp_handle_map[e.id] = h;
-            it = nbtx_last_req_handle_map.find(e.id);
-            if(it != nbtx_last_req_handle_map.end()) {
+        nbtx_record(e.ph, e.id, e.parent, *e.tr, nullptr);
+    }
+    return;
+}
+
+template <typename TYPES>
+void ace_lwtr<TYPES>::nbtx_record(tlm::tlm_phase const& ph, uint64_t id, tx_handle parent, tlm::tlm_generic_payload& tr,
+                                  sc_core::sc_time const* at) {
+    tx_handle h;
+    // Now process outstanding recordings
+    if(ph == tlm::BEGIN_REQ || ph == axi::BEGIN_PARTIAL_REQ) {
+        h = timed_begin(nb_trTimedHandle[REQ], parent, at);
+        nbtx_req_handle_map[id] = h;
+    } else if(ph == tlm::END_REQ || ph == axi::END_PARTIAL_REQ) {
+        auto it = nbtx_req_handle_map.find(id);
+        if(it != nbtx_req_handle_map.end()) {
+            h = it->second;
+            nbtx_req_handle_map.erase(it);
+            h.record_attribute("trans", tr);
+            timed_end(h, at);
+            nbtx_last_req_handle_map[id] = h;
+        }
+    } else if(ph == tlm::BEGIN_RESP || ph == axi::BEGIN_PARTIAL_RESP) {
+        auto it = nbtx_req_handle_map.find(id);
+        if(it != nbtx_req_handle_map.end()) {
+            h = it->second;
+            nbtx_req_handle_map.erase(it);
+            h.record_attribute("trans", tr);
+            timed_end(h, at);
+            nbtx_last_req_handle_map[id] = h;
+        }
+        h = timed_begin(nb_trTimedHandle[RESP], parent, at);
+        nbtx_resp_handle_map[id] = h;
+        it = nbtx_last_req_handle_map.find(id);
+        if(it != nbtx_last_req_handle_map.end()) {
+            tx_handle& pred = it->second;
+            h.add_relation(pred_succ_hndl, pred);
+            nbtx_last_req_handle_map.erase(it);
+        } else {
+            it = nbtx_last_resp_handle_map.find(id);
+            if(it != nbtx_last_resp_handle_map.end()) {
                 tx_handle& pred = it->second;
                 h.add_relation(pred_succ_hndl, pred);
-                nbtx_last_req_handle_map.erase(it);
-            } else {
-                it = nbtx_last_resp_handle_map.find(e.id);
-                if(it != nbtx_last_resp_handle_map.end()) {
-                    tx_handle& pred = it->second;
-                    h.add_relation(pred_succ_hndl, pred);
-                    nbtx_last_resp_handle_map.erase(it);
-                }
+                nbtx_last_resp_handle_map.erase(it);
             }
-        } else if(e.ph == tlm::END_RESP || e.ph == axi::END_PARTIAL_RESP) {
-            auto it = nbtx_resp_handle_map.find(e.id);
-            if(it != nbtx_resp_handle_map.end()) {
-                h = it->second;
-                nbtx_resp_handle_map.erase(it);
-                h.record_attribute("trans", *e.tr);
-                h.end_tx();
-                if(e.ph == axi::END_PARTIAL_RESP) {
-                    nbtx_last_resp_handle_map[e.id] = h;
-                }
+        }
+    } else if(ph == tlm::END_RESP || ph == axi::END_PARTIAL_RESP) {
+        auto it = nbtx_resp_handle_map.find(id);
+        if(it != nbtx_resp_handle_map.end()) {
+            h = it->second;
+            nbtx_resp_handle_map.erase(it);
+            h.record_attribute("trans", tr);
+            timed_end(h, at);
+            if(ph == axi::END_PARTIAL_RESP) {
+                nbtx_last_resp_handle_map[id] = h;
             }
-        } else if(e.ph == axi::ACK) {
-            h = nb_trTimedHandle[ACK]->begin_tx(par_chld_hndl, e.parent);
-            h.record_attribute("trans", *e.tr);
-            h.end_tx();
-        } else
-            sc_assert(!"phase not supported!");
+        }
+    } else if(ph == axi::ACK) {
+        h = timed_begin(nb_trTimedHandle[ACK], parent, at);
+        h.record_attribute("trans", tr);
+        timed_end(h, at);
+    } else
+        sc_assert(!"phase not supported!");
+}
+
+template <typename TYPES>
+void ace_lwtr<TYPES>::trace_phase(uint8_t flags, typename TYPES::tlm_payload_type& trans, tlm::tlm_phase const& phase,
+                               sc_core::sc_time const& delay) {
+    axi::trace_record r;
+    r.time = (sc_core::sc_time_stamp() + delay).value();
+    r.tx = reinterpret_cast<uint64_t>(&trans);
+    r.phase = static_cast<unsigned>(phase);
+    r.stream = trace_stream;
+    axi::fill_axi_trace_record(r, trans);
+    r.flags |= flags;
+    trace->write(r);
+}
+
+template <typename TYPES>
+tlm::tlm_sync_enum ace_lwtr<TYPES>::nb_transport_trace(uint8_t dir, typename TYPES::tlm_payload_type& trans,
+                                                       typename TYPES::tlm_phase_type& phase, sc_core::sc_time& delay) {
+    uint8_t const flags = dir == FW ? 0 : axi::TRACE_BW;
+    trace_phase(flags, trans, phase, delay);
+    tlm::tlm_sync_enum status{tlm::TLM_ACCEPTED};
+    if(dir == FW) {
+        if(checker)
+            checker->fw_pre(trans, phase);
+        status = fw_port->nb_transport_fw(trans, phase, delay);
+        if(checker)
+            checker->fw_post(trans, phase, status);
+    } else {
+        if(checker)
+            checker->bw_pre(trans, phase);
+        status = bw_port->nb_transport_bw(trans, phase, delay);
+        if(checker)
+            checker->bw_post(trans, phase, status);
+    }
+    if(status != tlm::TLM_ACCEPTED)
+        trace_phase(flags | axi::TRACE_RETURN, trans, phase, delay);
+    return status;
+}
+
+template <typename TYPES>
+tlm::tlm_sync_enum ace_lwtr<TYPES>::nb_transport_async(uint8_t dir, typename TYPES::tlm_payload_type& trans,
+                                                       typename TYPES::tlm_phase_type& phase, sc_core::sc_time& delay) {
+    auto& writer = async_writer::get();
+    auto const slot = writer.new_slot();
+    auto const pred = writer.link(trans, slot, this, phase == tlm::BEGIN_REQ || (dir == FW && phase == axi::BEGIN_PARTIAL_REQ));
+    auto const id = reinterpret_cast<uint64_t>(&trans);
+    // the handle is referenced by the end of the call, the link extension and the timed entry
+    writer.post_begin(this, dir, slot, pred, nb_streamHandleTimed ? 3 : 2, phase, delay, trans);
+    auto const begin_phase = phase;
+    auto const begin_delay = delay;
+    tlm::tlm_sync_enum status{tlm::TLM_ACCEPTED};
+    if(dir == FW) {
+        if(checker)
+            checker->fw_pre(trans, phase);
+        status = fw_port->nb_transport_fw(trans, phase, delay);
+        if(checker)
+            checker->fw_post(trans, phase, status);
+    } else {
+        if(checker)
+            checker->bw_pre(trans, phase);
+        status = bw_port->nb_transport_bw(trans, phase, delay);
+        if(checker)
+            checker->bw_post(trans, phase, status);
+    }
+    auto const finished =
+        status == tlm::TLM_COMPLETED || (phase == axi::ACK && (dir == FW || status == tlm::TLM_UPDATED));
+    auto const timed_end = nb_streamHandleTimed && (finished || status == tlm::TLM_UPDATED);
+    // a single snapshot taken after the call is shared by the end of the call and the timed entries
+    auto* snap = writer.snapshot(trans, 1 + (nb_streamHandleTimed ? 1 : 0) + (timed_end ? 1 : 0));
+    if(nb_streamHandleTimed)
+        nb_async_peq.notify(async_rec_entry{snap, begin_phase, id, slot, 0}, begin_delay);
+    if(timed_end) {
+        writer.post_add_ref(slot);
+        nb_async_peq.notify(async_rec_entry{snap, phase, id, slot, 0}, delay);
+    }
+    writer.post_end(this, dir, slot, status, phase, delay, trans, snap);
+    if(finished)
+        writer.unlink(trans, this);
+    return status;
+}
+
+template <typename TYPES> void ace_lwtr<TYPES>::nbtx_async_cb() {
+    auto opt = nb_async_peq.get_next();
+    if(opt)
+        async_writer::get().post_timed(this, opt.get());
+}
+
+template <typename TYPES> void ace_lwtr<TYPES>::process(async_job& job) {
+    auto& writer = async_writer::get();
+    switch(job.type) {
+    case async_job::BEGIN: {
+        tx_handle h = nb_trAsyncHandle[job.channel]->begin_tx_delayed(job.time);
+        h.record_attribute("tlm_phase", std::string(job.phase.get_name()));
+        if(job.other) {
+            tx_handle pred = writer.get_handle(job.other);
+            if(pred.is_valid())
+                h.add_relation(pred_succ_hndl, pred);
+        }
+        h.record_attribute("delay", job.delay);
+        writer.set_handle(job.slot, h, job.refs, this);
+        if(job.other)
+            writer.release_handle(job.other);
+        break;
+    }
+    case async_job::END: {
+        tx_handle h = writer.get_handle(job.slot);
+        h.record_attribute("tlm_sync", job.status);
+        h.record_attribute("delay[return_path]", job.delay);
+        h.record_attribute("trans", *job.trans);
+        // the extensions are recorded from the snapshot taken after the call
+        if(registered) {
+            ext_recorders().record_begin(h, *job.trans);
+            ext_recorders().record_end(h, *job.trans);
+        }
+        h.record_attribute("tlm_phase[return_path]", std::string(job.phase.get_name()));
+        h.end_tx_delayed(job.time);
+        writer.release_handle(job.slot);
+        break;
+    }
+    case async_job::TIMED:
+        nbtx_record(job.phase, job.id, writer.get_handle(job.other), *job.trans, &job.time);
+        writer.release_handle(job.other);
+        break;
+    default:
+        break;
     }
-    return;
 }
 
 template <typename TYPES> bool ace_lwtr<TYPES>::get_direct_mem_ptr(typename TYPES::tlm_payload_type& trans, tlm::tlm_dmi& dmi_data) {
     if(!(m_db && enableDmiTracing.get_value()))
         return fw_port->get_direct_mem_ptr(trans, dmi_data);
+    sync_recording();
     tx_handle h = dmi_trGetHandle->begin_tx();
     bool status = fw_port->get_direct_mem_ptr(trans, dmi_data);
+    sync_recording();
     h.record_attribute("trans", trans);
     h.record_attribute("dmi_data", dmi_data);
     h.end_tx();
@@ -698,8 +956,10 @@ template <typename TYPES> void ace_lwtr<TYPES>::invalidate_direct_mem_ptr(sc_dt:
         bw_port->invalidate_direct_mem_ptr(start_addr, end_addr);
         return;
     }
+    sync_recording();
     tx_handle h = dmi_trInvalidateHandle->begin_tx(start_addr);
     bw_port->invalidate_direct_mem_ptr(start_addr, end_addr);
+    sync_recording();
     dmi_trInvalidateHandle->end_tx(h, end_addr);
     return;
 }
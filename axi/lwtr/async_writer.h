@@ -0,0 +1,419 @@
+/*
+ * Copyright 2023 Arteris IP
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <systemc>
+#include <thread>
+#include <tlm>
+#include <tlm/scc/lwtr/tlm2_lwtr.h>
+#include <unordered_map>
+#include <vector>
+
+namespace axi {
+namespace lwtr {
+struct async_job;
+//! the interface of a recorder executing its jobs on the recording thread of the async_writer
+struct async_job_handler {
+    virtual ~async_job_handler() = default;
+    /**
+     * @brief executes a job, called on the recording thread
+     * @param job the job posted by the recorder
+     */
+    virtual void process(async_job& job) = 0;
+};
+/**
+ * @brief a recording job handed over from the simulation thread to the recording thread
+ *
+ * The transaction handles only exist on the recording thread, the simulation thread refers to them by slot numbers.
+ * A BEGIN job creates the handle of its slot with refs references, END and TIMED jobs as well as the RELEASE jobs of
+ * the writer drop a reference. Once all references are dropped the handle is released.
+ */
+struct async_job {
+    enum type_e : uint8_t { ADD_REF, RELEASE, BEGIN, END, TIMED };
+    //! the recorder executing the job, nullptr for the reference counting jobs of the writer
+    async_job_handler* handler{nullptr};
+    type_e type{ADD_REF};
+    //! recorder specific channel, e.g. the forward or backward path
+    uint8_t channel{0};
+    //! the number of references of the handle created by a BEGIN job
+    uint8_t refs{0};
+    //! recorder specific flags
+    uint8_t flags{0};
+    //! the slot of the handle created or used by this job
+    uint64_t slot{0};
+    //! the slot of the predecessor (BEGIN) or parent (TIMED) handle, 0 if there is none
+    uint64_t other{0};
+    //! the id of the transaction being the address of the original payload
+    uint64_t id{0};
+    //! the simulation time the job refers to
+    sc_core::sc_time time;
+    sc_core::sc_time delay;
+    tlm::tlm_phase phase;
+    tlm::tlm_sync_enum status{tlm::TLM_ACCEPTED};
+    //! a snapshot of the payload and its extensions owned by the writer, nullptr for BEGIN jobs
+    tlm::tlm_generic_payload* trans{nullptr};
+};
+//! an entry of the timed event queue of a recorder in async mode
+struct async_rec_entry {
+    tlm::tlm_generic_payload* tr;
+    tlm::tlm_phase ph;
+    uint64_t id;
+    //! the slot of the handle of the non-blocking call
+    uint64_t parent;
+    uint8_t flags;
+};
+//! links the recordings of the phases of a transaction across recorders in async mode
+struct async_link_ext : public tlm::tlm_extension<async_link_ext> {
+    async_link_ext(uint64_t slot, void const* creator)
+    : slot(slot)
+    , creator(creator) {}
+
+    tlm::tlm_extension_base* clone() const override { return nullptr; }
+
+    void copy_from(tlm::tlm_extension_base const& other) override { slot = static_cast<async_link_ext const&>(other).slot; }
+    //! drops the reference to the handle if the payload is released while the transaction is still linked
+    void free() override;
+
+    uint64_t slot;
+    void const* const creator;
+};
+/**
+ * @brief the recording thread shared by all LWTR recorders in async mode
+ *
+ * The recorders post jobs into a lock-free single-producer/single-consumer ring, the recording thread formats the
+ * attributes and writes to the database. A non-blocking call takes one snapshot (deep copy) of the payload once the
+ * call returned, it is shared by the END job and the TIMED jobs of the call and reference counted. The snapshots are
+ * recycled: the recording thread returns them through a second ring once all their jobs are executed so that they are
+ * only allocated and freed on the simulation thread. If the ring is full the simulation thread waits for the recording
+ * thread.
+ *
+ * While the writer is active the database must only be accessed from the recording thread. Recording which is done
+ * on the simulation thread (blocking and DMI transactions) calls flush() first.
+ */
+class async_writer {
+public:
+    //! the number of jobs the ring between simulation and recording thread can hold
+    static constexpr size_t QUEUE_SIZE = 1 << 14;
+
+    static async_writer& get() {
+        static async_writer writer;
+        return writer;
+    }
+    /**
+     * @brief allocates a new slot for a transaction handle, simulation thread only
+     */
+    uint64_t new_slot() { return ++last_slot; }
+    /**
+     * @brief links a non-blocking call to the previous call of the same transaction, simulation thread only
+     *
+     * @param trans the payload
+     * @param slot the slot of the handle of the current call
+     * @param creator the recorder, becomes the creator of the link if there is none yet
+     * @param may_create true if the phase may start a transaction
+     * @return the slot of the previous call, 0 if there is none
+     */
+    uint64_t link(tlm::tlm_generic_payload& trans, uint64_t slot, void const* creator, bool may_create) {
+        auto* ext = trans.get_extension<async_link_ext>();
+        if(ext) {
+            auto pred = ext->slot;
+            ext->slot = slot;
+            return pred;
+        }
+        sc_assert(may_create && "ERROR in phase other than tlm::BEGIN_REQ");
+        ext = new async_link_ext(slot, creator);
+        if(trans.has_mm())
+            trans.set_auto_extension(ext);
+        else
+            trans.set_extension(ext);
+        return 0;
+    }
+    /**
+     * @brief removes the link of a finished transaction if the recorder created it, simulation thread only
+     */
+    void unlink(tlm::tlm_generic_payload& trans, void const* creator) {
+        auto* ext = trans.get_extension<async_link_ext>();
+        if(ext && ext->creator == creator) {
+            post_release(ext->slot);
+            // detached, so the memory manager does not free it again
+            trans.set_extension(static_cast<async_link_ext*>(nullptr));
+            delete ext;
+        }
+    }
+    /**
+     * @brief creates a snapshot of a payload, simulation thread only
+     *
+     * @param trans the payload
+     * @param refs the number of jobs the snapshot is handed over to
+     * @return the snapshot which is handed over to the writer as part of the jobs
+     */
+    tlm::tlm_generic_payload* snapshot(tlm::tlm_generic_payload const& trans, unsigned refs) {
+        drain_returned();
+        snapshot_payload* ret{nullptr};
+        if(free_payloads.empty())
+            ret = new snapshot_payload();
+        else {
+            ret = free_payloads.back();
+            free_payloads.pop_back();
+            // extensions present in both are reused by deep_copy_from, the other ones are stale
+            for(unsigned i = 0; i < tlm::max_num_extensions(); ++i)
+                if(ret->get_extension(i) && !trans.get_extension(i)) {
+                    ret->get_extension(i)->free();
+                    ret->set_extension(i, nullptr);
+                }
+        }
+        ret->deep_copy_from(trans);
+        ret->refs = refs;
+        return ret;
+    }
+    /**
+     * @brief posts a job, simulation thread only
+     */
+    void post(async_job const& job) {
+        if(!thread.joinable())
+            thread = std::thread([this]() { run(); });
+        auto h = head.load(std::memory_order_relaxed);
+        while(h - tail.load(std::memory_order_acquire) >= QUEUE_SIZE) {
+            drain_returned();
+            std::this_thread::yield();
+        }
+        jobs[h & (QUEUE_SIZE - 1)] = job;
+        head.store(h + 1, std::memory_order_release);
+    }
+    /**
+     * @brief posts the begin of a non-blocking call, simulation thread only
+     *
+     * @param handler the recorder
+     * @param channel the recorder specific channel
+     * @param slot the slot of the handle of the call
+     * @param pred the slot of the previous call of the transaction, 0 if none
+     * @param refs the number of references of the handle
+     * @param phase the phase of the call
+     * @param delay the annotated delay
+     * @param trans the payload, it is not copied as the call is not executed yet
+     */
+    void post_begin(async_job_handler* handler, uint8_t channel, uint64_t slot, uint64_t pred, uint8_t refs, tlm::tlm_phase const& phase,
+                    sc_core::sc_time const& delay, tlm::tlm_generic_payload const& trans) {
+        async_job job;
+        job.handler = handler;
+        job.type = async_job::BEGIN;
+        job.channel = channel;
+        job.refs = refs;
+        job.slot = slot;
+        job.other = pred;
+        job.id = reinterpret_cast<uint64_t>(&trans);
+        job.time = sc_core::sc_time_stamp();
+        job.delay = delay;
+        job.phase = phase;
+        post(job);
+    }
+    /**
+     * @brief posts the end of a non-blocking call, simulation thread only
+     *
+     * @param snap the snapshot of the payload taken after the call, the job holds one of its references
+     */
+    void post_end(async_job_handler* handler, uint8_t channel, uint64_t slot, tlm::tlm_sync_enum status, tlm::tlm_phase const& phase,
+                  sc_core::sc_time const& delay, tlm::tlm_generic_payload const& trans, tlm::tlm_generic_payload* snap) {
+        async_job job;
+        job.handler = handler;
+        job.type = async_job::END;
+        job.channel = channel;
+        job.slot = slot;
+        job.id = reinterpret_cast<uint64_t>(&trans);
+        job.time = sc_core::sc_time_stamp();
+        job.delay = delay;
+        job.phase = phase;
+        job.status = status;
+        job.trans = snap;
+        post(job);
+    }
+    /**
+     * @brief posts an entry of the timed event queue of a recorder, simulation thread only
+     */
+    void post_timed(async_job_handler* handler, async_rec_entry const& e) {
+        async_job job;
+        job.handler = handler;
+        job.type = async_job::TIMED;
+        job.flags = e.flags;
+        job.other = e.parent;
+        job.id = e.id;
+        job.time = sc_core::sc_time_stamp();
+        job.phase = e.ph;
+        job.trans = e.tr;
+        post(job);
+    }
+
+    void post_add_ref(uint64_t slot) {
+        async_job job;
+        job.type = async_job::ADD_REF;
+        job.slot = slot;
+        post(job);
+    }
+
+    void post_release(uint64_t slot) {
+        async_job job;
+        job.type = async_job::RELEASE;
+        job.slot = slot;
+        post(job);
+    }
+    /**
+     * @brief waits until all posted jobs are executed, simulation thread only
+     */
+    void flush() {
+        while(tail.load(std::memory_order_acquire) != head.load(std::memory_order_relaxed)) {
+            drain_returned();
+            std::this_thread::yield();
+        }
+        drain_returned();
+    }
+    /**
+     * @brief drops the handles of a recorder being destroyed, simulation thread only after flush()
+     *
+     * The pooled snapshots are freed as well: their extensions may return to pools of other libraries which must not
+     * be used during static destruction.
+     */
+    void drop(async_job_handler const* owner) {
+        for(auto it = handles.begin(); it != handles.end();)
+            if(it->second.owner == owner)
+                it = handles.erase(it);
+            else
+                ++it;
+        drain_returned();
+        for(auto* p : free_payloads)
+            delete p;
+        free_payloads.clear();
+    }
+    //! \return true until the writer is destroyed during static destruction
+    static bool is_alive() { return !destroyed(); }
+    /**
+     * @brief the handle of a slot, recording thread only
+     *
+     * @return the handle or an invalid handle if the slot is unknown
+     */
+    ::lwtr::tx_handle get_handle(uint64_t slot) const {
+        auto it = handles.find(slot);
+        return it != handles.end() ? it->second.hndl : ::lwtr::tx_handle();
+    }
+    /**
+     * @brief registers the handle of a slot, recording thread only
+     */
+    void set_handle(uint64_t slot, ::lwtr::tx_handle const& h, unsigned refs, async_job_handler const* owner) {
+        handles[slot] = handle_entry{h, refs, owner};
+    }
+    /**
+     * @brief drops a reference to the handle of a slot, recording thread only
+     */
+    void release_handle(uint64_t slot) {
+        auto it = handles.find(slot);
+        if(it != handles.end() && --it->second.refs == 0)
+            handles.erase(it);
+    }
+
+private:
+    //! a snapshot shared by several jobs, the reference count is only decremented on the recording thread
+    struct snapshot_payload : public tlm::tlm_generic_payload {
+        unsigned refs{0};
+    };
+
+    struct handle_entry {
+        ::lwtr::tx_handle hndl;
+        unsigned refs;
+        async_job_handler const* owner;
+    };
+
+    async_writer()
+    : jobs(QUEUE_SIZE)
+    , returned(QUEUE_SIZE) {}
+
+    ~async_writer() {
+        if(thread.joinable()) {
+            flush();
+            stop.store(true, std::memory_order_release);
+            thread.join();
+        }
+        // the remaining snapshots are not freed, see drop()
+        destroyed() = true;
+    }
+
+    static bool& destroyed() {
+        static bool flag{false};
+        return flag;
+    }
+
+    void run() {
+        unsigned idle = 0;
+        while(true) {
+            auto t = tail.load(std::memory_order_relaxed);
+            if(t == head.load(std::memory_order_acquire)) {
+                if(stop.load(std::memory_order_acquire))
+                    return;
+                if(++idle < 64)
+                    std::this_thread::yield();
+                else
+                    std::this_thread::sleep_for(std::chrono::microseconds(100));
+                continue;
+            }
+            idle = 0;
+            auto& job = jobs[t & (QUEUE_SIZE - 1)];
+            if(job.handler)
+                job.handler->process(job);
+            else if(job.type == async_job::ADD_REF) {
+                auto it = handles.find(job.slot);
+                if(it != handles.end())
+                    ++it->second.refs;
+            } else
+                release_handle(job.slot);
+            if(job.trans && --static_cast<snapshot_payload*>(job.trans)->refs == 0) {
+                auto r = ret_head.load(std::memory_order_relaxed);
+                while(r - ret_tail.load(std::memory_order_acquire) >= QUEUE_SIZE)
+                    std::this_thread::yield();
+                returned[r & (QUEUE_SIZE - 1)] = static_cast<snapshot_payload*>(job.trans);
+                ret_head.store(r + 1, std::memory_order_release);
+            }
+            job.trans = nullptr;
+            tail.store(t + 1, std::memory_order_release);
+        }
+    }
+
+    void drain_returned() {
+        auto r = ret_tail.load(std::memory_order_relaxed);
+        auto const end = ret_head.load(std::memory_order_acquire);
+        for(; r != end; ++r)
+            free_payloads.push_back(returned[r & (QUEUE_SIZE - 1)]);
+        ret_tail.store(r, std::memory_order_release);
+    }
+
+    uint64_t last_slot{0};
+    std::vector<async_job> jobs;
+    std::atomic<uint64_t> head{0}, tail{0};
+    std::vector<snapshot_payload*> returned;
+    std::atomic<uint64_t> ret_head{0}, ret_tail{0};
+    std::vector<snapshot_payload*> free_payloads;
+    std::unordered_map<uint64_t, handle_entry> handles;
+    std::atomic<bool> stop{false};
+    std::thread thread;
+};
+
+inline void async_link_ext::free() {
+    if(async_writer::is_alive())
+        async_writer::get().post_release(slot);
+    delete this;
+}
+} // namespace lwtr
+} // namespace axi
@@ -15,11 +15,22 @@
  */
 
 #include <axi/axi_tlm.h>
+#include <axi/interned_attributes.h>
 #include <tlm/scc/lwtr/lwtr4tlm2_extension_registry.h>
 #include <tlm/scc/scv/tlm_extension_recording_registry.h>
 #include <tlm/scc/tlm_id.h>
+#include <unordered_set>
 
 namespace lwtr {
+namespace {
+template <class Archive, typename E> inline void record_enum(Archive& ar, char const* name, E value) {
+    if(axi::interning_active())
+        ar& field(name, static_cast<unsigned>(value));
+    else
+        ar& field(name, to_char(value));
+}
+} // namespace
+
 template <class Archive> void record(Archive& ar, tlm::scc::tlm_id_extension const& e) { ar& field("uid", e.id); }
 template <class Archive> void record(Archive& ar, axi::axi3_extension const& e) {
     ar& field("id", e.get_id());
@@ -28,7 +39,7 @@ template <class Archive> void record(Archive& ar, axi::axi3_extension const& e)
     ar& field("user[RESP]", e.get_user(axi::common::id_type::RESP));
     ar& field("length", e.get_length());
     ar& field("size", e.get_size());
-    ar& field("burst", to_char(e.get_burst()));
+    record_enum(ar, "burst", e.get_burst());
     ar& field("prot", e.get_prot());
     ar& field("exclusive", e.is_exclusive() ? "true" : "false");
     ar& field("cache", e.get_cache());
@@ -47,7 +58,7 @@ template <class Archive> void record(Archive& ar, axi::axi4_extension const& e)
     ar& field("user[RESP]", e.get_user(axi::common::id_type::RESP));
     ar& field("length", e.get_length());
     ar& field("size", e.get_size());
-    ar& field("burst", to_char(e.get_burst()));
+    record_enum(ar, "burst", e.get_burst());
     ar& field("prot", e.get_prot());
     ar& field("exclusive", e.is_exclusive() ? "true" : "false");
     ar& field("cache", e.get_cache());
@@ -66,7 +77,7 @@ template <class Archive> void record(Archive& ar, axi::ace_extension const& e) {
     ar& field("user[RESP]", e.get_user(axi::common::id_type::RESP));
     ar& field("length", e.get_length());
     ar& field("size", e.get_size());
-    ar& field("burst", to_char(e.get_burst()));
+    record_enum(ar, "burst", e.get_burst());
     ar& field("prot", e.get_prot());
     ar& field("exclusive", e.is_exclusive() ? "true" : "false");
     ar& field("cache", e.get_cache());
@@ -76,9 +87,9 @@ template <class Archive> void record(Archive& ar, axi::ace_extension const& e) {
     ar& field("cache_read_alloc", e.is_read_allocate());
     ar& field("qos", e.get_qos());
     ar& field("region", e.get_region());
-    ar& field("domain", to_char(e.get_domain()));
-    ar& field("snoop", to_char(e.get_snoop()));
-    ar& field("barrier", to_char(e.get_barrier()));
+    record_enum(ar, "domain", e.get_domain());
+    record_enum(ar, "snoop", e.get_snoop());
+    record_enum(ar, "barrier", e.get_barrier());
     ar& field("unique", e.get_unique());
 }
 
@@ -97,6 +108,13 @@ const std::array<std::string, 5> phase2char{
 const std::array<std::string, 4> dmi2char{
     {"tlm::DMI_ACCESS_NONE", "tlm::DMI_ACCESS_READ", "tlm::DMI_ACCESS_WRITE", "tlm::DMI_ACCESS_READ_WRITE"}};
 const std::array<std::string, 3> sync2char{{"tlm::TLM_ACCEPTED", "tlm::TLM_UPDATED", "tlm::TLM_COMPLETED"}};
+
+template <typename E> inline void record_enum(::lwtr::tx_handle& handle, char const* name, E value) {
+    if(interning_active())
+        handle.record_attribute(name, static_cast<unsigned>(value));
+    else
+        handle.record_attribute(name, to_char(value));
+}
 } // namespace
 
 class tlm_id_ext_recording : public tlm::scc::lwtr::lwtr4tlm2_extension_registry_if<axi_protocol_types> {
@@ -114,7 +132,7 @@ class axi3_ext_recording : public tlm::scc::lwtr::lwtr4tlm2_extension_registry_i
     }
     void recordEndTx(::lwtr::tx_handle& handle, axi_protocol_types::tlm_payload_type& trans) override {
         if(auto* ext = trans.get_extension<axi3_extension>())
-            handle.record_attribute("trans.axi3.resp", to_char(ext->get_resp()));
+            record_enum(handle, "trans.axi3.resp", ext->get_resp());
     }
 };
 
@@ -125,7 +143,7 @@ class axi4_ext_recording : public tlm::scc::lwtr::lwtr4tlm2_extension_registry_i
     }
     void recordEndTx(::lwtr::tx_handle& handle, axi_protocol_types::tlm_payload_type& trans) override {
         if(auto* ext = trans.get_extension<axi4_extension>())
-            handle.record_attribute("trans.axi4.resp", to_char(ext->get_resp()));
+            record_enum(handle, "trans.axi4.resp", ext->get_resp());
     }
 };
 
@@ -136,7 +154,7 @@ class ace_ext_recording : public tlm::scc::lwtr::lwtr4tlm2_extension_registry_if
     }
     void recordEndTx(::lwtr::tx_handle& handle, axi_protocol_types::tlm_payload_type& trans) override {
         if(auto* ext = trans.get_extension<ace_extension>()) {
-            handle.record_attribute("trans.ace.resp", to_char(ext->get_resp()));
+            record_enum(handle, "trans.ace.resp", ext->get_resp());
             handle.record_attribute("trans.ace.cresp_PassDirty", ext->is_pass_dirty());
             handle.record_attribute("trans.ace.cresp_IsShared", ext->is_shared());
             handle.record_attribute("trans.ace.cresp_SnoopDataTransfer", ext->is_snoop_data_transfer());
@@ -167,5 +185,21 @@ bool register_extensions() {
 }
 bool registered = register_extensions();
 
+void record_attribute_dictionary(::lwtr::tx_db* db) {
+    static std::unordered_set<::lwtr::tx_db*> recorded;
+    if(!db || !recorded.insert(db).second)
+        return;
+    // the fiber and generators need to live as long as the database, so they are not freed
+    auto* fiber = new ::lwtr::tx_fiber("attribute_dictionary", "[dictionary]", db);
+    // the LWTR recorders intern the enumerations of the extensions only
+    for(auto& dict : get_attribute_dictionary(false)) {
+        auto* gen = new ::lwtr::tx_generator<int, std::string>(dict.first, *fiber, "id", "name");
+        for(auto& entry : dict.second) {
+            auto h = gen->begin_tx(entry.id);
+            gen->end_tx(h, entry.name);
+        }
+    }
+}
+
 } // namespace lwtr
 } // namespace axi
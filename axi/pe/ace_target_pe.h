@@ -157,8 +157,7 @@ protected:
     std::function<unsigned(payload_type& trans)> operation_cb;
     sc_core::sc_fifo<payload_type*> rd_resp_fifo{1}, wr_resp_fifo{1};
 
-    sc_core::sc_fifo<std::tuple<fsm::fsm_handle*, axi::fsm::protocol_time_point_e>> wr_resp_beat_fifo{128}, rd_resp_beat_fifo{128};
-    scc::ordered_semaphore rd_resp{1}, wr_resp_ch{1}, rd_resp_ch{1};
+    scc::ordered_semaphore wr_resp_ch{1}, rd_resp_ch{1};
 
     sc_core::sc_clock* clk_if{nullptr};
     std::unique_ptr<bw_intor_impl> bw_intor;
@@ -31,6 +31,16 @@ namespace pe {
 namespace {
 uint8_t log2n(uint8_t siz) { return ((siz > 1) ? 1 + log2n(siz >> 1) : 0); }
 
+unsigned get_qos(tlm::tlm_generic_payload const& trans) {
+    if(auto e = trans.get_extension<axi::ace_extension>())
+        return e->get_qos();
+    if(auto e = trans.get_extension<axi::axi4_extension>())
+        return e->get_qos();
+    if(auto e = trans.get_extension<axi::axi3_extension>())
+        return e->get_qos();
+    return 0;
+}
+
 } // anonymous namespace
 
 #if SYSTEMC_VERSION < 20250221
@@ -61,6 +71,20 @@ void axi_initiator_b::end_of_elaboration() {
     for(auto i = 0U; i < outstanding_snoops.get_value(); ++i) {
         sc_spawn(sc_bind(&axi_initiator_b::snoop_thread, this));
     }
+    collect_statistics = enable_statistics.get_value();
+    statistics.set_window_cycles(statistics_window.get_value());
+}
+
+void axi_initiator_b::end_of_simulation() {
+    if(!collect_statistics)
+        return;
+    auto file_name = statistics_file_name.get_value().length() ? statistics_file_name.get_value() : std::string(name()) + ".stats.json";
+    auto period_ps = static_cast<uint64_t>((clk_if ? clk_if->period() : clk_period) / sc_time(1, SC_PS));
+    if(statistics.write_json(file_name, name(), period_ps)) {
+        SCCINFO(SCMOD) << "wrote statistics to " << file_name;
+    } else {
+        SCCERR(SCMOD) << "could not write statistics to " << file_name;
+    }
 }
 
 void axi_initiator_b::b_snoop(payload_type& trans, sc_core::sc_time& t) {
@@ -140,7 +164,16 @@ void axi_initiator_b::transport(payload_type& trans, bool blocking) {
         else
             wr_waiting++;
         auto& txs = it->second;
-        auto timing_e = trans.set_auto_extension<atp::timing_params>(nullptr);
+        auto timing_e = trans.get_extension<atp::timing_params>();
+        auto const arrival_cycle = get_clk_cnt();
+        auto const qos = collect_statistics ? get_qos(trans) : 0U;
+        auto req_cycle = arrival_cycle;
+        auto first_data = true;
+        auto request_started = [&]() {
+            req_cycle = get_clk_cnt();
+            if(collect_statistics)
+                statistics.record(stats::initiator_stats::CREDIT_WAIT, trans.is_write(), axi_id, qos, req_cycle - arrival_cycle);
+        };
 
         if(enable_id_serializing.get_value()) {
             if(!id_mtx[axi_id]) {
@@ -168,6 +201,7 @@ void axi_initiator_b::transport(payload_type& trans, bool blocking) {
                 for(unsigned i = 1; i < (timing_e ? timing_e->awtv : awtv.get_value()); ++i) {
                     wait(clk_i.posedge_event());
                 }
+                request_started();
                 SCCTRACE(SCMOD) << "starting " << burst_length << " write beats of " << trans;
                 for(unsigned i = 0; i < burst_length - 1; ++i) {
                     if(protocol_cb[axi::fsm::BegPartReqE])
@@ -197,6 +231,7 @@ void axi_initiator_b::transport(payload_type& trans, bool blocking) {
                         /// Timing
                         for(unsigned i = 1; i < (timing_e ? timing_e->awtv : awtv.get_value()); ++i)
                             wait(clk_i.posedge_event());
+                        request_started();
                     }
                     auto res = send(trans, txs, axi::BEGIN_PARTIAL_REQ);
                     sc_assert(axi::END_PARTIAL_REQ == res);
@@ -207,6 +242,7 @@ void axi_initiator_b::transport(payload_type& trans, bool blocking) {
                 if(burst_length == 1) {
                     wr_waiting--;
                     wr_outstanding++;
+                    request_started();
                 }
                 if(protocol_cb[axi::fsm::BegReqE])
                     protocol_cb[axi::fsm::BegReqE](trans, false);
@@ -226,6 +262,7 @@ void axi_initiator_b::transport(payload_type& trans, bool blocking) {
             /// Timing
             for(unsigned i = 1; i < (timing_e ? timing_e->artv : artv.get_value()); ++i)
                 wait(clk_i.posedge_event());
+            request_started();
             SCCTRACE(SCMOD) << "starting address phase of " << trans;
             if(protocol_cb[axi::fsm::BegPartReqE])
                 protocol_cb[axi::fsm::BegPartReqE](trans, false);
@@ -251,6 +288,13 @@ void axi_initiator_b::transport(payload_type& trans, bool blocking) {
                 if(protocol_cb[axi::fsm::BegRespE])
                     protocol_cb[axi::fsm::BegRespE](trans, false);
                 SCCTRACE(SCMOD) << "received last beat of " << trans;
+                if(collect_statistics) {
+                    auto cycle = get_clk_cnt();
+                    if(trans.is_read() && first_data)
+                        statistics.record(stats::initiator_stats::REQ_TO_FIRST_DATA, false, axi_id, qos, cycle - req_cycle);
+                    statistics.record(stats::initiator_stats::REQ_TO_LAST_DATA, trans.is_write(), axi_id, qos, cycle - req_cycle);
+                    statistics.record_transfer(trans.is_write(), cycle, trans.get_data_length());
+                }
                 auto delay_in_cycles = timing_e ? (trans.is_read() ? timing_e->rbr : timing_e->br) : br.get_value();
                 for(unsigned i = 0; i < delay_in_cycles; ++i)
                     wait(clk_i.posedge_event());
@@ -267,6 +311,11 @@ void axi_initiator_b::transport(payload_type& trans, bool blocking) {
                 finished = true;
             } else if(std::get<0>(entry) == &trans && std::get<1>(entry) == axi::BEGIN_PARTIAL_RESP) { // RDAT without CRESP case
                 SCCTRACE(SCMOD) << "received beat = " << burst_length << " with trans " << trans;
+                if(first_data) {
+                    first_data = false;
+                    if(collect_statistics)
+                        statistics.record(stats::initiator_stats::REQ_TO_FIRST_DATA, false, axi_id, qos, get_clk_cnt() - req_cycle);
+                }
                 auto delay_in_cycles = timing_e ? timing_e->rbr : rbr.get_value();
                 for(unsigned i = 0; i < delay_in_cycles; ++i)
                     wait(clk_i.posedge_event());
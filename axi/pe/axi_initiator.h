@@ -22,6 +22,7 @@
 #include <scc/ordered_semaphore.h>
 #include <scc/peq.h>
 #include <scc/sc_variable.h>
+#include <stats/initiator_stats.h>
 #include <systemc>
 #include <tlm/scc/pe/intor_if.h>
 #include <tlm_utils/peq_with_get.h>
@@ -106,6 +107,12 @@ public:
     cci::cci_param<bool> enable_id_serializing{"enable_id_serializing", false};
     //! number of snoops which can be handled
     cci::cci_param<unsigned> outstanding_snoops{"outstanding_snoops", 8};
+    //! collect latency histograms and windowed bandwidth of the non-blocking transactions
+    cci::cci_param<bool> enable_statistics{"enable_statistics", false};
+    //! the length of a bandwidth window in clock cycles
+    cci::cci_param<unsigned> statistics_window{"statistics_window", 1000};
+    //! the JSON file the statistics are written to at the end of simulation, defaults to <name>.stats.json
+    cci::cci_param<std::string> statistics_file_name{"statistics_file_name", ""};
 
     /**
      * @brief register a callback for a certain time point
@@ -161,9 +168,12 @@ protected:
     scc::sc_variable<unsigned> rd_outstanding{"RdOutstanding", 0};
     scc::sc_variable<unsigned> wr_outstanding{"WrOutstanding", 0};
 
+    stats::initiator_stats statistics;
+
 private:
     sc_core::sc_clock* clk_if{nullptr};
     void end_of_elaboration() override;
+    void end_of_simulation() override;
     void clk_counter() { m_clock_counter++; }
     unsigned get_clk_cnt() { return m_clock_counter; }
 
@@ -172,6 +182,7 @@ private:
     unsigned m_clock_counter{0};
     unsigned m_prev_clk_cnt{0};
     unsigned snoops_in_flight{0};
+    bool collect_statistics{false};
 
     std::array<std::function<void(payload_type&, bool)>, axi::fsm::CB_CNT> protocol_cb;
 };
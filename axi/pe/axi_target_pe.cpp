@@ -18,6 +18,7 @@
 #define SC_INCLUDE_DYNAMIC_PROCESSES
 #endif
 
+#include <algorithm>
 #include <axi/fsm/protocol_fsm.h>
 #include <axi/fsm/types.h>
 #include <axi/pe/axi_target_pe.h>
@@ -32,6 +33,20 @@ using namespace axi;
 using namespace axi::fsm;
 using namespace axi::pe;
 
+namespace {
+inline bool is_full(size_t size, unsigned depth) { return depth && size >= depth; }
+
+inline unsigned get_qos(tlm::tlm_generic_payload const* trans) {
+    if(auto e = trans->get_extension<axi::ace_extension>())
+        return e->get_qos();
+    if(auto e = trans->get_extension<axi::axi4_extension>())
+        return e->get_qos();
+    if(auto e = trans->get_extension<axi::axi3_extension>())
+        return e->get_qos();
+    return 0;
+}
+} // namespace
+
 /******************************************************************************
  * target
  ******************************************************************************/
@@ -40,11 +55,13 @@ struct axi_target_pe::bw_intor_impl : public tlm::scc::pe::intor_bw_nb {
     bw_intor_impl(axi_target_pe* that)
     : that(that) {}
     unsigned transport(tlm::tlm_generic_payload& payload) override {
-        if((payload.is_read() && that->rd_resp_fifo.num_free())) {
-            that->rd_resp_fifo.write(&payload);
+        if(payload.is_read() && !is_full(that->rd_resp_fifo.size(), that->rd_resp_fifo_depth.get_value())) {
+            that->rd_resp_fifo.push_back(&payload);
+            that->rd_resp_fifo_evt.notify(SC_ZERO_TIME);
             return 0;
-        } else if((payload.is_write() && that->wr_resp_fifo.num_free())) {
-            that->wr_resp_fifo.write(&payload);
+        } else if(payload.is_write() && !is_full(that->wr_resp_fifo.size(), that->wr_resp_fifo_depth.get_value())) {
+            that->wr_resp_fifo.push_back(std::make_tuple(&payload, sc_time_stamp()));
+            that->wr_resp_fifo_evt.notify(SC_ZERO_TIME);
             return 0;
         }
         return std::numeric_limits<unsigned>::max();
@@ -81,6 +98,24 @@ void axi_target_pe::end_of_elaboration() { clk_if = dynamic_cast<sc_core::sc_clo
 void axi_target_pe::start_of_simulation() {
     if(!socket_bw)
         SCCFATAL(SCMOD) << "No backward interface registered!";
+    // write responses only compete if several of them are queued and the number of active ones is limited
+    if(qos_scheduling.get_value() && (wr_resp_fifo_depth.get_value() == 1 || wr_resp_beat_fifo_depth.get_value() == 0)) {
+        SCCWARN(SCMOD) << "qos_scheduling has no effect on write responses as wr_resp_fifo_depth is 1 or wr_resp_beat_fifo_depth "
+                          "is 0 (unlimited)";
+    }
+}
+
+void axi_target_pe::end_of_simulation() {
+    if(!qos_scheduling.get_value())
+        return;
+    for(auto cmd = 0U; cmd < qos_statistics.size(); ++cmd)
+        for(auto qos = 0U; qos < qos_statistics[cmd].size(); ++qos) {
+            auto const& stat = qos_statistics[cmd][qos];
+            if(stat.count)
+                SCCINFO(SCMOD) << (cmd == tlm::TLM_READ_COMMAND ? "read" : "write") << " QoS " << qos << ": " << stat.count
+                               << " transactions, avg latency " << stat.total_latency / static_cast<double>(stat.count)
+                               << ", max latency " << stat.max_latency;
+        }
 }
 
 void axi_target_pe::b_transport(payload_type& trans, sc_time& t) {
@@ -117,9 +152,12 @@ void axi_target_pe::setup_callbacks(fsm_handle* fsm_hndl) {
            outstanding_cnt[fsm_hndl->trans->get_command()] > max_outstanding_tx.get_value()) {
             stalled_tx[fsm_hndl->trans->get_command()] = fsm_hndl->trans.get();
             stalled_tp[fsm_hndl->trans->get_command()] = EndPartReqE;
+            perf.stall_begin(fsm_hndl->trans->is_write(), get_cycle());
         } else { // accepted, schedule response
-            if(!fsm_hndl->beat_count)
+            if(!fsm_hndl->beat_count) {
                 getOutStandingTx(fsm_hndl->trans->get_command())++;
+                perf.occupancy_changed(get_cycle(), getAllOutStandingTx());
+            }
             if(auto delay = get_cci_randomized_value(wr_data_accept_delay))
                 schedule(EndPartReqE, fsm_hndl->trans, delay - 1);
             else
@@ -137,9 +175,12 @@ void axi_target_pe::setup_callbacks(fsm_handle* fsm_hndl) {
            outstanding_cnt[fsm_hndl->trans->get_command()] > max_outstanding_tx.get_value()) {
             stalled_tx[fsm_hndl->trans->get_command()] = fsm_hndl->trans.get();
             stalled_tp[fsm_hndl->trans->get_command()] = EndReqE;
+            perf.stall_begin(fsm_hndl->trans->is_write(), get_cycle());
         } else { // accepted, schedule response
-            if(!fsm_hndl->beat_count)
+            if(!fsm_hndl->beat_count) {
                 getOutStandingTx(fsm_hndl->trans->get_command())++;
+                perf.occupancy_changed(get_cycle(), getAllOutStandingTx());
+            }
             auto latency = fsm_hndl->trans->is_read() ? get_cci_randomized_value(rd_addr_accept_delay)
                                                       : get_cci_randomized_value(wr_data_accept_delay);
             if(latency)
@@ -178,12 +219,13 @@ void axi_target_pe::setup_callbacks(fsm_handle* fsm_hndl) {
     };
     fsm_hndl->fsm->cb[BegPartRespE] = [this, fsm_hndl]() -> void {
         // scheduling the response
+        // the number of concurrent responses is limited in start_*_resp_thread so the beat queues cannot overrun
         if(fsm_hndl->trans->is_read()) {
-            if(!rd_resp_beat_fifo.nb_write(std::make_tuple(fsm_hndl, BegPartRespE)))
-                SCCERR(SCMOD) << "too many outstanding transactions";
+            rd_resp_beat_fifo.push_back(std::make_tuple(fsm_hndl, BegPartRespE));
+            rd_resp_beat_evt.notify(SC_ZERO_TIME);
         } else if(fsm_hndl->trans->is_write()) {
-            if(!wr_resp_beat_fifo.nb_write(std::make_tuple(fsm_hndl, BegPartRespE)))
-                SCCERR(SCMOD) << "too many outstanding transactions";
+            wr_resp_beat_fifo.push_back(std::make_tuple(fsm_hndl, BegPartRespE));
+            wr_resp_beat_evt.notify(SC_ZERO_TIME);
         }
     };
     fsm_hndl->fsm->cb[EndPartRespE] = [this, fsm_hndl]() -> void {
@@ -198,27 +240,48 @@ void axi_target_pe::setup_callbacks(fsm_handle* fsm_hndl) {
     };
     fsm_hndl->fsm->cb[BegRespE] = [this, fsm_hndl]() -> void {
         // scheduling the response
+        // the number of concurrent responses is limited in start_*_resp_thread so the beat queues cannot overrun
         if(fsm_hndl->trans->is_read()) {
-            if(!rd_resp_beat_fifo.nb_write(std::make_tuple(fsm_hndl, BegRespE)))
-                SCCERR(SCMOD) << "too many outstanding transactions";
+            rd_resp_beat_fifo.push_back(std::make_tuple(fsm_hndl, BegRespE));
+            rd_resp_beat_evt.notify(SC_ZERO_TIME);
         } else if(fsm_hndl->trans->is_write()) {
-            if(!wr_resp_beat_fifo.nb_write(std::make_tuple(fsm_hndl, BegRespE)))
-                SCCERR(SCMOD) << "too many outstanding transactions";
+            wr_resp_beat_fifo.push_back(std::make_tuple(fsm_hndl, BegRespE));
+            wr_resp_beat_evt.notify(SC_ZERO_TIME);
         }
     };
     fsm_hndl->fsm->cb[EndRespE] = [this, fsm_hndl]() -> void {
         fsm_hndl->trans->is_read() ? rd_resp_ch.post() : wr_resp_ch.post();
-        if(rd_resp.get_value() < rd_resp.get_capacity()) {
-            SCCTRACE(SCMOD) << "finishing exclusive read response for trans " << *fsm_hndl->trans;
-            rd_resp.post();
-        }
         auto cmd = fsm_hndl->trans->get_command();
         outstanding_cnt[cmd]--;
         getOutStandingTx(cmd)--;
-        if(cmd == tlm::TLM_READ_COMMAND)
-            active_rdresp_id.erase(axi::get_axi_id(fsm_hndl->trans.get()));
+        perf.occupancy_changed(get_cycle(), getAllOutStandingTx());
+        if(cmd < tlm::TLM_IGNORE_COMMAND) {
+            auto& stat = qos_statistics[cmd][get_qos(fsm_hndl->trans.get()) & 0xf];
+            auto latency = sc_time_stamp() - fsm_hndl->start;
+            perf.finished(cmd == tlm::TLM_WRITE_COMMAND, fsm_hndl->trans->get_data_length(),
+                          clk_if ? static_cast<uint64_t>(latency / clk_if->period()) : 0);
+            stat.count++;
+            stat.total_latency += latency;
+            if(latency > stat.max_latency)
+                stat.max_latency = latency;
+        }
+        if(cmd == tlm::TLM_READ_COMMAND) {
+            SCCTRACE(SCMOD) << "finishing read response for trans " << *fsm_hndl->trans;
+            auto id = axi::get_axi_id(fsm_hndl->trans.get());
+            active_rdresp_id.erase(id);
+            auto it = rd_resp_by_id.find(id);
+            if(it != rd_resp_by_id.end() && !it->second.empty())
+                rd_resp_ready_ids.push_back(id);
+            rd_resp_release_evt.notify(SC_ZERO_TIME);
+        } else if(cmd == tlm::TLM_WRITE_COMMAND) {
+            active_wr_resp_cnt--;
+            wr_resp_release_evt.notify(SC_ZERO_TIME);
+        }
         if(stalled_tx[cmd]) {
             auto* trans = stalled_tx[cmd];
+            getOutStandingTx(cmd)++;
+            perf.occupancy_changed(get_cycle(), getAllOutStandingTx());
+            perf.stall_end(cmd == tlm::TLM_WRITE_COMMAND, get_cycle());
             auto latency =
                 trans->is_read() ? get_cci_randomized_value(rd_addr_accept_delay) : get_cci_randomized_value(wr_data_accept_delay);
             if(latency)
@@ -242,8 +305,12 @@ void axi::pe::axi_target_pe::process_req2resp_fifos() {
     while(!rd_req2resp_fifo.empty()) {
         auto& entry = rd_req2resp_fifo.front();
         if(std::get<1>(entry) == 0) {
-            if(!rd_resp_fifo.nb_write(std::get<0>(entry)))
+            if(is_full(rd_resp_fifo.size(), rd_resp_fifo_depth.get_value()))
                 rd_req2resp_fifo.push_back(entry);
+            else {
+                rd_resp_fifo.push_back(std::get<0>(entry));
+                rd_resp_fifo_evt.notify(SC_ZERO_TIME);
+            }
             rd_req2resp_fifo.pop_front();
         } else {
             std::get<1>(entry) -= 1;
@@ -254,8 +321,12 @@ void axi::pe::axi_target_pe::process_req2resp_fifos() {
     while(!wr_req2resp_fifo.empty()) {
         auto& entry = wr_req2resp_fifo.front();
         if(std::get<1>(entry) == 0) {
-            if(!wr_resp_fifo.nb_write(std::get<0>(entry)))
+            if(is_full(wr_resp_fifo.size(), wr_resp_fifo_depth.get_value()))
                 wr_req2resp_fifo.push_back(entry);
+            else {
+                wr_resp_fifo.push_back(std::make_tuple(std::get<0>(entry), sc_time_stamp()));
+                wr_resp_fifo_evt.notify(SC_ZERO_TIME);
+            }
             wr_req2resp_fifo.pop_front();
         } else {
             std::get<1>(entry) -= 1;
@@ -265,22 +336,57 @@ void axi::pe::axi_target_pe::process_req2resp_fifos() {
     }
 }
 
-void axi::pe::axi_target_pe::start_rd_resp_thread() {
-    auto residual_clocks = 0.0;
-    while(true) {
-        auto* trans = rd_resp_fifo.read();
-        if(!rd_data_interleaving.get_value() || rd_data_beat_delay.get_value() == 0) {
-            while(!rd_resp.get_value())
-                wait(clk_i.posedge_event());
-            rd_resp.wait();
-        }
-        SCCTRACE(SCMOD) << __FUNCTION__ << " starting exclusive read response for trans " << *trans;
-        auto e = axi::get_burst_length(trans) == 1 || trans->is_write() ? axi::fsm::BegRespE : BegPartRespE;
-        auto id = axi::get_axi_id(trans);
-        while(active_rdresp_id.size() && active_rdresp_id.find(id) != active_rdresp_id.end()) {
-            wait(clk_i.posedge_event());
+unsigned axi::pe::axi_target_pe::get_effective_qos(payload_type const* trans, sc_time const& ready) const {
+    auto qos = get_qos(trans);
+    if(qos_aging_cycles.get_value() && clk_if)
+        qos += static_cast<unsigned>((sc_time_stamp() - ready) / clk_if->period()) / qos_aging_cycles.get_value();
+    return qos;
+}
+
+unsigned axi::pe::axi_target_pe::get_rd_resp_interleave_depth() const {
+    if(!rd_data_interleaving.get_value() || rd_data_beat_delay.get_value() == 0)
+        return 1;
+    return rd_resp_interleave_depth.get_value() ? rd_resp_interleave_depth.get_value() : std::numeric_limits<unsigned>::max();
+}
+
+void axi::pe::axi_target_pe::enqueue_rd_resp(payload_type* trans) {
+    auto id = axi::get_axi_id(trans);
+    auto& queue = rd_resp_by_id[id];
+    queue.push_back(std::make_tuple(trans, sc_time_stamp()));
+    // the first response of an idle ID may start right away, all others get released by their predecessor
+    if(queue.size() == 1 && active_rdresp_id.find(id) == active_rdresp_id.end())
+        rd_resp_ready_ids.push_back(id);
+}
+
+void axi::pe::axi_target_pe::dispatch_rd_resps() {
+    auto depth = get_rd_resp_interleave_depth();
+    // each active read response occupies at most one entry in the beat queue
+    if(rd_resp_beat_fifo_depth.get_value())
+        depth = std::min(depth, rd_resp_beat_fifo_depth.get_value());
+    while(rd_resp_ready_ids.size() && active_rdresp_id.size() < depth) {
+        auto sel = rd_resp_ready_ids.begin();
+        if(qos_scheduling.get_value()) {
+            // select the ID with the highest QoS, on equal QoS the one being ready longest
+            auto best_qos = 0U;
+            auto best_ready = sc_max_time();
+            for(auto it = rd_resp_ready_ids.begin(); it != rd_resp_ready_ids.end(); ++it) {
+                auto const& head = rd_resp_by_id[*it].front();
+                auto qos = get_effective_qos(std::get<0>(head), std::get<1>(head));
+                if(qos > best_qos || (qos == best_qos && std::get<1>(head) < best_ready)) {
+                    best_qos = qos;
+                    best_ready = std::get<1>(head);
+                    sel = it;
+                }
+            }
         }
+        auto id = *sel;
+        rd_resp_ready_ids.erase(sel);
+        auto& queue = rd_resp_by_id[id];
+        auto* trans = std::get<0>(queue.front());
+        queue.pop_front();
         active_rdresp_id.insert(id);
+        SCCTRACE(SCMOD) << __FUNCTION__ << " starting read response for trans " << *trans;
+        auto e = axi::get_burst_length(trans) == 1 || trans->is_write() ? axi::fsm::BegRespE : BegPartRespE;
         if(auto delay = get_cci_randomized_value(rd_data_beat_delay))
             schedule(e, trans, delay - 1U);
         else
@@ -288,11 +394,42 @@ void axi::pe::axi_target_pe::start_rd_resp_thread() {
     }
 }
 
+void axi::pe::axi_target_pe::start_rd_resp_thread() {
+    while(true) {
+        wait(rd_resp_fifo_evt | rd_resp_release_evt);
+        // a finished response releases the next one with the following clock edge
+        if(rd_resp_release_evt.triggered() && clk_if)
+            wait(clk_i.posedge_event());
+        while(!rd_resp_fifo.empty()) {
+            enqueue_rd_resp(rd_resp_fifo.front());
+            rd_resp_fifo.pop_front();
+        }
+        dispatch_rd_resps();
+    }
+}
+
 void axi::pe::axi_target_pe::start_wr_resp_thread() {
-    auto residual_clocks = 0.0;
     while(true) {
-        auto* trans = wr_resp_fifo.read();
-        schedule(axi::fsm::BegRespE, trans, SC_ZERO_TIME);
+        wait(wr_resp_fifo_evt | wr_resp_release_evt);
+        // stall if the beat queue is occupied, a finishing write response notifies wr_resp_release_evt
+        while(!wr_resp_fifo.empty() && !is_full(active_wr_resp_cnt, wr_resp_beat_fifo_depth.get_value())) {
+            auto sel = 0U;
+            if(qos_scheduling.get_value()) {
+                // select the response with the highest QoS, on equal QoS the oldest one
+                auto best_qos = 0U;
+                for(auto i = 0U; i < wr_resp_fifo.size(); ++i) {
+                    auto qos = get_effective_qos(std::get<0>(wr_resp_fifo[i]), std::get<1>(wr_resp_fifo[i]));
+                    if(qos > best_qos) {
+                        best_qos = qos;
+                        sel = i;
+                    }
+                }
+            }
+            auto* trans = std::get<0>(wr_resp_fifo[sel]);
+            wr_resp_fifo.erase(sel);
+            active_wr_resp_cnt++;
+            schedule(axi::fsm::BegRespE, trans, SC_ZERO_TIME);
+        }
     }
 }
 
@@ -300,8 +437,10 @@ void axi::pe::axi_target_pe::send_rd_resp_beat_thread() {
     std::tuple<fsm::fsm_handle*, axi::fsm::protocol_time_point_e> entry;
     while(true) {
         // waiting for responses to send, which is notifed in Begin_Partial_Resp
-        wait(rd_resp_beat_fifo.data_written_event());
-        while(rd_resp_beat_fifo.nb_read(entry)) {
+        wait(rd_resp_beat_evt);
+        while(!rd_resp_beat_fifo.empty()) {
+            entry = rd_resp_beat_fifo.front();
+            rd_resp_beat_fifo.pop_front();
             // there is something to send
             auto fsm_hndl = std::get<0>(entry);
             auto tp = std::get<1>(entry);
@@ -325,8 +464,10 @@ void axi::pe::axi_target_pe::send_wr_resp_beat_thread() {
     std::tuple<fsm::fsm_handle*, axi::fsm::protocol_time_point_e> entry;
     while(true) {
         // waiting for responses to send
-        wait(wr_resp_beat_fifo.data_written_event());
-        while(wr_resp_beat_fifo.nb_read(entry)) {
+        wait(wr_resp_beat_evt);
+        while(!wr_resp_beat_fifo.empty()) {
+            entry = wr_resp_beat_fifo.front();
+            wr_resp_beat_fifo.pop_front();
             // there is something to send
             auto fsm_hndl = std::get<0>(entry);
             sc_time t;
@@ -22,6 +22,9 @@
 
 #include <array>
 #include <axi/fsm/base.h>
+#include <axi/pe/ring_buffer.h>
+#include <axi/pe/target_perf_monitor.h>
+#include <deque>
 #include <functional>
 #include <memory>
 #include <scc/mt19937_rng.h>
@@ -29,6 +32,7 @@
 #include <scc/sc_variable.h>
 #include <tlm/scc/pe/intor_if.h>
 #include <tlm_utils/peq_with_cb_and_phase.h>
+#include <unordered_map>
 #include <unordered_set>
 
 //! TLM2.0 components modeling AXI/ACE
@@ -66,6 +70,43 @@ public:
      * @brief enable data interleaving on read responses if rd_data_beat_delay is greater than 0
      */
     cci::cci_param<bool> rd_data_interleaving{"rd_data_interleaving", true};
+    /**
+     * @brief the maximum number of IDs whose read responses may be interleaved at the same time. A value of 0 means
+     * unlimited. Without data interleaving (or a rd_data_beat_delay of 0) only one read response is active at a time
+     */
+    cci::cci_param<unsigned> rd_resp_interleave_depth{"rd_resp_interleave_depth", 0};
+    /**
+     * @brief the number of read responses the response interface (bw_i) accepts before it applies back-pressure. A
+     * value of 0 means unlimited
+     */
+    cci::cci_param<unsigned> rd_resp_fifo_depth{"rd_resp_fifo_depth", 1};
+    /**
+     * @brief the number of write responses the response interface (bw_i) accepts before it applies back-pressure. A
+     * value of 0 means unlimited
+     */
+    cci::cci_param<unsigned> wr_resp_fifo_depth{"wr_resp_fifo_depth", 1};
+    /**
+     * @brief the maximum number of read responses being sent concurrently i.e. the depth of the read response beat
+     * queue. If reached, further read responses are stalled. A value of 0 means unlimited
+     */
+    cci::cci_param<unsigned> rd_resp_beat_fifo_depth{"rd_resp_beat_fifo_depth", 0};
+    /**
+     * @brief the maximum number of write responses being sent concurrently i.e. the depth of the write response beat
+     * queue. If reached, further write responses are stalled. A value of 0 means unlimited
+     */
+    cci::cci_param<unsigned> wr_resp_beat_fifo_depth{"wr_resp_beat_fifo_depth", 0};
+    /**
+     * @brief if enabled ready responses are not sent in FIFO order but ordered by AxQOS. Per-QoS statistics are
+     * reported at the end of the simulation. Responses only compete if the number of concurrently active responses is
+     * limited (see rd_resp_interleave_depth and wr_resp_beat_fifo_depth). Write responses are selected among the
+     * entries of the write response fifo so wr_resp_fifo_depth should be larger than 1
+     */
+    cci::cci_param<bool> qos_scheduling{"qos_scheduling", false};
+    /**
+     * @brief the number of clock cycles a ready response needs to wait to increase its QoS value by 1 when
+     * qos_scheduling is enabled. This avoids starvation of low priority responses, a value of 0 disables aging
+     */
+    cci::cci_param<unsigned> qos_aging_cycles{"qos_aging_cycles", 16};
     /**
      * @brief the latency between between BEGIN(_PARTIAL)_REQ and END(_PARTIAL)_REQ (AWVALID to AWREADY and WVALID to
      * WREADY) -> AWR, WBR
@@ -141,6 +182,14 @@ public:
     void set_bw_interface(axi::axi_bw_transport_if<axi_protocol_types>* ifs) { socket_bw = ifs; }
 
     inline unsigned getAllOutStandingTx() const { return outstanding_rd_tx + outstanding_wr_tx + outstanding_ign_tx; }
+    /**
+     * @brief the performance counters accumulated since the start of simulation or the last reset_perf_counters()
+     */
+    target_perf_counters get_perf_counters() { return perf.get(get_cycle()); }
+    /**
+     * @brief start a new measurement window of the performance counters
+     */
+    void reset_perf_counters() { perf.reset(get_cycle(), getAllOutStandingTx()); }
 
 protected:
     axi_target_pe() = delete;
@@ -157,6 +206,8 @@ protected:
 
     void start_of_simulation() override;
 
+    void end_of_simulation() override;
+
     void fsm_clk_method() { process_fsm_clk_queue(); }
     /**
      * @see base::create_fsm_handle()
@@ -174,11 +225,16 @@ protected:
     scc::fifo_w_cb<std::tuple<payload_type*, unsigned>> rd_req2resp_fifo{"rd_req2resp_fifo"};
     scc::fifo_w_cb<std::tuple<payload_type*, unsigned>> wr_req2resp_fifo{"wr_req2resp_fifo"};
     void process_req2resp_fifos();
-    sc_core::sc_fifo<payload_type*> rd_resp_fifo{1}, wr_resp_fifo{1};
+    ring_buffer<payload_type*> rd_resp_fifo;
+    ring_buffer<std::tuple<payload_type*, sc_core::sc_time>> wr_resp_fifo;
+    sc_core::sc_event rd_resp_fifo_evt, wr_resp_fifo_evt;
     void start_rd_resp_thread();
     void start_wr_resp_thread();
-    sc_core::sc_fifo<std::tuple<fsm::fsm_handle*, axi::fsm::protocol_time_point_e>> wr_resp_beat_fifo{128}, rd_resp_beat_fifo{128};
-    scc::ordered_semaphore rd_resp{1}, wr_resp_ch{1}, rd_resp_ch{1};
+    ring_buffer<std::tuple<fsm::fsm_handle*, axi::fsm::protocol_time_point_e>> wr_resp_beat_fifo, rd_resp_beat_fifo;
+    sc_core::sc_event wr_resp_beat_evt, rd_resp_beat_evt;
+    unsigned active_wr_resp_cnt{0};
+    sc_core::sc_event wr_resp_release_evt;
+    scc::ordered_semaphore wr_resp_ch{1}, rd_resp_ch{1};
     void send_wr_resp_beat_thread();
     void send_rd_resp_beat_thread();
 
@@ -215,7 +271,29 @@ protected:
         base::nb_fw(trans, phase, delay);
     }
     tlm_utils::peq_with_cb_and_phase<axi_target_pe> fw_peq{this, &axi_target_pe::nb_fw};
+    /**
+     * @brief the read response arbitration: each ID has a queue of ready responses, an ID is in rd_resp_ready_ids
+     * if its next response may start. Finishing a response on an ID releases the next one of the same ID
+     */
+    void enqueue_rd_resp(payload_type* trans);
+    void dispatch_rd_resps();
+    unsigned get_rd_resp_interleave_depth() const;
     std::unordered_set<unsigned> active_rdresp_id;
+    std::unordered_map<unsigned, std::deque<std::tuple<payload_type*, sc_core::sc_time>>> rd_resp_by_id;
+    std::deque<unsigned> rd_resp_ready_ids;
+    sc_core::sc_event rd_resp_release_evt;
+    /**
+     * @brief the QoS value of a ready response including the aging since it became ready
+     */
+    unsigned get_effective_qos(payload_type const* trans, sc_core::sc_time const& ready) const;
+    struct qos_stat {
+        uint64_t count{0};
+        sc_core::sc_time total_latency;
+        sc_core::sc_time max_latency;
+    };
+    std::array<std::array<qos_stat, 16>, 2> qos_statistics;
+    target_perf_monitor perf;
+    uint64_t get_cycle() const { return clk_if ? static_cast<uint64_t>(sc_core::sc_time_stamp() / clk_if->period()) : 0; }
 };
 
 } // namespace pe
@@ -0,0 +1,166 @@
+/*
+ * Copyright 2020-2022 Arteris IP
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "dram_target.h"
+#include <algorithm>
+#include <scc/report.h>
+
+namespace axi {
+namespace pe {
+namespace {
+inline bool is_power_of_2(unsigned v) { return v && !(v & (v - 1)); }
+
+inline unsigned ilog2(unsigned v) {
+    unsigned res = 0;
+    while(v >>= 1)
+        ++res;
+    return res;
+}
+} // namespace
+
+dram_latency_buffer::dram_latency_buffer(const sc_core::sc_module_name& nm)
+: sc_core::sc_module(nm) {
+    fw_i.bind(*this);
+#if SYSTEMC_VERSION < 20250221
+    SC_HAS_PROCESS(dram_latency_buffer);
+#endif
+    SC_METHOD(clock_cb);
+    sensitive << clk_i.pos();
+    dont_initialize();
+}
+
+void dram_latency_buffer::start_of_simulation() {
+    std::array<unsigned, FIELD_CNT> sizes{
+        {rows_per_bank.get_value(), banks_per_channel.get_value(), channels.get_value(), row_size_in_bytes.get_value()}};
+    for(auto size : sizes)
+        if(!is_power_of_2(size))
+            SCCFATAL(SCMOD) << "channels, banks_per_channel, rows_per_bank and row_size_in_bytes need to be powers of 2";
+    if(!bytes_per_cycle.get_value())
+        SCCFATAL(SCMOD) << "bytes_per_cycle needs to be larger than 0";
+    auto const& mapping = address_mapping.get_value();
+    if(mapping.size() != 2 * FIELD_CNT)
+        SCCFATAL(SCMOD) << "illegal address mapping '" << mapping << "'";
+    std::array<bool, FIELD_CNT> seen{{false, false, false, false}};
+    auto shift = 0U;
+    // the mapping is given from MSB to LSB so we start at the end
+    for(unsigned i = FIELD_CNT; i > 0; --i) {
+        auto token = mapping.substr(2 * (i - 1), 2);
+        field_e f{ROW};
+        if(token == "Ro")
+            f = ROW;
+        else if(token == "Ba")
+            f = BANK;
+        else if(token == "Ch")
+            f = CHANNEL;
+        else if(token == "Co")
+            f = COLUMN;
+        else
+            SCCFATAL(SCMOD) << "illegal field '" << token << "' in address mapping '" << mapping << "'";
+        if(seen[f])
+            SCCFATAL(SCMOD) << "field '" << token << "' is used twice in address mapping '" << mapping << "'";
+        seen[f] = true;
+        fields[f].shift = shift;
+        fields[f].mask = sizes[f] - 1;
+        shift += ilog2(sizes[f]);
+    }
+    bank_states.resize(channels.get_value() * banks_per_channel.get_value());
+    data_bus_free_cycle.resize(channels.get_value(), 0);
+    pending.resize(channels.get_value());
+}
+
+void dram_latency_buffer::transport(tlm::tlm_generic_payload& payload, bool lt_transport) {
+    auto cmd = payload.get_command();
+    if(cmd != tlm::TLM_READ_COMMAND && cmd != tlm::TLM_WRITE_COMMAND) {
+        SCCERR(SCMOD) << "Transaction " << payload << " is neither a read nor a write";
+        return;
+    }
+    auto addr = payload.get_address();
+    auto* access = new dram_access(payload);
+    access->channel = (addr >> fields[CHANNEL].shift) & fields[CHANNEL].mask;
+    access->bank = (addr >> fields[BANK].shift) & fields[BANK].mask;
+    access->row = (addr >> fields[ROW].shift) & fields[ROW].mask;
+    pending[access->channel].push_back(access);
+    resp_order[cmd][axi::get_axi_id(payload)].emplace_back(access);
+}
+
+void dram_latency_buffer::clock_cb() {
+    ++cycle;
+    for(auto ch = 0U; ch < pending.size(); ++ch)
+        schedule_channel(ch);
+    send_responses();
+}
+
+void dram_latency_buffer::schedule_channel(unsigned channel) {
+    auto& queue = pending[channel];
+    if(queue.empty())
+        return;
+    // first ready: the oldest access hitting an open row
+    auto it = std::find_if(std::begin(queue), std::end(queue), [this](dram_access const* a) {
+        auto& bank = get_bank(*a);
+        return bank.open_row == static_cast<int64_t>(a->row) && bank.ready_cycle <= cycle;
+    });
+    // first come first serve: the oldest access whose bank can be (pre-charged and) activated
+    if(it == std::end(queue))
+        it = std::find_if(std::begin(queue), std::end(queue), [this](dram_access const* a) {
+            auto& bank = get_bank(*a);
+            return bank.ready_cycle <= cycle && bank.data_end_cycle <= cycle;
+        });
+    if(it != std::end(queue)) {
+        issue(**it);
+        queue.erase(it);
+    }
+}
+
+void dram_latency_buffer::issue(dram_access& access) {
+    auto& bank = get_bank(access);
+    auto act_cycles = 0U;
+    if(bank.open_row == static_cast<int64_t>(access.row)) {
+        row_hits++;
+    } else if(bank.open_row < 0) {
+        act_cycles = t_rcd.get_value();
+        row_misses++;
+    } else {
+        act_cycles = t_rp.get_value() + t_rcd.get_value();
+        row_conflicts++;
+    }
+    bank.open_row = access.row;
+    auto len = access.trans->get_data_length();
+    auto bpc = bytes_per_cycle.get_value();
+    auto burst_cycles = std::max(1U, (len + bpc - 1) / bpc);
+    auto& bus_free = data_bus_free_cycle[access.channel];
+    auto data_start = std::max<uint64_t>(cycle + act_cycles + t_cl.get_value(), bus_free);
+    bus_free = data_start + burst_cycles;
+    bank.ready_cycle = cycle + act_cycles + 1;
+    bank.data_end_cycle = bus_free;
+    access.done_cycle = bus_free;
+    SCCTRACE(SCMOD) << "issued access to channel " << access.channel << ", bank " << access.bank << ", row " << access.row
+                    << " finishing in cycle " << access.done_cycle << " for trans " << *access.trans;
+}
+
+void dram_latency_buffer::send_responses() {
+    for(auto& id_queues : resp_order)
+        for(auto& e : id_queues) {
+            auto& deq = e.second;
+            while(deq.size() && deq.front()->done_cycle <= cycle) {
+                if(bw_o->transport(*deq.front()->trans) != 0)
+                    break;
+                deq.pop_front();
+            }
+        }
+}
+
+} // namespace pe
+} // namespace axi
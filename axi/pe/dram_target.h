@@ -0,0 +1,185 @@
+/*
+ * Copyright 2020-2022 Arteris IP
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "target_info_if.h"
+#include <axi/pe/axi_target_pe.h>
+#include <cci_configuration>
+#include <deque>
+#include <limits>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+//! TLM2.0 components modeling AXI/ACE
+namespace axi {
+//! protocol engine implementations
+namespace pe {
+/**
+ * @brief a plug-in for the fw_o/bw_i chain of axi_target_pe modeling the latency of a DRAM
+ *
+ * The model consists of a number of channels each having a number of banks with a row buffer. Rows are kept open after
+ * an access (open-page policy). Per channel a FR-FCFS scheduler issues one access per clock cycle selecting the oldest
+ * row hit and, if there is none, the oldest access to a bank being ready. Responses of the same AXI ID are returned
+ * in the order the requests arrived. All timings are given in clock cycles of clk_i.
+ */
+class dram_latency_buffer : public sc_core::sc_module, tlm::scc::pe::intor_fw_nb {
+public:
+    sc_core::sc_in<bool> clk_i{"clk_i"};
+
+    sc_core::sc_export<tlm::scc::pe::intor_fw_nb> fw_i{"fw_i"};
+
+    sc_core::sc_port<tlm::scc::pe::intor_bw_nb, 1, sc_core::SC_ZERO_OR_MORE_BOUND> bw_o{"bw_o"};
+    //! the number of independent channels, needs to be a power of 2
+    cci::cci_param<unsigned> channels{"channels", 1};
+    //! the number of banks per channel, needs to be a power of 2
+    cci::cci_param<unsigned> banks_per_channel{"banks_per_channel", 8};
+    //! the number of rows per bank, needs to be a power of 2
+    cci::cci_param<unsigned> rows_per_bank{"rows_per_bank", 65536};
+    //! the size of a row (page) in bytes, needs to be a power of 2
+    cci::cci_param<unsigned> row_size_in_bytes{"row_size_in_bytes", 2048};
+    //! the number of bytes a channel transfers per clock cycle
+    cci::cci_param<unsigned> bytes_per_cycle{"bytes_per_cycle", 16};
+    /**
+     * @brief the mapping of the address bits, from MSB to LSB. Each field is denoted by 2 characters: Ro (row), Ba
+     * (bank), Ch (channel) and Co (column). Each field needs to be given exactly once.
+     */
+    cci::cci_param<std::string> address_mapping{"address_mapping", "RoBaChCo"};
+    //! the activate to read/write delay (RAS to CAS)
+    cci::cci_param<unsigned> t_rcd{"t_rcd", 14};
+    //! the CAS latency
+    cci::cci_param<unsigned> t_cl{"t_cl", 14};
+    //! the precharge delay
+    cci::cci_param<unsigned> t_rp{"t_rp", 14};
+
+    dram_latency_buffer(const sc_core::sc_module_name& nm);
+
+    virtual ~dram_latency_buffer() = default;
+    /**
+     * execute the transport of the payload. Independent of the underlying layer this function is blocking
+     *
+     * @param payload object with (optional) extensions
+     * @param lt_transport use b_transport instead of nb_transport*
+     */
+    void transport(tlm::tlm_generic_payload& payload, bool lt_transport = false) override;
+    /**
+     * send a response to a backward transaction if not immediately answered
+     *
+     * @param payload object with (optional) extensions
+     * @param sync if true send with next rising clock edge of the pe otherwise send it immediately
+     */
+    void snoop_resp(tlm::tlm_generic_payload& payload, bool sync = false) override {}
+
+protected:
+    struct dram_access {
+        tlm::scc::tlm_gp_shared_ptr trans;
+        unsigned channel{0};
+        unsigned bank{0};
+        uint64_t row{0};
+        uint64_t done_cycle{std::numeric_limits<uint64_t>::max()};
+        dram_access(tlm::tlm_generic_payload& gp)
+        : trans(&gp) {}
+    };
+    struct bank_state {
+        int64_t open_row{-1};
+        uint64_t ready_cycle{0};
+        uint64_t data_end_cycle{0};
+    };
+    enum field_e { ROW, BANK, CHANNEL, COLUMN, FIELD_CNT };
+    struct field_desc {
+        unsigned shift{0};
+        uint64_t mask{0};
+    };
+
+    void start_of_simulation() override;
+    void clock_cb();
+    void schedule_channel(unsigned channel);
+    void issue(dram_access& access);
+    void send_responses();
+    bank_state& get_bank(dram_access const& access) { return bank_states[access.channel * banks_per_channel.get_value() + access.bank]; }
+
+    uint64_t cycle{0};
+    std::array<field_desc, FIELD_CNT> fields;
+    std::vector<bank_state> bank_states;
+    std::vector<uint64_t> data_bus_free_cycle;
+    //! the accesses waiting to be scheduled per channel in arrival order
+    std::vector<std::deque<dram_access*>> pending;
+    //! the accesses per command and AXI ID in arrival order, owns the accesses
+    std::array<std::unordered_map<unsigned, std::deque<std::unique_ptr<dram_access>>>, 2> resp_order;
+    scc::sc_variable<unsigned> row_hits{"RowHits", 0};
+    scc::sc_variable<unsigned> row_misses{"RowMisses", 0};
+    scc::sc_variable<unsigned> row_conflicts{"RowConflicts", 0};
+};
+/**
+ * the AXI target using a DRAM latency model to determine the response latency
+ */
+template <unsigned int BUSWIDTH = 32, typename TYPES = axi::axi_protocol_types, int N = 1,
+          sc_core::sc_port_policy POL = sc_core::SC_ONE_OR_MORE_BOUND>
+class dram_target : public sc_core::sc_module, public target_perf_if {
+public:
+    using base = axi_target_pe;
+    using payload_type = base::payload_type;
+    using phase_type = base::phase_type;
+
+    sc_core::sc_in<bool> clk_i{"clk_i"};
+
+    axi::axi_target_socket<BUSWIDTH, TYPES, N, POL> sckt{"sckt"};
+
+    /**
+     * @brief the constructor
+     * @param nm module instance name
+     */
+    dram_target(const sc_core::sc_module_name& nm)
+    : sc_core::sc_module(nm)
+    , pe("pe", BUSWIDTH) {
+        sckt(pe);
+        pe.clk_i(clk_i);
+        dram.clk_i(clk_i);
+        pe.fw_o(dram.fw_i);
+        dram.bw_o(pe.bw_i);
+    }
+
+    dram_target() = delete;
+
+    dram_target(dram_target const&) = delete;
+
+    dram_target(dram_target&&) = delete;
+
+    dram_target& operator=(dram_target const&) = delete;
+
+    dram_target& operator=(dram_target&&) = delete;
+
+    size_t get_outstanding_tx_count() override { return pe.getAllOutStandingTx(); }
+
+    target_perf_counters get_perf_counters() override { return pe.get_perf_counters(); }
+
+    void reset_perf_counters() override { pe.reset_perf_counters(); }
+
+protected:
+    void end_of_elaboration() override {
+        auto* ifs = sckt.get_base_port().get_interface(0);
+        sc_assert(ifs != nullptr);
+        pe.set_bw_interface(ifs);
+    }
+
+public:
+    axi_target_pe pe;
+    dram_latency_buffer dram{"dram"};
+};
+} // namespace pe
+} // namespace axi
@@ -73,7 +73,7 @@ protected:
  */
 template <unsigned int BUSWIDTH = 32, typename TYPES = axi::axi_protocol_types, int N = 1,
           sc_core::sc_port_policy POL = sc_core::SC_ONE_OR_MORE_BOUND>
-class reordering_target : public sc_core::sc_module, public target_info_if {
+class reordering_target : public sc_core::sc_module, public target_perf_if {
 public:
     using base = axi_target_pe;
     using payload_type = base::payload_type;
@@ -110,6 +110,10 @@ public:
 
     size_t get_outstanding_tx_count() override { return pe.getAllOutStandingTx(); }
 
+    target_perf_counters get_perf_counters() override { return pe.get_perf_counters(); }
+
+    void reset_perf_counters() override { pe.reset_perf_counters(); }
+
 protected:
     void end_of_elaboration() override {
         auto* ifs = sckt.get_base_port().get_interface(0);
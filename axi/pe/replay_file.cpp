@@ -0,0 +1,185 @@
+/*
+ * Copyright 2020-2022 Arteris IP
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "replay_file.h"
+#include <cstdlib>
+#include <cstring>
+
+namespace axi {
+namespace pe {
+namespace {
+const size_t FILE_BUFFER_SIZE = 1 << 20;
+} // namespace
+
+replay_reader::replay_reader()
+: buffer(FILE_BUFFER_SIZE) {}
+
+bool replay_reader::open(std::string const& name) {
+    ifs.rdbuf()->pubsetbuf(buffer.data(), buffer.size());
+    ifs.open(name, std::ios::in | std::ios::binary);
+    if(!ifs.is_open())
+        return false;
+    char magic[sizeof(REPLAY_BINARY_MAGIC)];
+    if(ifs.read(magic, sizeof(magic)) && !std::memcmp(magic, REPLAY_BINARY_MAGIC, sizeof(magic))) {
+        binary = true;
+    } else {
+        // CSV: rewind and skip the header line
+        ifs.clear();
+        ifs.seekg(0);
+        std::getline(ifs, line);
+    }
+    return true;
+}
+
+bool replay_reader::read(replay_entry& e) {
+    if(binary) {
+        replay_record rec;
+        if(!ifs.read(reinterpret_cast<char*>(&rec), sizeof(rec)))
+            return false;
+        e.cmd = rec.cmd == tlm::TLM_READ_COMMAND    ? tlm::TLM_READ_COMMAND
+                : rec.cmd == tlm::TLM_WRITE_COMMAND ? tlm::TLM_WRITE_COMMAND
+                                                    : tlm::TLM_IGNORE_COMMAND;
+        e.addr = rec.addr;
+        e.id = rec.any_id ? REPLAY_ANY_ID : rec.id;
+        e.start_cycle = rec.start_cycle;
+        e.latency = rec.latency;
+        return true;
+    }
+    if(!std::getline(ifs, line))
+        return false;
+    e.cmd = tlm::TLM_IGNORE_COMMAND;
+    auto* p = line.c_str();
+    auto* sep = std::strchr(p, ',');
+    if(!sep)
+        return true;
+    auto cmd_len = sep - p;
+    if(cmd_len == 4 && !std::strncmp(p, "READ", 4))
+        e.cmd = tlm::TLM_READ_COMMAND;
+    else if(cmd_len == 5 && !std::strncmp(p, "WRITE", 5))
+        e.cmd = tlm::TLM_WRITE_COMMAND;
+    else
+        return true;
+    char* end;
+    e.addr = strtoull(sep + 1, &end, 10);
+    p = end + (*end == ',');
+    if(*p == '*') {
+        e.id = REPLAY_ANY_ID;
+        p = std::strchr(p, ',');
+        p = p ? p + 1 : "";
+    } else {
+        e.id = strtoul(p, &end, 10);
+        p = end + (*end == ',');
+    }
+    e.start_cycle = strtoull(p, &end, 10);
+    p = end + (*end == ',');
+    e.latency = strtoul(p, &end, 10);
+    return true;
+}
+
+replay_writer::replay_writer(size_t chunk_size)
+: chunk_size(chunk_size ? chunk_size : 1)
+, buffer(FILE_BUFFER_SIZE) {
+    chunk.reserve(this->chunk_size);
+}
+
+replay_writer::~replay_writer() { close(); }
+
+bool replay_writer::open(std::string const& name, bool binary) {
+    this->binary = binary;
+    ofs.rdbuf()->pubsetbuf(buffer.data(), buffer.size());
+    ofs.open(name, std::ios::out | std::ios::binary | std::ios::trunc);
+    if(!ofs.is_open())
+        return false;
+    if(binary)
+        ofs.write(REPLAY_BINARY_MAGIC, sizeof(REPLAY_BINARY_MAGIC));
+    else
+        ofs << "cmd,addr,id,start_cycle,latency\n";
+    stop = false;
+    writer_thread = std::thread([this]() { writer_loop(); });
+    return true;
+}
+
+void replay_writer::write(replay_entry const& e) {
+    chunk.push_back(e);
+    if(chunk.size() >= chunk_size) {
+        std::vector<replay_entry> next;
+        next.reserve(chunk_size);
+        std::swap(next, chunk);
+        {
+            std::lock_guard<std::mutex> lock(queue_mtx);
+            write_queue.emplace_back(std::move(next));
+        }
+        queue_cv.notify_one();
+    }
+}
+
+void replay_writer::close() {
+    if(!writer_thread.joinable())
+        return;
+    {
+        std::lock_guard<std::mutex> lock(queue_mtx);
+        if(chunk.size())
+            write_queue.emplace_back(std::move(chunk));
+        chunk.clear();
+        stop = true;
+    }
+    queue_cv.notify_one();
+    writer_thread.join();
+    ofs.close();
+}
+
+void replay_writer::writer_loop() {
+    std::unique_lock<std::mutex> lock(queue_mtx);
+    while(true) {
+        queue_cv.wait(lock, [this]() { return stop || !write_queue.empty(); });
+        while(!write_queue.empty()) {
+            auto next = std::move(write_queue.front());
+            write_queue.pop_front();
+            lock.unlock();
+            write_chunk(next);
+            lock.lock();
+        }
+        if(stop)
+            break;
+    }
+}
+
+void replay_writer::write_chunk(std::vector<replay_entry> const& entries) {
+    if(binary) {
+        for(auto const& e : entries) {
+            replay_record rec{};
+            rec.cmd = e.cmd;
+            rec.any_id = e.id == REPLAY_ANY_ID;
+            rec.id = e.id;
+            rec.addr = e.addr;
+            rec.start_cycle = e.start_cycle;
+            rec.latency = e.latency;
+            ofs.write(reinterpret_cast<char const*>(&rec), sizeof(rec));
+        }
+    } else {
+        for(auto const& e : entries) {
+            ofs << (e.cmd == tlm::TLM_WRITE_COMMAND ? "WRITE," : "READ,") << e.addr << ',';
+            if(e.id == REPLAY_ANY_ID)
+                ofs << '*';
+            else
+                ofs << e.id;
+            ofs << ',' << e.start_cycle << ',' << e.latency << '\n';
+        }
+    }
+}
+
+} // namespace pe
+} // namespace axi
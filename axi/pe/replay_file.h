@@ -0,0 +1,141 @@
+/*
+ * Copyright 2020-2022 Arteris IP
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <limits>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <tlm>
+#include <vector>
+
+//! TLM2.0 components modeling AXI/ACE
+namespace axi {
+//! protocol engine implementations
+namespace pe {
+//! the ID of a replay entry matching any AXI ID ('*' in the CSV format)
+constexpr unsigned REPLAY_ANY_ID = std::numeric_limits<unsigned>::max();
+/**
+ * @brief a single entry of a replay file
+ *
+ * The CSV format has a header line followed by lines of 'READ|WRITE,addr,id,start_cycle,latency' where id may be
+ * '*' to match any AXI ID. The binary format starts with the 8 byte magic REPLAY_BINARY_MAGIC followed by
+ * replay_record structures in host byte order.
+ */
+struct replay_entry {
+    tlm::tlm_command cmd{tlm::TLM_IGNORE_COMMAND};
+    uint64_t addr{0};
+    unsigned id{REPLAY_ANY_ID};
+    uint64_t start_cycle{0};
+    unsigned latency{0};
+};
+//! the magic identifying the binary replay format
+constexpr char REPLAY_BINARY_MAGIC[8] = {'A', 'X', 'I', 'R', 'P', 'L', 'Y', '1'};
+//! the record of the binary replay format
+struct replay_record {
+    uint8_t cmd;
+    uint8_t any_id;
+    uint16_t reserved0;
+    uint32_t id;
+    uint64_t addr;
+    uint64_t start_cycle;
+    uint32_t latency;
+    uint32_t reserved1;
+};
+static_assert(sizeof(replay_record) == 32, "unexpected size of replay_record");
+/**
+ * @brief a sequential reader for replay files in CSV or binary format. The format is detected automatically.
+ */
+class replay_reader {
+public:
+    replay_reader();
+    /**
+     * @brief open a replay file
+     * @param name the file name
+     * @return true if the file could be opened
+     */
+    bool open(std::string const& name);
+
+    bool is_open() const { return ifs.is_open(); }
+
+    bool is_binary() const { return binary; }
+    /**
+     * @brief read the next entry
+     * @param e the entry to fill
+     * @return false if the end of the file is reached. If the entry could not be parsed e.cmd is TLM_IGNORE_COMMAND
+     */
+    bool read(replay_entry& e);
+    //! the last line read from a CSV file (for diagnostics)
+    std::string const& get_line() const { return line; }
+
+private:
+    std::vector<char> buffer;
+    std::ifstream ifs;
+    std::string line;
+    bool binary{false};
+};
+
+/**
+ * @brief a writer for replay files in CSV or binary format. Entries are collected in chunks which are written by a
+ * background thread so that the simulation does not wait for the file I/O.
+ */
+class replay_writer {
+public:
+    /**
+     * @brief the constructor
+     * @param chunk_size the number of entries being handed over to the writer thread at once
+     */
+    explicit replay_writer(size_t chunk_size = 4096);
+
+    ~replay_writer();
+    /**
+     * @brief open a replay file and start the writer thread
+     * @param name the file name
+     * @param binary write the binary format instead of CSV
+     * @return true if the file could be opened
+     */
+    bool open(std::string const& name, bool binary = false);
+
+    bool is_open() const { return ofs.is_open(); }
+
+    void write(replay_entry const& e);
+    /**
+     * @brief write all pending entries, stop the writer thread and close the file
+     */
+    void close();
+
+private:
+    void writer_loop();
+    void write_chunk(std::vector<replay_entry> const& chunk);
+    size_t const chunk_size;
+    std::vector<char> buffer;
+    std::ofstream ofs;
+    bool binary{false};
+    std::vector<replay_entry> chunk;
+    std::deque<std::vector<replay_entry>> write_queue;
+    std::mutex queue_mtx;
+    std::condition_variable queue_cv;
+    bool stop{false};
+    std::thread writer_thread;
+};
+
+} // namespace pe
+} // namespace axi
@@ -3,8 +3,6 @@
 namespace axi {
 namespace pe {
 
-const unsigned int CATCH_ALL_SEQUENCE = 0;
-
 replay_buffer::replay_buffer(const sc_core::sc_module_name& nm)
 : sc_core::sc_module(nm) {
     fw_i.bind(*this);
@@ -22,83 +20,83 @@ void replay_buffer::end_of_elaboration() { clk_if = dynamic_cast<sc_core::sc_clo
 
 void replay_buffer::start_of_simulation() {
     if(replay_file_name.get_value().length()) {
-        std::ifstream ifs(replay_file_name.get_value());
-        if(ifs.is_open()) {
-            std::string line;
-            std::getline(ifs, line);
-            while(std::getline(ifs, line)) {
-                auto token = util::split(line, ',');
-                auto addr = strtoull(token[1].c_str(), nullptr, 10);
-                auto id = CATCH_ALL_SEQUENCE;
-                if (token[2].c_str()[0] != '*') {
-                    id = strtoull(token[2].c_str(), nullptr, 10) + 1;
-                }
-                auto start_cycle = strtoull(token[3].c_str(), nullptr, 10);
-                auto req_resp_lat = strtoull(token[4].c_str(), nullptr, 10);
-                if(token[0] == "READ") {
-                    if(id >= rd_sequence.size())
-                        rd_sequence.resize(id + 1);
-                    rd_sequence[id].emplace_back(addr, req_resp_lat);
-                } else if(token[0] == "WRITE") {
-                    if(id >= wr_sequence.size())
-                        wr_sequence.resize(id + 1);
-                    wr_sequence[id].emplace_back(addr, req_resp_lat);
-                } else {
-                    SCCWARN(SCMOD) << "Illegal command in replay file: " << line;
-                }
-            }
-        }
-        SCCINFO(SCMOD) << "SEQ file name of replay target = " << replay_file_name.get_value();
+        if(reader.open(replay_file_name.get_value())) {
+            next_entry_valid = reader.read(next_entry);
+            load_until(replay_lookahead_cycles.get_value());
+            SCCINFO(SCMOD) << "SEQ file name of replay target = " << replay_file_name.get_value()
+                           << (reader.is_binary() ? " (binary)" : " (CSV)");
+        } else
+            SCCERR(SCMOD) << "Could not open replay file " << replay_file_name.get_value();
     }
 }
 
-void replay_buffer::transport(tlm::tlm_generic_payload& trans, bool lt_transport) {
-    auto id = axi::get_axi_id(trans) + 1;
-    auto addr = trans.get_address();
-    auto cycle = clk_if ? sc_core::sc_time_stamp() / clk_if->period() : 0;
-
-    auto find_and_push = [&](std::vector<entry_t>& sequence, 
-                             scc::fifo_w_cb<std::tuple<tlm::tlm_generic_payload*, unsigned>>& fifo) {
-        auto it = std::find_if(std::begin(sequence), std::end(sequence),
-                                [addr](entry_t const& e) { return std::get<0>(e) == addr; });
-        if(it != std::end(sequence)) {
-            fifo.push_back(std::make_tuple(&trans, std::get<1>(*it)));
-            sequence.erase(it);
-            return true;
-        }
+uint64_t replay_buffer::get_replay_cycle() const {
+    auto cycle = clk_if ? static_cast<uint64_t>(sc_core::sc_time_stamp() / clk_if->period()) : 0;
+    return cycle > reset_end_cycle ? cycle - reset_end_cycle : 0;
+}
+
+bool replay_buffer::load_next_entry() {
+    if(!next_entry_valid)
         return false;
-    };
+    if(next_entry.cmd == tlm::TLM_READ_COMMAND || next_entry.cmd == tlm::TLM_WRITE_COMMAND) {
+        replay_index[next_entry.cmd][replay_key{next_entry.id, next_entry.addr}].push_back(next_entry.latency);
+        loaded_entries++;
+    } else
+        SCCWARN(SCMOD) << "Illegal command in replay file: " << reader.get_line();
+    next_entry_valid = reader.read(next_entry);
+    return true;
+}
 
-    if(trans.is_write()) {
-        if(id < wr_sequence.size() && wr_sequence[id].size()) {
-            if(find_and_push(wr_sequence[id], wr_req2resp_fifo)) {
-                return;
-            }
-        }
-        if(wr_sequence.size() && find_and_push(wr_sequence[CATCH_ALL_SEQUENCE], wr_req2resp_fifo)) {
-            return;
-        }
-        if(replay_file_name.get_value().length()) {
-            SCCWARN(SCMOD) << "No transaction in write sequence buffer for " << trans;
-        }
-        wr_req2resp_fifo.push_back(std::make_tuple(&trans, 0));
-    } else if(trans.is_read()) {
-        if(id < rd_sequence.size() && rd_sequence[id].size()) {
-            if(find_and_push(rd_sequence[id], rd_req2resp_fifo)) {
-                return;
-            }
+void replay_buffer::load_until(uint64_t cycle) {
+    while(next_entry_valid && next_entry.start_cycle <= cycle)
+        load_next_entry();
+}
+
+bool replay_buffer::lookup(tlm::tlm_command cmd, unsigned id, uint64_t addr, unsigned& latency) {
+    auto& index = replay_index[cmd];
+    for(auto key : {replay_key{id, addr}, replay_key{REPLAY_ANY_ID, addr}}) {
+        auto it = index.find(key);
+        if(it != index.end()) {
+            latency = it->second.front();
+            it->second.pop_front();
+            if(it->second.empty())
+                index.erase(it);
+            loaded_entries--;
+            return true;
         }
-        if(rd_sequence.size() && find_and_push(rd_sequence[CATCH_ALL_SEQUENCE], rd_req2resp_fifo)) {
+    }
+    return false;
+}
+
+void replay_buffer::transport(tlm::tlm_generic_payload& trans, bool lt_transport) {
+    if(!trans.is_write() && !trans.is_read())
+        return;
+    auto cmd = trans.get_command();
+    auto id = axi::get_axi_id(trans);
+    auto addr = trans.get_address();
+    auto& fifo = trans.is_write() ? wr_req2resp_fifo : rd_req2resp_fifo;
+    unsigned latency = 0;
+    if(lookup(cmd, id, addr, latency)) {
+        fifo.push_back(std::make_tuple(&trans, latency));
+        return;
+    }
+    // the transaction arrives earlier than recorded, read further ahead
+    while(loaded_entries < replay_max_read_ahead.get_value() && next_entry_valid) {
+        auto const match = next_entry.cmd == cmd && next_entry.addr == addr && (next_entry.id == id || next_entry.id == REPLAY_ANY_ID);
+        load_next_entry();
+        if(match && lookup(cmd, id, addr, latency)) {
+            fifo.push_back(std::make_tuple(&trans, latency));
             return;
         }
-        if(replay_file_name.get_value().length()) {
-            SCCWARN(SCMOD) << "No transaction in read sequence buffer for " << trans;
-        }
-        rd_req2resp_fifo.push_back(std::make_tuple(&trans, 0));
     }
+    if(replay_file_name.get_value().length()) {
+        SCCWARN(SCMOD) << "No transaction in " << (trans.is_write() ? "write" : "read") << " sequence buffer for " << trans;
+    }
+    fifo.push_back(std::make_tuple(&trans, 0));
 }
 
 void replay_buffer::process_req2resp_fifos() {
+    load_until(get_replay_cycle() + replay_lookahead_cycles.get_value());
     while(rd_req2resp_fifo.avail()) {
         auto& entry = rd_req2resp_fifo.front();
         if(std::get<1>(entry) == 0) {
@@ -178,5 +176,94 @@ void replay_buffer::start_wr_resp_thread() {
             }
     }
 }
+
+struct replay_capture_buffer::bw_intor_impl : public tlm::scc::pe::intor_bw_nb {
+    replay_capture_buffer* const that;
+    bw_intor_impl(replay_capture_buffer* that)
+    : that(that) {}
+    unsigned transport(tlm::tlm_generic_payload& payload) override { return that->response(payload); }
+};
+
+replay_capture_buffer::replay_capture_buffer(const sc_core::sc_module_name& nm)
+: sc_core::sc_module(nm)
+, bw_intor(new bw_intor_impl(this)) {
+    fw_i.bind(*this);
+    bw_i.bind(*bw_intor);
+#if SYSTEMC_VERSION < 20250221
+    SC_HAS_PROCESS(replay_capture_buffer);
+#endif
+    SC_METHOD(end_of_reset);
+    sensitive << rst_i.neg();
+}
+
+replay_capture_buffer::~replay_capture_buffer() = default;
+
+void replay_capture_buffer::end_of_elaboration() { clk_if = dynamic_cast<sc_core::sc_clock*>(clk_i.get_interface()); }
+
+void replay_capture_buffer::start_of_simulation() {
+    if(capture_file_name.get_value().length()) {
+        writer.reset(new replay_writer(capture_chunk_size.get_value()));
+        if(writer->open(capture_file_name.get_value(), capture_binary.get_value())) {
+            SCCINFO(SCMOD) << "capturing replay file " << capture_file_name.get_value();
+        } else {
+            SCCERR(SCMOD) << "Could not open capture file " << capture_file_name.get_value();
+            writer.reset();
+        }
+    }
+}
+
+void replay_capture_buffer::end_of_simulation() {
+    if(!writer)
+        return;
+    // transactions without a response are written with the latency seen so far
+    auto cycle = get_cycle();
+    for(auto& e : pending) {
+        auto& entry = std::get<0>(e);
+        if(!std::get<1>(e))
+            entry.latency = cycle - entry.start_cycle;
+        writer->write(entry);
+    }
+    pending.clear();
+    writer->close();
+}
+
+uint64_t replay_capture_buffer::get_cycle() const {
+    auto cycle = clk_if ? static_cast<uint64_t>(sc_core::sc_time_stamp() / clk_if->period()) : 0;
+    return cycle > reset_end_cycle ? cycle - reset_end_cycle : 0;
+}
+
+void replay_capture_buffer::transport(tlm::tlm_generic_payload& payload, bool lt_transport) {
+    if(writer && (payload.is_read() || payload.is_write())) {
+        replay_entry e;
+        e.cmd = payload.get_command();
+        e.addr = payload.get_address();
+        e.id = axi::get_axi_id(payload);
+        e.start_cycle = get_cycle();
+        seq_by_trans[&payload] = pending_base_seq + pending.size();
+        pending.emplace_back(e, false);
+    }
+    fw_o->transport(payload, lt_transport);
+}
+
+unsigned replay_capture_buffer::response(tlm::tlm_generic_payload& payload) {
+    auto ret = bw_o->transport(payload);
+    if(ret == 0 && writer) {
+        auto it = seq_by_trans.find(&payload);
+        if(it != seq_by_trans.end()) {
+            auto& e = pending[it->second - pending_base_seq];
+            std::get<0>(e).latency = get_cycle() - std::get<0>(e).start_cycle;
+            std::get<1>(e) = true;
+            seq_by_trans.erase(it);
+            // write the entries in request order so that replay_buffer can stream them
+            while(pending.size() && std::get<1>(pending.front())) {
+                writer->write(std::get<0>(pending.front()));
+                pending.pop_front();
+                pending_base_seq++;
+            }
+        }
+    }
+    return ret;
+}
+
 } // namespace pe
 } // namespace axi
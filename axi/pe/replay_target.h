@@ -16,9 +16,13 @@
 
 #pragma once
 
+#include "replay_file.h"
 #include "target_info_if.h"
 #include <axi/pe/axi_target_pe.h>
 #include <cci_configuration>
+#include <deque>
+#include <memory>
+#include <unordered_map>
 
 //! TLM2.0 components modeling AXI/ACE
 namespace axi {
@@ -32,7 +36,19 @@ public:
 
     sc_core::sc_port<tlm::scc::pe::intor_bw_nb, 1, sc_core::SC_ZERO_OR_MORE_BOUND> bw_o{"bw_o"};
 
+    /**
+     * @brief the replay file, either in CSV or binary format (see replay_entry)
+     */
     cci::cci_param<std::string> replay_file_name{"replay_file_name", ""};
+    /**
+     * @brief the number of clock cycles entries are read ahead of the current cycle based on their start_cycle
+     */
+    cci::cci_param<unsigned> replay_lookahead_cycles{"replay_lookahead_cycles", 10000};
+    /**
+     * @brief the maximum number of unconsumed entries being read ahead when searching for an entry of a transaction
+     * which is not yet loaded
+     */
+    cci::cci_param<unsigned> replay_max_read_ahead{"replay_max_read_ahead", 1 << 20};
 
     replay_buffer(const sc_core::sc_module_name& nm);
     /**
@@ -55,8 +71,24 @@ public:
 protected:
     sc_core::sc_clock* clk_if{nullptr};
     uint64_t reset_end_cycle{0};
-    using entry_t = std::tuple<uint64_t, unsigned>;
-    std::vector<std::vector<entry_t>> rd_sequence, wr_sequence;
+    struct replay_key {
+        unsigned id;
+        uint64_t addr;
+        bool operator==(replay_key const& o) const { return id == o.id && addr == o.addr; }
+    };
+    struct replay_key_hash {
+        size_t operator()(replay_key const& k) const { return std::hash<uint64_t>()(k.addr ^ (static_cast<uint64_t>(k.id) << 48)); }
+    };
+    //! the latencies of the loaded entries per command indexed by (ID, address) in file order
+    std::array<std::unordered_map<replay_key, std::deque<unsigned>, replay_key_hash>, 2> replay_index;
+    replay_reader reader;
+    replay_entry next_entry;
+    bool next_entry_valid{false};
+    size_t loaded_entries{0};
+    uint64_t get_replay_cycle() const;
+    bool load_next_entry();
+    void load_until(uint64_t cycle);
+    bool lookup(tlm::tlm_command cmd, unsigned id, uint64_t addr, unsigned& latency);
     sc_core::sc_time time_per_byte_rd, time_per_byte_wr, time_per_byte_total;
     //! queues realizing the latencies
     scc::fifo_w_cb<std::tuple<tlm::tlm_generic_payload*, unsigned>> rd_req2resp_fifo{"rd_req2resp_fifo"};
@@ -72,13 +104,91 @@ protected:
     void start_rd_resp_thread();
     void start_wr_resp_thread();
 };
+/**
+ * @brief a plug-in capturing the latencies of a live run into a replay file which can be used by replay_buffer
+ *
+ * The capture buffer is placed in front of the plug-in determining the latencies e.g.
+ * @code
+ * pe.fw_o(capture.fw_i);
+ * capture.fw_o(dram.fw_i);
+ * dram.bw_o(capture.bw_i);
+ * capture.bw_o(pe.bw_i);
+ * capture.rst_i(rst);
+ * @endcode
+ * The latency is the number of clock cycles between the forward transport and the accepted backward transport. Like in
+ * replay_buffer the start cycles count from the end of the reset. Entries are written in the order the requests
+ * arrived, the file I/O happens in a background thread.
+ */
+class replay_capture_buffer : public sc_core::sc_module, tlm::scc::pe::intor_fw_nb {
+    struct bw_intor_impl;
+
+public:
+    sc_core::sc_in<bool> clk_i{"clk_i"};
+
+    sc_core::sc_in<bool> rst_i{"rst_i"};
+
+    sc_core::sc_export<tlm::scc::pe::intor_fw_nb> fw_i{"fw_i"};
+
+    sc_core::sc_port<tlm::scc::pe::intor_bw_nb, 1, sc_core::SC_ZERO_OR_MORE_BOUND> bw_o{"bw_o"};
+
+    sc_core::sc_port<tlm::scc::pe::intor_fw_nb> fw_o{"fw_o"};
+
+    sc_core::sc_export<tlm::scc::pe::intor_bw_nb> bw_i{"bw_i"};
+    /**
+     * @brief the replay file to write, capturing is disabled if empty
+     */
+    cci::cci_param<std::string> capture_file_name{"capture_file_name", ""};
+    /**
+     * @brief write the binary replay format instead of CSV
+     */
+    cci::cci_param<bool> capture_binary{"capture_binary", false};
+    /**
+     * @brief the number of entries handed over to the writer thread at once
+     */
+    cci::cci_param<unsigned> capture_chunk_size{"capture_chunk_size", 4096};
+
+    replay_capture_buffer(const sc_core::sc_module_name& nm);
+
+    virtual ~replay_capture_buffer();
+    /**
+     * execute the transport of the payload. Independent of the underlying layer this function is blocking
+     *
+     * @param payload object with (optional) extensions
+     * @param lt_transport use b_transport instead of nb_transport*
+     */
+    void transport(tlm::tlm_generic_payload& payload, bool lt_transport = false) override;
+    /**
+     * send a response to a backward transaction if not immediately answered
+     *
+     * @param payload object with (optional) extensions
+     * @param sync if true send with next rising clock edge of the pe otherwise send it immediately
+     */
+    void snoop_resp(tlm::tlm_generic_payload& payload, bool sync = false) override { fw_o->snoop_resp(payload, sync); }
+
+    void end_of_reset() { reset_end_cycle = clk_if ? sc_core::sc_time_stamp() / clk_if->period() : 0; }
+
+protected:
+    sc_core::sc_clock* clk_if{nullptr};
+    uint64_t reset_end_cycle{0};
+    std::unique_ptr<bw_intor_impl> bw_intor;
+    std::unique_ptr<replay_writer> writer;
+    //! the captured entries in request order, the flag indicates that the response has been seen
+    std::deque<std::tuple<replay_entry, bool>> pending;
+    uint64_t pending_base_seq{0};
+    std::unordered_map<tlm::tlm_generic_payload*, uint64_t> seq_by_trans;
+    uint64_t get_cycle() const;
+    unsigned response(tlm::tlm_generic_payload& payload);
+    void end_of_elaboration() override;
+    void start_of_simulation() override;
+    void end_of_simulation() override;
+};
 /**
  * the target socket protocol engine(s) adapted to a particular target socket configuration,
  * sends responses in the order they arrived
  */
 template <unsigned int BUSWIDTH = 32, typename TYPES = axi::axi_protocol_types, int N = 1,
           sc_core::sc_port_policy POL = sc_core::SC_ONE_OR_MORE_BOUND>
-class replay_target : public sc_core::sc_module, public target_info_if {
+class replay_target : public sc_core::sc_module, public target_perf_if {
 public:
     using base = axi_target_pe;
     using payload_type = base::payload_type;
@@ -122,6 +232,10 @@ public:
 
     size_t get_outstanding_tx_count() override { return pe.getAllOutStandingTx(); }
 
+    target_perf_counters get_perf_counters() override { return pe.get_perf_counters(); }
+
+    void reset_perf_counters() override { pe.reset_perf_counters(); }
+
 protected:
     void end_of_reset() { repl_buffer.end_of_reset(); }
     void end_of_elaboration() {
@@ -0,0 +1,117 @@
+/*
+ * Copyright 2020-2022 Arteris IP
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+//! TLM2.0 components modeling AXI/ACE
+namespace axi {
+//! protocol engine implementations
+namespace pe {
+/**
+ * @brief a FIFO ring buffer which doubles its storage once it runs full.
+ *
+ * The buffer itself never rejects an element, limiting the number of entries (and hence applying back-pressure) is
+ * left to the owner using size().
+ */
+template <typename T> class ring_buffer {
+public:
+    /**
+     * @brief the constructor
+     * @param initial_capacity the number of entries to allocate upfront, will be rounded up to a power of 2
+     */
+    explicit ring_buffer(size_t initial_capacity = 16) {
+        size_t cap = 1;
+        while(cap < initial_capacity)
+            cap <<= 1;
+        buffer.resize(cap);
+    }
+
+    bool empty() const { return count == 0; }
+
+    size_t size() const { return count; }
+
+    size_t capacity() const { return buffer.size(); }
+
+    void push_back(T const& t) {
+        if(count == buffer.size())
+            grow();
+        buffer[(head + count) & (buffer.size() - 1)] = t;
+        ++count;
+    }
+
+    T& front() {
+        assert(count);
+        return buffer[head];
+    }
+
+    T const& front() const {
+        assert(count);
+        return buffer[head];
+    }
+
+    T& operator[](size_t idx) {
+        assert(idx < count);
+        return buffer[(head + idx) & (buffer.size() - 1)];
+    }
+
+    T const& operator[](size_t idx) const {
+        assert(idx < count);
+        return buffer[(head + idx) & (buffer.size() - 1)];
+    }
+
+    void pop_front() {
+        assert(count);
+        head = (head + 1) & (buffer.size() - 1);
+        --count;
+    }
+
+    /**
+     * @brief removes the element at position idx keeping the order of the remaining elements
+     * @param idx the position of the element relative to front()
+     */
+    void erase(size_t idx) {
+        assert(idx < count);
+        for(size_t i = idx; i > 0; --i)
+            (*this)[i] = std::move((*this)[i - 1]);
+        pop_front();
+    }
+
+    void clear() {
+        head = 0;
+        count = 0;
+    }
+
+private:
+    void grow() {
+        std::vector<T> new_buffer(buffer.size() * 2);
+        for(size_t i = 0; i < count; ++i)
+            new_buffer[i] = std::move(buffer[(head + i) & (buffer.size() - 1)]);
+        buffer.swap(new_buffer);
+        head = 0;
+    }
+
+    std::vector<T> buffer;
+    size_t head{0};
+    size_t count{0};
+};
+
+} // namespace pe
+} // namespace axi
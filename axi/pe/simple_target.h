@@ -30,7 +30,7 @@ namespace pe {
  */
 template <unsigned int BUSWIDTH = 32, typename TYPES = axi::axi_protocol_types, int N = 1,
           sc_core::sc_port_policy POL = sc_core::SC_ONE_OR_MORE_BOUND>
-class simple_target : public axi_target_pe, public target_info_if {
+class simple_target : public axi_target_pe, public target_perf_if {
 public:
     using base = axi_target_pe;
     using payload_type = base::payload_type;
@@ -64,6 +64,10 @@ public:
 
     size_t get_outstanding_tx_count() override { return getAllOutStandingTx(); }
 
+    target_perf_counters get_perf_counters() override { return axi_target_pe::get_perf_counters(); }
+
+    void reset_perf_counters() override { axi_target_pe::reset_perf_counters(); }
+
 protected:
     axi::axi_target_socket<BUSWIDTH, TYPES, N, POL>& socket;
 
@@ -9,6 +9,7 @@
 #define _AXI_PE_TARGET_INFO_IF_H_
 
 #include <cstddef>
+#include <cstdint>
 
 namespace axi {
 namespace pe {
@@ -19,6 +20,40 @@ public:
 
     virtual size_t get_outstanding_tx_count() = 0;
 };
+/**
+ * the performance counters of a target accumulated since the start of simulation or the last reset. All times are
+ * given in clock cycles of the target
+ */
+struct target_perf_counters {
+    //! the length of the measurement window
+    uint64_t cycles{0};
+    uint64_t rd_bytes{0};
+    uint64_t wr_bytes{0};
+    uint64_t rd_transactions{0};
+    uint64_t wr_transactions{0};
+    //! the cycles requests were stalled because max_outstanding_tx was reached, summed over read and write
+    uint64_t stall_cycles{0};
+    //! the time weighted average number of outstanding transactions
+    double avg_occupancy{0.0};
+    //! the maximum number of outstanding transactions
+    unsigned peak_occupancy{0};
+    //! the latency from the start of the request until the end of the response
+    double latency_mean{0.0};
+    uint64_t latency_p50{0};
+    uint64_t latency_p90{0};
+    uint64_t latency_p99{0};
+    uint64_t latency_max{0};
+};
+/**
+ * the extended query interface of a target providing performance counters which can be reset at runtime to measure
+ * defined windows
+ */
+class target_perf_if : public target_info_if {
+public:
+    virtual target_perf_counters get_perf_counters() = 0;
+
+    virtual void reset_perf_counters() = 0;
+};
 
 } /* namespace pe */
 } /* namespace axi */
@@ -0,0 +1,126 @@
+/*
+ * Copyright 2020-2022 Arteris IP
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "target_info_if.h"
+#include <algorithm>
+#include <array>
+#include <stats/log_histogram.h>
+
+//! TLM2.0 components modeling AXI/ACE
+namespace axi {
+//! protocol engine implementations
+namespace pe {
+/**
+ * @brief accumulates the target_perf_counters of a target
+ *
+ * The owner reports changes of the number of outstanding transactions, the begin and end of stalls and finished
+ * transactions, each with the current clock cycle. All updates are O(1).
+ */
+class target_perf_monitor {
+public:
+    /**
+     * @brief start a new measurement window
+     * @param cycle the current clock cycle
+     * @param occupancy the current number of outstanding transactions
+     */
+    void reset(uint64_t cycle, unsigned occupancy) {
+        counters = target_perf_counters();
+        latency = stats::log_histogram();
+        start_cycle = last_cycle = cycle;
+        occupancy_area = 0;
+        current_occupancy = occupancy;
+        counters.peak_occupancy = occupancy;
+        for(auto& s : stall_start)
+            if(s != NO_STALL)
+                s = cycle;
+    }
+
+    void occupancy_changed(uint64_t cycle, unsigned occupancy) {
+        advance(cycle);
+        current_occupancy = occupancy;
+        counters.peak_occupancy = std::max(counters.peak_occupancy, occupancy);
+    }
+    /**
+     * @param channel 0 for read, 1 for write
+     */
+    void stall_begin(unsigned channel, uint64_t cycle) {
+        if(stall_start[channel] == NO_STALL)
+            stall_start[channel] = cycle;
+    }
+
+    void stall_end(unsigned channel, uint64_t cycle) {
+        if(stall_start[channel] != NO_STALL) {
+            counters.stall_cycles += cycle - stall_start[channel];
+            stall_start[channel] = NO_STALL;
+        }
+    }
+    /**
+     * @param write true for a write transaction
+     * @param bytes the number of bytes transferred
+     * @param latency_cycles the latency of the transaction in clock cycles
+     */
+    void finished(bool write, uint64_t bytes, uint64_t latency_cycles) {
+        if(write) {
+            counters.wr_bytes += bytes;
+            counters.wr_transactions++;
+        } else {
+            counters.rd_bytes += bytes;
+            counters.rd_transactions++;
+        }
+        latency.add(latency_cycles);
+    }
+    /**
+     * @brief the counters of the current measurement window
+     * @param cycle the current clock cycle
+     */
+    target_perf_counters get(uint64_t cycle) {
+        advance(cycle);
+        auto res = counters;
+        res.cycles = cycle - start_cycle;
+        for(auto s : stall_start)
+            if(s != NO_STALL)
+                res.stall_cycles += cycle - s;
+        res.avg_occupancy = res.cycles ? static_cast<double>(occupancy_area) / res.cycles : current_occupancy;
+        res.latency_mean = latency.get_mean();
+        res.latency_p50 = latency.get_percentile(50);
+        res.latency_p90 = latency.get_percentile(90);
+        res.latency_p99 = latency.get_percentile(99);
+        res.latency_max = latency.get_max();
+        return res;
+    }
+
+private:
+    static constexpr uint64_t NO_STALL = static_cast<uint64_t>(-1);
+
+    void advance(uint64_t cycle) {
+        if(cycle > last_cycle) {
+            occupancy_area += (cycle - last_cycle) * current_occupancy;
+            last_cycle = cycle;
+        }
+    }
+
+    target_perf_counters counters;
+    stats::log_histogram latency;
+    uint64_t start_cycle{0}, last_cycle{0};
+    uint64_t occupancy_area{0};
+    unsigned current_occupancy{0};
+    std::array<uint64_t, 2> stall_start{{NO_STALL, NO_STALL}};
+};
+
+} // namespace pe
+} // namespace axi
@@ -0,0 +1,135 @@
+/*
+ * Copyright 2020-2022 Arteris IP
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "trace_player.h"
+#include <scc/report.h>
+#include <tlm/scc/tlm_mm.h>
+
+namespace axi {
+namespace pe {
+trace_player::trace_player(const sc_core::sc_module_name& nm)
+: sc_core::sc_module(nm) {
+#if SYSTEMC_VERSION < 20250221
+    SC_HAS_PROCESS(trace_player);
+#endif
+    SC_THREAD(issue_thread);
+}
+
+trace_player::~trace_player() = default;
+
+void trace_player::end_of_elaboration() { clk_if = dynamic_cast<sc_core::sc_clock*>(clk_i.get_interface()); }
+
+void trace_player::start_of_simulation() {
+    if(!trace_file_name.get_value().length())
+        return;
+    axi::trace_reader reader;
+    if(!reader.open(trace_file_name.get_value()) || !reader.read_stimulus(trace)) {
+        SCCERR(SCMOD) << "Could not open trace file " << trace_file_name.get_value() << " or it is not a stimulus trace";
+        trace.clear();
+        return;
+    }
+    finished.resize(trace.size(), false);
+    for(auto i = 0U; i < std::max(1U, max_outstanding.get_value()); ++i)
+        sc_core::sc_spawn([this]() { worker_thread(); }, sc_core::sc_gen_unique_name("worker"));
+    SCCINFO(SCMOD) << "replaying " << trace.size() << " transactions from " << trace_file_name.get_value();
+}
+
+tlm::scc::tlm_gp_shared_ptr trace_player::create_payload(stimulus_record const& rec) {
+    auto len = (rec.length + 1U) << rec.size;
+    tlm::scc::tlm_gp_shared_ptr trans;
+    axi::request* req{nullptr};
+    axi::common* cmn{nullptr};
+    if(rec.flags & STIMULUS_ACE) {
+        auto* gp = tlm::scc::tlm_mm<>::get().allocate<axi::ace_extension>(len);
+        auto* ext = gp->get_extension<axi::ace_extension>();
+        ext->set_domain(axi::into<axi::domain_e>(rec.domain));
+        ext->set_snoop(axi::into<axi::snoop_e>(rec.snoop));
+        ext->set_barrier(axi::into<axi::bar_e>(rec.barrier));
+        ext->set_unique(rec.flags & STIMULUS_UNIQUE);
+        ext->set_exclusive(rec.flags & STIMULUS_EXCLUSIVE);
+        req = ext;
+        cmn = ext;
+        trans = gp;
+    } else {
+        auto* gp = tlm::scc::tlm_mm<>::get().allocate<axi::axi4_extension>(len);
+        auto* ext = gp->get_extension<axi::axi4_extension>();
+        ext->set_exclusive(rec.flags & STIMULUS_EXCLUSIVE);
+        req = ext;
+        cmn = ext;
+        trans = gp;
+    }
+    trans->set_command(rec.cmd ? tlm::TLM_WRITE_COMMAND : tlm::TLM_READ_COMMAND);
+    trans->set_address(rec.addr);
+    trans->set_data_length(len);
+    trans->set_streaming_width(len);
+    cmn->set_id(rec.id);
+    req->set_length(rec.length);
+    req->set_size(rec.size);
+    req->set_burst(axi::into<axi::burst_e>(rec.burst));
+    req->set_cache(rec.cache);
+    req->set_prot(rec.prot);
+    req->set_qos(rec.qos);
+    req->set_region(rec.region);
+    return trans;
+}
+
+void trace_player::issue_thread() {
+    wait(sc_core::SC_ZERO_TIME);
+    if(trace.empty())
+        return;
+    auto const start_time = sc_core::sc_time_stamp();
+    auto const count = trace.size();
+    for(uint64_t idx = 0; idx < count; ++idx) {
+        auto const& rec = trace[idx];
+        if(preserve_timing.get_value() && clk_if) {
+            auto issue_time = start_time + clk_if->period() * static_cast<double>(rec.issue_cycle);
+            if(issue_time > sc_core::sc_time_stamp())
+                wait(issue_time - sc_core::sc_time_stamp());
+        }
+        if(rec.depends_on) {
+            if(rec.depends_on > idx) {
+                SCCWARN(SCMOD) << "trace record " << idx << " depends on a later record, ignoring dependency";
+            } else
+                while(!finished[rec.depends_on - 1])
+                    wait(tx_finished_evt);
+        }
+        while(outstanding.get() >= std::max(1U, max_outstanding.get_value()))
+            wait(tx_finished_evt);
+        outstanding++;
+        issued_cnt++;
+        dispatch_queue.write(idx);
+    }
+}
+
+void trace_player::worker_thread() {
+    while(true) {
+        auto idx = dispatch_queue.read();
+        auto trans = create_payload(trace[idx]);
+        SCCTRACE(SCMOD) << "issuing trace record " << idx << ": " << *trans;
+        fw_o->transport(*trans, false);
+        finished[idx] = true;
+        outstanding--;
+        finished_cnt++;
+        tx_finished_evt.notify(sc_core::SC_ZERO_TIME);
+        if(finished_cnt == trace.size()) {
+            SCCINFO(SCMOD) << "finished replaying " << finished_cnt << " transactions";
+            finished_evt.notify(sc_core::SC_ZERO_TIME);
+        }
+    }
+}
+
+} // namespace pe
+} // namespace axi
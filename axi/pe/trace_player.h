@@ -0,0 +1,84 @@
+/*
+ * Copyright 2020-2022 Arteris IP
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#ifndef SC_INCLUDE_DYNAMIC_PROCESSES
+#define SC_INCLUDE_DYNAMIC_PROCESSES
+#endif
+
+#include <axi/axi_tlm.h>
+#include <axi/trace_file.h>
+#include <cci_configuration>
+#include <cstdint>
+#include <scc/sc_variable.h>
+#include <string>
+#include <systemc>
+#include <tlm/scc/pe/intor_if.h>
+#include <tlm/scc/tlm_gp_shared.h>
+#include <vector>
+
+//! TLM2.0 components modeling AXI/ACE
+namespace axi {
+//! protocol engine implementations
+namespace pe {
+/**
+ * @brief a stimulus source replaying a stimulus trace through an initiator protocol engine
+ *
+ * The player is bound to the fw_i of an initiator PE (e.g. axi_initiator_b or simple_initiator_b). The stimulus records
+ * are read from the STIMULUS blocks of a trace file (see axi::write_stimulus()) and transactions are issued at their
+ * cycle, after the transaction they depend on has finished and as long as less than max_outstanding transactions are
+ * in flight.
+ */
+class trace_player : public sc_core::sc_module {
+public:
+    sc_core::sc_in<bool> clk_i{"clk_i"};
+
+    sc_core::sc_port<tlm::scc::pe::intor_fw_b> fw_o{"fw_o"};
+    //! the trace file holding the stimulus to replay
+    cci::cci_param<std::string> trace_file_name{"trace_file_name", ""};
+    //! the maximum number of transactions in flight
+    cci::cci_param<unsigned> max_outstanding{"max_outstanding", 8};
+    //! issue transactions at their recorded cycle, otherwise issue them as fast as possible
+    cci::cci_param<bool> preserve_timing{"preserve_timing", true};
+
+    trace_player(const sc_core::sc_module_name& nm);
+
+    virtual ~trace_player();
+    /**
+     * get the event being notified once all transactions of the trace are finished
+     *
+     * @return reference to sc_event
+     */
+    const sc_core::sc_event& trace_finished_event() { return finished_evt; }
+
+protected:
+    void end_of_elaboration() override;
+    void start_of_simulation() override;
+    void issue_thread();
+    void worker_thread();
+    tlm::scc::tlm_gp_shared_ptr create_payload(stimulus_record const& rec);
+    sc_core::sc_clock* clk_if{nullptr};
+    std::vector<stimulus_record> trace;
+    std::vector<bool> finished;
+    sc_core::sc_fifo<uint64_t> dispatch_queue{"dispatch_queue"};
+    sc_core::sc_event tx_finished_evt, finished_evt;
+    scc::sc_variable<unsigned> outstanding{"Outstanding", 0};
+    uint64_t issued_cnt{0}, finished_cnt{0};
+};
+
+} // namespace pe
+} // namespace axi
@@ -0,0 +1,93 @@
+/*
+ * Copyright 2023 Arteris IP
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "recording_filter.h"
+#include <algorithm>
+#include <scc/report.h>
+#include <sstream>
+#include <stdexcept>
+
+namespace axi {
+namespace {
+bool parse_ranges(std::string const& str, std::vector<std::pair<uint64_t, uint64_t>>& ranges) {
+    std::istringstream is(str);
+    std::string token;
+    try {
+        while(std::getline(is, token, ',')) {
+            auto first = token.find_first_not_of(" \t");
+            if(first == std::string::npos)
+                continue;
+            auto pos = token.find('-');
+            auto start = std::stoull(token.substr(first, pos), nullptr, 0);
+            auto end = pos == std::string::npos ? start : std::stoull(token.substr(pos + 1), nullptr, 0);
+            if(end < start)
+                return false;
+            ranges.emplace_back(start, end);
+        }
+    } catch(std::logic_error&) {
+        return false;
+    }
+    return true;
+}
+
+inline bool in_ranges(std::vector<std::pair<uint64_t, uint64_t>> const& ranges, uint64_t val) {
+    if(ranges.empty())
+        return true;
+    for(auto& r : ranges)
+        if(val >= r.first && val <= r.second)
+            return true;
+    return false;
+}
+} // namespace
+
+void recording_filter::init() {
+    addr_ranges.clear();
+    id_ranges.clear();
+    decisions.clear();
+    if(!parse_ranges(recordAddressRanges.get_value(), addr_ranges)) {
+        SCCERR(name.c_str()) << "invalid address ranges '" << recordAddressRanges.get_value() << "', recording all addresses";
+        addr_ranges.clear();
+    }
+    if(!parse_ranges(recordIds.get_value(), id_ranges)) {
+        SCCERR(name.c_str()) << "invalid id list '" << recordIds.get_value() << "', recording all ids";
+        id_ranges.clear();
+    }
+    kinds[static_cast<unsigned>(tx_kind::READ)] = recordReads.get_value();
+    kinds[static_cast<unsigned>(tx_kind::WRITE)] = recordWrites.get_value();
+    kinds[static_cast<unsigned>(tx_kind::SNOOP)] = recordSnoops.get_value();
+    sampling_rate = std::max(1U, recordSamplingRate.get_value());
+    sample_cnt = 0;
+    start_time = recordStartTime.get_value();
+    stop_time = recordStopTime.get_value();
+    triggered = !recordOnTrigger.get_value();
+    undecided = false;
+    active = !addr_ranges.empty() || !id_ranges.empty() || !kinds[0] || !kinds[1] || !kinds[2] || sampling_rate > 1 ||
+             start_time > sc_core::SC_ZERO_TIME || stop_time > sc_core::SC_ZERO_TIME || !triggered;
+}
+
+bool recording_filter::decide(uint64_t addr, unsigned id, tx_kind kind) {
+    if(!triggered || !kinds[static_cast<unsigned>(kind)])
+        return false;
+    auto now = sc_core::sc_time_stamp();
+    if(now < start_time || (stop_time > sc_core::SC_ZERO_TIME && now >= stop_time))
+        return false;
+    if(!in_ranges(addr_ranges, addr) || !in_ranges(id_ranges, id))
+        return false;
+    if(sampling_rate > 1 && sample_cnt++ % sampling_rate)
+        return false;
+    return true;
+}
+} // namespace axi
@@ -0,0 +1,148 @@
+/*
+ * Copyright 2023 Arteris IP
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cci_configuration>
+#include <cstdint>
+#include <string>
+#include <systemc>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace axi {
+/**
+ * @brief the filter deciding which transactions a recorder records
+ *
+ * The decision is taken once at the begin of a transaction before any recording handle is created, all further phases
+ * of a non-blocking transaction follow this decision. If none of the criteria is configured the filter is inactive and
+ * all transactions are recorded. The parameters are created in the context of the owning recorder and read when the
+ * recorder initializes its streams.
+ */
+class recording_filter {
+public:
+    enum class tx_kind { READ, WRITE, SNOOP };
+    //! comma separated list of inclusive address ranges like "0x1000-0x1fff,0x8000", empty records all addresses
+    cci::cci_param<std::string> recordAddressRanges{"recordAddressRanges", ""};
+    //! comma separated list of AXI IDs resp. CHI TxnIDs or ranges thereof like "0,4-7", empty records all ids
+    cci::cci_param<std::string> recordIds{"recordIds", ""};
+    //! record read transactions
+    cci::cci_param<bool> recordReads{"recordReads", true};
+    //! record write transactions
+    cci::cci_param<bool> recordWrites{"recordWrites", true};
+    //! record snoop transactions
+    cci::cci_param<bool> recordSnoops{"recordSnoops", true};
+    //! record only every n-th of the transactions passing the other criteria
+    cci::cci_param<unsigned> recordSamplingRate{"recordSamplingRate", 1};
+    //! the simulation time to start recording
+    cci::cci_param<sc_core::sc_time> recordStartTime{"recordStartTime", sc_core::SC_ZERO_TIME};
+    //! the simulation time to stop recording, recording does not stop if zero
+    cci::cci_param<sc_core::sc_time> recordStopTime{"recordStopTime", sc_core::SC_ZERO_TIME};
+    //! start recording only after trigger(true) has been called
+    cci::cci_param<bool> recordOnTrigger{"recordOnTrigger", false};
+
+    recording_filter(std::string const& name)
+    : name(name) {}
+    /**
+     * @brief reads the parameters, needs to be called before the first transaction is filtered
+     */
+    void init();
+    /**
+     * @brief starts or stops the recording, e.g. from a process waiting on a trigger event
+     *
+     * Transactions in flight when an inactive filter is activated were recorded from their begin, so their remaining
+     * phases are recorded as well.
+     * @param record if true transactions starting from now on are recorded
+     */
+    void trigger(bool record) {
+        triggered = record;
+        if(!active)
+            undecided = true;
+        active = true;
+    }
+    //! \return true if the filter rejects transactions
+    inline bool is_active() const { return active; }
+    /**
+     * @brief decides if a (blocking) transaction is recorded
+     *
+     * @param addr the address of the transaction
+     * @param id the AXI ID or CHI TxnID of the transaction
+     * @param kind the type of the transaction
+     * @return true if the transaction is recorded
+     */
+    inline bool accept(uint64_t addr, unsigned id, tx_kind kind) { return !active || decide(addr, id, kind); }
+    /**
+     * @brief decides if a non-blocking transaction is recorded at a phase which always starts a transaction
+     *
+     * A decision kept for a previous transaction using the same payload is replaced.
+     * @param tx the identity of the transaction, usually the address of the payload
+     * @param addr the address of the transaction
+     * @param id the AXI ID or CHI TxnID of the transaction
+     * @param kind the type of the transaction
+     * @return true if the phase is recorded
+     */
+    inline bool start_nb(uintptr_t tx, uint64_t addr, unsigned id, tx_kind kind) {
+        return !active || (decisions[tx] = decide(addr, id, kind));
+    }
+    /**
+     * @brief decides if a phase of a non-blocking transaction is recorded
+     *
+     * The decision is taken at the first request phase of a transaction and kept until finish_nb() is called. Phases of
+     * transactions without a decision which cannot start a transaction are not recorded unless the transaction started
+     * before the filter was activated by trigger().
+     * @param tx the identity of the transaction, usually the address of the payload
+     * @param begin true if this is a request phase which may start the transaction
+     * @param addr the address of the transaction
+     * @param id the AXI ID or CHI TxnID of the transaction
+     * @param kind the type of the transaction
+     * @return true if the phase is recorded
+     */
+    inline bool accept_nb(uintptr_t tx, bool begin, uint64_t addr, unsigned id, tx_kind kind) {
+        if(!active)
+            return true;
+        auto it = decisions.find(tx);
+        if(it != decisions.end())
+            return it->second;
+        if(begin)
+            return decisions[tx] = decide(addr, id, kind);
+        return undecided;
+    }
+    /**
+     * @brief forgets the decision for a non-blocking transaction once it is finished
+     *
+     * @param tx the identity of the transaction
+     */
+    inline void finish_nb(uintptr_t tx) {
+        if(active)
+            decisions.erase(tx);
+    }
+
+private:
+    bool decide(uint64_t addr, unsigned id, tx_kind kind);
+    std::string const name;
+    bool active{false};
+    bool triggered{true};
+    bool undecided{false};
+    std::vector<std::pair<uint64_t, uint64_t>> addr_ranges;
+    std::vector<std::pair<uint64_t, uint64_t>> id_ranges;
+    bool kinds[3]{true, true, true};
+    unsigned sampling_rate{1};
+    unsigned sample_cnt{0};
+    sc_core::sc_time start_time, stop_time;
+    std::unordered_map<uintptr_t, bool> decisions;
+};
+} // namespace axi
@@ -23,6 +23,8 @@
 #include <array>
 #include <axi/axi_tlm.h>
 #include <axi/checker/checker_if.h>
+#include <axi/extension_recorder_list.h>
+#include <axi/recording_filter.h>
 #include <cci_configuration>
 #include <string>
 #include <tlm/scc/scv/tlm_recorder.h>
@@ -35,6 +37,14 @@ namespace axi {
 namespace scv {
 
 bool register_extensions();
+/**
+ * @brief records the time resolution and, if requested, the dictionary of the interned enumerations once into the given
+ * database
+ *
+ * @param db the database to record into
+ * @param interned true if the recorder records interned attributes
+ */
+void record_attribute_dictionary(SCVNS scv_tr_db* db, bool interned);
 
 /*! \brief The TLM2 transaction recorder
  *
@@ -62,6 +72,10 @@ public:
     //! \brief the attribute to selectively enable/disable timed recording
     cci::cci_param<bool> enableTimedTracing{"enableTimedTracing", true};
 
+    //! \brief the number of recorded phases after which the recorders of extensions never found in a payload are skipped,
+    //! 0 calls all registered extension recorders
+    cci::cci_param<unsigned> extensionRecordingWarmUp{"extensionRecordingWarmUp", 0};
+
     //! \brief the attribute to selectively enable/disable DMI recording
     cci::cci_param<bool> enableDmiTracing{"enableDmiTracing", false};
 
@@ -75,6 +89,9 @@ public:
 
     cci::cci_param<unsigned> wr_response_timeout{"wr_response_timeout", 0};
 
+    //! \brief the filter selecting the recorded transactions by address, id, type, sampling and time window
+    recording_filter filter;
+
     //! \brief the port where fw accesses are forwarded to
     virtual axi::ace_fw_transport_if<TYPES>* get_fw_if() = 0;
 
@@ -93,6 +110,7 @@ public:
                  SCVNS scv_tr_db* tr_db = SCVNS scv_tr_db::get_default_db())
     : enableBlTracing("enableBlTracing", recording_enabled)
     , enableNbTracing("enableNbTracing", recording_enabled)
+    , filter(name)
     , m_db(tr_db)
     , fixed_basename(name) {
         register_extensions();
@@ -237,8 +255,19 @@ private:
     SCVNS scv_tr_generator<sc_dt::uint64, sc_dt::uint64>* dmi_trInvalidateHandle{nullptr};
 
 protected:
+    //! checks the phases the protocol checker still holds, called by the module wrapping the recorder at the end of
+    //! the simulation so that the reports carry simulation time
+    void end_of_simulation() {
+        if(checker)
+            checker->flush();
+    }
+
     void initialize_streams() {
+        filter.init();
+        ext_recorder_list.init(tlm::scc::scv::tlm_extension_recording_registry<TYPES>::get().get(), extensionRecordingWarmUp.get_value());
         if(isRecordingBlockingTxEnabled()) {
+            // the delays of blocking tx are recorded in units of the time resolution
+            record_attribute_dictionary(m_db, false);
             b_streamHandle = new SCVNS scv_tr_stream((fixed_basename + "_bl").c_str(), "[TLM][ace][b]", m_db);
             b_trHandle[tlm::TLM_READ_COMMAND] =
                 new SCVNS scv_tr_generator<sc_dt::uint64, sc_dt::uint64>("read", *b_streamHandle, "start_delay", "end_delay");
@@ -280,7 +309,31 @@ protected:
 
 private:
     const std::string fixed_basename;
+    //! the registered extension recorders, built when the streams are initialized
+    axi::extension_recorder_list<tlm::scc::scv::tlm_extensions_recording_if<TYPES>> ext_recorder_list;
+    inline axi::extension_recorder_list<tlm::scc::scv::tlm_extensions_recording_if<TYPES>>& ext_recorders() {
+        if(!ext_recorder_list.is_initialized())
+            ext_recorder_list.init(tlm::scc::scv::tlm_extension_recording_registry<TYPES>::get().get(), extensionRecordingWarmUp.get_value());
+        return ext_recorder_list;
+    }
     axi::checker::checker_if<TYPES>* checker{nullptr};
+    inline recording_filter::tx_kind get_kind(typename TYPES::tlm_payload_type& trans) {
+        return trans.is_write() ? recording_filter::tx_kind::WRITE : recording_filter::tx_kind::READ;
+    }
+    inline bool is_nb_recorded(typename TYPES::tlm_payload_type& trans, const tlm::tlm_phase& p, bool bw) {
+        if(!filter.is_active())
+            return true;
+        auto id = reinterpret_cast<uintptr_t>(&trans);
+        if(bw && p == tlm::BEGIN_REQ) // snoops always start with BEGIN_REQ on the backward path
+            return filter.start_nb(id, trans.get_address(), axi::get_axi_id(trans), recording_filter::tx_kind::SNOOP);
+        return filter.accept_nb(id, !bw && (p == tlm::BEGIN_REQ || p == axi::BEGIN_PARTIAL_REQ), trans.get_address(), axi::get_axi_id(trans),
+                                get_kind(trans));
+    }
+    inline void finish_nb(typename TYPES::tlm_payload_type& trans, const tlm::tlm_phase& p, tlm::tlm_sync_enum status, bool bw) {
+        // snoops end with END_RESP on the backward path, all other transactions with ACK
+        if(status == tlm::TLM_COMPLETED || p == axi::ACK || (bw && p == tlm::END_RESP))
+            filter.finish_nb(reinterpret_cast<uintptr_t>(&trans));
+    }
 };
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -288,7 +341,7 @@ private:
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 template <typename TYPES> void ace_recorder<TYPES>::b_transport(typename TYPES::tlm_payload_type& trans, sc_core::sc_time& delay) {
-    if(!isRecordingBlockingTxEnabled()) {
+    if(!isRecordingBlockingTxEnabled() || !filter.accept(trans.get_address(), axi::get_axi_id(trans), get_kind(trans))) {
         get_fw_if()->b_transport(trans, delay);
         return;
     }
@@ -304,9 +357,7 @@ template <typename TYPES> void ace_recorder<TYPES>::b_transport(typename TYPES::
     }
 
     auto addr = trans.get_address();
-    for(auto& ext : tlm::scc::scv::tlm_extension_recording_registry<TYPES>::get().get())
-        if(ext)
-            ext->recordBeginTx(h, trans);
+    ext_recorders().record_begin(h, trans);
     tlm::scc::scv::tlm_recording_extension* preExt = nullptr;
 
     trans.get_extension(preExt);
@@ -335,9 +386,7 @@ template <typename TYPES> void ace_recorder<TYPES>::b_transport(typename TYPES::
 
     trans.set_address(addr);
     tlm::scc::scv::record(h, trans);
-    for(auto& ext : tlm::scc::scv::tlm_extension_recording_registry<TYPES>::get().get())
-        if(ext)
-            ext->recordEndTx(h, trans);
+    ext_recorders().record_end(h, trans);
     // End the transaction
     b_trHandle[trans.get_command()]->end_transaction(h, delay.value(), sc_core::sc_time_stamp());
     // and now the stuff for the timed tx
@@ -348,7 +397,7 @@ template <typename TYPES> void ace_recorder<TYPES>::b_transport(typename TYPES::
 }
 
 template <typename TYPES> void ace_recorder<TYPES>::b_snoop(typename TYPES::tlm_payload_type& trans, sc_core::sc_time& delay) {
-    if(!b_streamHandleTimed) {
+    if(!b_streamHandleTimed || !filter.accept(trans.get_address(), axi::get_axi_id(trans), recording_filter::tx_kind::SNOOP)) {
         get_fw_if()->b_transport(trans, delay);
         return;
     }
@@ -363,9 +412,7 @@ template <typename TYPES> void ace_recorder<TYPES>::b_snoop(typename TYPES::tlm_
         bh.add_relation(tlm::scc::scv::rel_str(tlm::scc::scv::PARENT_CHILD), h);
     }
 
-    for(auto& ext : tlm::scc::scv::tlm_extension_recording_registry<TYPES>::get().get())
-        if(ext)
-            ext->recordBeginTx(h, trans);
+    ext_recorders().record_begin(h, trans);
     tlm::scc::scv::tlm_recording_extension* preExt = NULL;
 
     trans.get_extension(preExt);
@@ -393,9 +440,7 @@ template <typename TYPES> void ace_recorder<TYPES>::b_snoop(typename TYPES::tlm_
     }
 
     tlm::scc::scv::record(h, trans);
-    for(auto& ext : tlm::scc::scv::tlm_extension_recording_registry<TYPES>::get().get())
-        if(ext)
-            ext->recordEndTx(h, trans);
+    ext_recorders().record_end(h, trans);
     // End the transaction
     b_trHandle[trans.get_command()]->end_transaction(h, delay.value(), sc_core::sc_time_stamp());
     // and now the stuff for the timed tx
@@ -408,14 +453,14 @@ template <typename TYPES> void ace_recorder<TYPES>::b_snoop(typename TYPES::tlm_
 template <typename TYPES>
 tlm::tlm_sync_enum ace_recorder<TYPES>::nb_transport_fw(typename TYPES::tlm_payload_type& trans, typename TYPES::tlm_phase_type& phase,
                                                         sc_core::sc_time& delay) {
-    if(!isRecordingNonBlockingTxEnabled()) {
-        if(checker) {
+    if(!isRecordingNonBlockingTxEnabled() || !is_nb_recorded(trans, phase, false)) {
+        if(checker)
             checker->fw_pre(trans, phase);
-            tlm::tlm_sync_enum status = get_fw_if()->nb_transport_fw(trans, phase, delay);
+        tlm::tlm_sync_enum status = get_fw_if()->nb_transport_fw(trans, phase, delay);
+        if(checker)
             checker->fw_post(trans, phase, status);
-            return status;
-        } else
-            return get_fw_if()->nb_transport_fw(trans, phase, delay);
+        finish_nb(trans, phase, status, false);
+        return status;
     }
     /*************************************************************************
      * prepare recording
@@ -439,9 +484,7 @@ tlm::tlm_sync_enum ace_recorder<TYPES>::nb_transport_fw(typename TYPES::tlm_payl
     // update the extension
     preExt->txHandle = h;
     h.record_attribute("delay", delay.to_string());
-    for(auto& ext : tlm::scc::scv::tlm_extension_recording_registry<TYPES>::get().get())
-        if(ext)
-            ext->recordBeginTx(h, trans);
+    ext_recorders().record_begin(h, trans);
     /*************************************************************************
      * do the timed notification
      *************************************************************************/
@@ -462,9 +505,7 @@ tlm::tlm_sync_enum ace_recorder<TYPES>::nb_transport_fw(typename TYPES::tlm_payl
     tlm::scc::scv::record(h, status);
     h.record_attribute("delay[return_path]", delay.to_string());
     tlm::scc::scv::record(h, trans);
-    for(auto& ext : tlm::scc::scv::tlm_extension_recording_registry<TYPES>::get().get())
-        if(ext)
-            ext->recordEndTx(h, trans);
+    ext_recorders().record_end(h, trans);
     // get the extension and free the memory if it was mine
     if(status == tlm::TLM_COMPLETED || (phase == axi::ACK)) {
         // the transaction is finished
@@ -488,20 +529,21 @@ tlm::tlm_sync_enum ace_recorder<TYPES>::nb_transport_fw(typename TYPES::tlm_payl
     }
     // End the transaction
     nb_trHandle[FW]->end_transaction(h, phase.get_name());
+    finish_nb(trans, phase, status, false);
     return status;
 }
 
 template <typename TYPES>
 tlm::tlm_sync_enum ace_recorder<TYPES>::nb_transport_bw(typename TYPES::tlm_payload_type& trans, typename TYPES::tlm_phase_type& phase,
                                                         sc_core::sc_time& delay) {
-    if(!isRecordingNonBlockingTxEnabled()) {
-        if(checker) {
+    if(!isRecordingNonBlockingTxEnabled() || !is_nb_recorded(trans, phase, true)) {
+        if(checker)
             checker->bw_pre(trans, phase);
-            tlm::tlm_sync_enum status = get_bw_if()->nb_transport_bw(trans, phase, delay);
+        tlm::tlm_sync_enum status = get_bw_if()->nb_transport_bw(trans, phase, delay);
+        if(checker)
             checker->bw_post(trans, phase, status);
-            return status;
-        } else
-            return get_bw_if()->nb_transport_bw(trans, phase, delay);
+        finish_nb(trans, phase, status, true);
+        return status;
     }
     /*************************************************************************
      * prepare recording
@@ -525,9 +567,7 @@ tlm::tlm_sync_enum ace_recorder<TYPES>::nb_transport_bw(typename TYPES::tlm_payl
     // and set the extension handle to this transaction
     preExt->txHandle = h;
     h.record_attribute("delay", delay.to_string());
-    for(auto& ext : tlm::scc::scv::tlm_extension_recording_registry<TYPES>::get().get())
-        if(ext)
-            ext->recordBeginTx(h, trans);
+    ext_recorders().record_begin(h, trans);
     /*************************************************************************
      * do the timed notification
      *************************************************************************/
@@ -548,9 +588,7 @@ tlm::tlm_sync_enum ace_recorder<TYPES>::nb_transport_bw(typename TYPES::tlm_payl
     tlm::scc::scv::record(h, status);
     h.record_attribute("delay[return_path]", delay.to_string());
     tlm::scc::scv::record(h, trans);
-    for(auto& ext : tlm::scc::scv::tlm_extension_recording_registry<TYPES>::get().get())
-        if(ext)
-            ext->recordEndTx(h, trans);
+    ext_recorders().record_end(h, trans);
     // get the extension and free the memory if it was mine
     if(status == tlm::TLM_COMPLETED || (status == tlm::TLM_UPDATED && phase == axi::ACK)) {
         // the transaction is finished
@@ -574,6 +612,7 @@ tlm::tlm_sync_enum ace_recorder<TYPES>::nb_transport_bw(typename TYPES::tlm_payl
     }
     // End the transaction
     nb_trHandle[BW]->end_transaction(h, phase.get_name());
+    finish_nb(trans, phase, status, true);
     return status;
 }
 
@@ -15,16 +15,27 @@
  */
 
 #include <axi/axi_tlm.h>
+#include <axi/interned_attributes.h>
 #include <tlm/scc/scv/tlm_extension_recording_registry.h>
 #include <tlm/scc/scv/tlm_recorder.h>
 #include <tlm/scc/tlm_id.h>
-#include <fmt/format.h>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace axi {
 namespace scv {
 
 using namespace tlm::scc::scv;
 
+namespace {
+template <typename E> inline void record_enum(SCVNS scv_tr_handle& handle, char const* name, E value) {
+    if(interning_active())
+        handle.record_attribute(name, static_cast<unsigned>(value));
+    else
+        handle.record_attribute(name, std::string(to_char(value)));
+}
+} // namespace
+
 struct tlm_id_ext_recording : public tlm_extensions_recording_if<axi::axi_protocol_types> {
 
     tlm_id_ext_recording() { recordBegin = &recordBeginTx; }
@@ -44,27 +55,27 @@ struct axi3_ext_record : public tlm_extension_record_if {
 
     static void recordBeginTx(SCVNS scv_tr_handle& handle, tlm::tlm_extension_base* e, std::string const& prefix) {
         if(auto ext = dynamic_cast<axi3_extension*>(e)) {
-            handle.record_attribute(fmt::format("{}id", prefix).c_str(), ext->get_id());
-            handle.record_attribute(fmt::format("{}user[CTRL]", prefix).c_str(), ext->get_user(common::id_type::CTRL));
-            handle.record_attribute(fmt::format("{}user[DATA]", prefix).c_str(), ext->get_user(common::id_type::DATA));
-            handle.record_attribute(fmt::format("{}user[RESP]", prefix).c_str(), ext->get_user(common::id_type::RESP));
-            handle.record_attribute(fmt::format("{}length", prefix).c_str(), ext->get_length());
-            handle.record_attribute(fmt::format("{}size", prefix).c_str(), ext->get_size());
-            handle.record_attribute(fmt::format("{}burst", prefix).c_str(), std::string(to_char(ext->get_burst())));
-            handle.record_attribute(fmt::format("{}prot", prefix).c_str(), ext->get_prot());
-            handle.record_attribute(fmt::format("{}exclusive", prefix).c_str(), std::string(ext->is_exclusive() ? "true" : "false"));
-            handle.record_attribute(fmt::format("{}cache", prefix).c_str(), ext->get_cache());
-            handle.record_attribute(fmt::format("{}cache_bufferable", prefix).c_str(), ext->is_bufferable());
-            handle.record_attribute(fmt::format("{}cache_cacheable", prefix).c_str(), ext->is_cacheable());
-            handle.record_attribute(fmt::format("{}cache_read_alloc", prefix).c_str(), ext->is_read_allocate());
-            handle.record_attribute(fmt::format("{}cache_write_alloc", prefix).c_str(), ext->is_write_allocate());
-            handle.record_attribute(fmt::format("{}qos", prefix).c_str(), ext->get_qos());
-            handle.record_attribute(fmt::format("{}region", prefix).c_str(), ext->get_region());
+            handle.record_attribute(attribute_name(prefix, "id"), ext->get_id());
+            handle.record_attribute(attribute_name(prefix, "user[CTRL]"), ext->get_user(common::id_type::CTRL));
+            handle.record_attribute(attribute_name(prefix, "user[DATA]"), ext->get_user(common::id_type::DATA));
+            handle.record_attribute(attribute_name(prefix, "user[RESP]"), ext->get_user(common::id_type::RESP));
+            handle.record_attribute(attribute_name(prefix, "length"), ext->get_length());
+            handle.record_attribute(attribute_name(prefix, "size"), ext->get_size());
+            record_enum(handle, attribute_name(prefix, "burst"), ext->get_burst());
+            handle.record_attribute(attribute_name(prefix, "prot"), ext->get_prot());
+            handle.record_attribute(attribute_name(prefix, "exclusive"), std::string(ext->is_exclusive() ? "true" : "false"));
+            handle.record_attribute(attribute_name(prefix, "cache"), ext->get_cache());
+            handle.record_attribute(attribute_name(prefix, "cache_bufferable"), ext->is_bufferable());
+            handle.record_attribute(attribute_name(prefix, "cache_cacheable"), ext->is_cacheable());
+            handle.record_attribute(attribute_name(prefix, "cache_read_alloc"), ext->is_read_allocate());
+            handle.record_attribute(attribute_name(prefix, "cache_write_alloc"), ext->is_write_allocate());
+            handle.record_attribute(attribute_name(prefix, "qos"), ext->get_qos());
+            handle.record_attribute(attribute_name(prefix, "region"), ext->get_region());
         }
     }
     static void recordEndTx(SCVNS scv_tr_handle& handle, tlm::tlm_extension_base* e, std::string const& prefix) {
         if(auto ext = dynamic_cast<axi3_extension*>(e)) {
-            handle.record_attribute(fmt::format("{}resp", prefix).c_str(), std::string(to_char(ext->get_resp())));
+            record_enum(handle, attribute_name(prefix, "resp"), ext->get_resp());
         }
     }
 };
@@ -94,28 +105,28 @@ struct axi4_ext_record : public tlm_extension_record_if {
 
     static void recordBeginTx(SCVNS scv_tr_handle& handle, tlm::tlm_extension_base* e, std::string const& prefix) {
         if(auto ext = dynamic_cast<axi4_extension*>(e)) {
-            handle.record_attribute(fmt::format("{}id", prefix).c_str(), ext->get_id());
-            handle.record_attribute(fmt::format("{}user[CTRL]", prefix).c_str(), ext->get_user(common::id_type::CTRL));
-            handle.record_attribute(fmt::format("{}user[DATA]", prefix).c_str(), ext->get_user(common::id_type::DATA));
-            handle.record_attribute(fmt::format("{}user[RESP]", prefix).c_str(), ext->get_user(common::id_type::RESP));
-            handle.record_attribute(fmt::format("{}length", prefix).c_str(), ext->get_length());
-            handle.record_attribute(fmt::format("{}size", prefix).c_str(), ext->get_size());
-            handle.record_attribute(fmt::format("{}burst", prefix).c_str(), std::string(to_char(ext->get_burst())));
-            handle.record_attribute(fmt::format("{}prot", prefix).c_str(), ext->get_prot());
-            handle.record_attribute(fmt::format("{}exclusive", prefix).c_str(), std::string(ext->is_exclusive() ? "true" : "false"));
-            handle.record_attribute(fmt::format("{}cache", prefix).c_str(), ext->get_cache());
-            handle.record_attribute(fmt::format("{}cache_bufferable", prefix).c_str(), ext->is_bufferable());
-            handle.record_attribute(fmt::format("{}cache_modifiable", prefix).c_str(), ext->is_modifiable());
-            handle.record_attribute(fmt::format("{}cache_allocate", prefix).c_str(), ext->is_allocate());
-            handle.record_attribute(fmt::format("{}cache_other_alloc", prefix).c_str(), ext->is_other_allocate());
-            handle.record_attribute(fmt::format("{}qos", prefix).c_str(), ext->get_qos());
-            handle.record_attribute(fmt::format("{}region", prefix).c_str(), ext->get_region());
+            handle.record_attribute(attribute_name(prefix, "id"), ext->get_id());
+            handle.record_attribute(attribute_name(prefix, "user[CTRL]"), ext->get_user(common::id_type::CTRL));
+            handle.record_attribute(attribute_name(prefix, "user[DATA]"), ext->get_user(common::id_type::DATA));
+            handle.record_attribute(attribute_name(prefix, "user[RESP]"), ext->get_user(common::id_type::RESP));
+            handle.record_attribute(attribute_name(prefix, "length"), ext->get_length());
+            handle.record_attribute(attribute_name(prefix, "size"), ext->get_size());
+            record_enum(handle, attribute_name(prefix, "burst"), ext->get_burst());
+            handle.record_attribute(attribute_name(prefix, "prot"), ext->get_prot());
+            handle.record_attribute(attribute_name(prefix, "exclusive"), std::string(ext->is_exclusive() ? "true" : "false"));
+            handle.record_attribute(attribute_name(prefix, "cache"), ext->get_cache());
+            handle.record_attribute(attribute_name(prefix, "cache_bufferable"), ext->is_bufferable());
+            handle.record_attribute(attribute_name(prefix, "cache_modifiable"), ext->is_modifiable());
+            handle.record_attribute(attribute_name(prefix, "cache_allocate"), ext->is_allocate());
+            handle.record_attribute(attribute_name(prefix, "cache_other_alloc"), ext->is_other_allocate());
+            handle.record_attribute(attribute_name(prefix, "qos"), ext->get_qos());
+            handle.record_attribute(attribute_name(prefix, "region"), ext->get_region());
         }
     }
 
     static void recordEndTx(SCVNS scv_tr_handle& handle, tlm::tlm_extension_base* e, std::string const& prefix) {
         if(auto ext = dynamic_cast<axi4_extension*>(e)) {
-            handle.record_attribute(fmt::format("{}resp", prefix).c_str(), std::string(to_char(ext->get_resp())));
+            record_enum(handle, attribute_name(prefix, "resp"), ext->get_resp());
         }
     }
 };
@@ -145,37 +156,37 @@ struct ace_ext_record : public tlm_extension_record_if {
 
     static void recordBeginTx(SCVNS scv_tr_handle& handle, tlm::tlm_extension_base* e, std::string const& prefix) {
         if(auto ext = dynamic_cast<ace_extension*>(e)) {
-            handle.record_attribute(fmt::format("{}id", prefix).c_str(), ext->get_id());
-            handle.record_attribute(fmt::format("{}user[CTRL]", prefix).c_str(), ext->get_user(common::id_type::CTRL));
-            handle.record_attribute(fmt::format("{}user[DATA]", prefix).c_str(), ext->get_user(common::id_type::DATA));
-            handle.record_attribute(fmt::format("{}length", prefix).c_str(), ext->get_length());
-            handle.record_attribute(fmt::format("{}size", prefix).c_str(), ext->get_size());
-            handle.record_attribute(fmt::format("{}burst", prefix).c_str(), std::string(to_char(ext->get_burst())));
-            handle.record_attribute(fmt::format("{}prot", prefix).c_str(), ext->get_prot());
-            handle.record_attribute(fmt::format("{}exclusive", prefix).c_str(), std::string(ext->is_exclusive() ? "true" : "false"));
-            handle.record_attribute(fmt::format("{}cache", prefix).c_str(), ext->get_cache());
-            handle.record_attribute(fmt::format("{}cache_bufferable", prefix).c_str(), ext->is_bufferable());
-            handle.record_attribute(fmt::format("{}cache_modifiable", prefix).c_str(), ext->is_modifiable());
-            handle.record_attribute(fmt::format("{}cache_allocate", prefix).c_str(), ext->is_allocate());
-            handle.record_attribute(fmt::format("{}cache_other_alloc", prefix).c_str(), ext->is_other_allocate());
-            handle.record_attribute(fmt::format("{}qos", prefix).c_str(), ext->get_qos());
-            handle.record_attribute(fmt::format("{}region", prefix).c_str(), ext->get_region());
-            handle.record_attribute(fmt::format("{}domain", prefix).c_str(), std::string(to_char(ext->get_domain())));
-            handle.record_attribute(fmt::format("{}snoop", prefix).c_str(), std::string(to_char(ext->get_snoop())));
-            handle.record_attribute(fmt::format("{}barrier", prefix).c_str(), std::string(to_char(ext->get_barrier())));
-            handle.record_attribute(fmt::format("{}unique", prefix).c_str(), ext->get_unique());
+            handle.record_attribute(attribute_name(prefix, "id"), ext->get_id());
+            handle.record_attribute(attribute_name(prefix, "user[CTRL]"), ext->get_user(common::id_type::CTRL));
+            handle.record_attribute(attribute_name(prefix, "user[DATA]"), ext->get_user(common::id_type::DATA));
+            handle.record_attribute(attribute_name(prefix, "length"), ext->get_length());
+            handle.record_attribute(attribute_name(prefix, "size"), ext->get_size());
+            record_enum(handle, attribute_name(prefix, "burst"), ext->get_burst());
+            handle.record_attribute(attribute_name(prefix, "prot"), ext->get_prot());
+            handle.record_attribute(attribute_name(prefix, "exclusive"), std::string(ext->is_exclusive() ? "true" : "false"));
+            handle.record_attribute(attribute_name(prefix, "cache"), ext->get_cache());
+            handle.record_attribute(attribute_name(prefix, "cache_bufferable"), ext->is_bufferable());
+            handle.record_attribute(attribute_name(prefix, "cache_modifiable"), ext->is_modifiable());
+            handle.record_attribute(attribute_name(prefix, "cache_allocate"), ext->is_allocate());
+            handle.record_attribute(attribute_name(prefix, "cache_other_alloc"), ext->is_other_allocate());
+            handle.record_attribute(attribute_name(prefix, "qos"), ext->get_qos());
+            handle.record_attribute(attribute_name(prefix, "region"), ext->get_region());
+            record_enum(handle, attribute_name(prefix, "domain"), ext->get_domain());
+            record_enum(handle, attribute_name(prefix, "snoop"), ext->get_snoop());
+            record_enum(handle, attribute_name(prefix, "barrier"), ext->get_barrier());
+            handle.record_attribute(attribute_name(prefix, "unique"), ext->get_unique());
         }
     }
 
     static void recordEndTx(SCVNS scv_tr_handle& handle, tlm::tlm_extension_base* e, std::string const& prefix) {
         if(auto ext = dynamic_cast<ace_extension*>(e)) {
-            handle.record_attribute(fmt::format("{}resp", prefix).c_str(), std::string(to_char(ext->get_resp())));
-            handle.record_attribute(fmt::format("{}cresp", prefix).c_str(), static_cast<unsigned>(ext->get_cresp()));
-            handle.record_attribute(fmt::format("{}cresp_PassDirty", prefix).c_str(), ext->is_pass_dirty());
-            handle.record_attribute(fmt::format("{}cresp_IsShared", prefix).c_str(), ext->is_shared());
-            handle.record_attribute(fmt::format("{}cresp_SnoopDataTransfer", prefix).c_str(), ext->is_snoop_data_transfer());
-            handle.record_attribute(fmt::format("{}cresp_SnoopError", prefix).c_str(), ext->is_snoop_error());
-            handle.record_attribute(fmt::format("{}cresp_SnoopWasUnique", prefix).c_str(), ext->is_snoop_was_unique());
+            record_enum(handle, attribute_name(prefix, "resp"), ext->get_resp());
+            handle.record_attribute(attribute_name(prefix, "cresp"), static_cast<unsigned>(ext->get_cresp()));
+            handle.record_attribute(attribute_name(prefix, "cresp_PassDirty"), ext->is_pass_dirty());
+            handle.record_attribute(attribute_name(prefix, "cresp_IsShared"), ext->is_shared());
+            handle.record_attribute(attribute_name(prefix, "cresp_SnoopDataTransfer"), ext->is_snoop_data_transfer());
+            handle.record_attribute(attribute_name(prefix, "cresp_SnoopError"), ext->is_snoop_error());
+            handle.record_attribute(attribute_name(prefix, "cresp_SnoopWasUnique"), ext->is_snoop_was_unique());
         }
     }
 };
@@ -234,5 +245,30 @@ bool register_extensions() {
     return true;                                                                                    // NOLINT
 }
 bool registered = register_extensions();
+
+void record_attribute_dictionary(SCVNS scv_tr_db* db, bool interned) {
+    // the stream and generators need to live as long as the database, so they are not freed
+    static std::unordered_map<SCVNS scv_tr_db*, SCVNS scv_tr_stream*> streams;
+    static std::unordered_set<SCVNS scv_tr_db*> with_enums;
+    if(!db)
+        return;
+    auto& stream = streams[db];
+    if(!stream) {
+        stream = new SCVNS scv_tr_stream("attribute_dictionary", "[dictionary]", db);
+        // time values recorded as integers (blocking tx and interned delays) are in units of this resolution
+        auto* res_gen = new SCVNS scv_tr_generator<sc_dt::uint64>("time_resolution", *stream, "femtoseconds");
+        auto h = res_gen->begin_transaction(static_cast<sc_dt::uint64>(sc_core::sc_get_time_resolution().to_seconds() * 1e15 + 0.5));
+        res_gen->end_transaction(h);
+    }
+    if(!interned || !with_enums.insert(db).second)
+        return;
+    for(auto& dict : get_attribute_dictionary(true)) {
+        auto* gen = new SCVNS scv_tr_generator<int, std::string>(dict.first, *stream, "id", "name");
+        for(auto& entry : dict.second) {
+            auto h = gen->begin_transaction(entry.id);
+            gen->end_transaction(h, entry.name);
+        }
+    }
+}
 } // namespace scv
 } // namespace axi
@@ -23,13 +23,16 @@
 #include <array>
 #include <axi/axi_tlm.h>
 #include <axi/checker/axi_protocol.h>
+#include <axi/extension_recorder_list.h>
+#include <axi/interned_attributes.h>
+#include <axi/recording_filter.h>
+#include <axi/tx_state_ext.h>
 #include <cci_configuration>
 #include <regex>
 #include <string>
 #include <tlm/scc/scv/tlm_recorder.h>
 #include <tlm/scc/scv/tlm_recording_extension.h>
 #include <tlm_utils/peq_with_cb_and_phase.h>
-#include <unordered_map>
 #include <vector>
 
 //! SCV components for AXI/ACE
@@ -37,6 +40,14 @@ namespace axi {
 namespace scv {
 
 bool register_extensions();
+/**
+ * @brief records the time resolution and, if requested, the dictionary of the interned enumerations once into the given
+ * database
+ *
+ * @param db the database to record into
+ * @param interned true if the recorder records interned attributes
+ */
+void record_attribute_dictionary(SCVNS scv_tr_db* db, bool interned);
 
 /*! \brief The TLM2 transaction recorder
  *
@@ -64,6 +75,10 @@ public:
     //! \brief the attribute to selectively enable/disable timed recording
     cci::cci_param<bool> enableTimedTracing{"enableTimedTracing", true};
 
+    //! \brief the number of recorded phases after which the recorders of extensions never found in a payload are skipped,
+    //! 0 calls all registered extension recorders
+    cci::cci_param<unsigned> extensionRecordingWarmUp{"extensionRecordingWarmUp", 0};
+
     //! \brief the attribute to selectively enable/disable DMI recording
     cci::cci_param<bool> enableDmiTracing{"enableDmiTracing", false};
 
@@ -73,10 +88,26 @@ public:
     //! \brief the attribute to  enable/disable protocol checking
     cci::cci_param<bool> enableProtocolChecker{"enableProtocolChecker", false};
 
+    //! \brief the attribute to record phases, commands, responses and enumerations as integer ids and delays in units of
+    //! the time resolution. The names of the ids are recorded once as dictionary stream into the database
+    cci::cci_param<bool> enableInternedAttributes{"enableInternedAttributes", false};
+
+    //! \brief the time in ns a read may wait for its response before the protocol checker reports it, 0 disables the check
     cci::cci_param<unsigned> rd_response_timeout{"rd_response_timeout", 0};
 
+    //! \brief the time in ns a write may wait for its response before the protocol checker reports it, 0 disables the check
     cci::cci_param<unsigned> wr_response_timeout{"wr_response_timeout", 0};
 
+    //! \brief the protocol checker checks only every n-th transaction, 0 or 1 checks all transactions
+    cci::cci_param<unsigned> checkerSampleRate{"checkerSampleRate", 1};
+
+    //! \brief the number of phases the protocol checker collects before checking them in a batch, 0 checks each phase
+    //! immediately
+    cci::cci_param<unsigned> checkerBatchSize{"checkerBatchSize", 0};
+
+    //! \brief the filter selecting the recorded transactions by address, id, type, sampling and time window
+    recording_filter filter;
+
     //! \brief the port where fw accesses are forwarded to
     virtual tlm::tlm_fw_transport_if<TYPES>* get_fw_if() = 0;
 
@@ -95,6 +126,7 @@ public:
                  SCVNS scv_tr_db* tr_db = SCVNS scv_tr_db::get_default_db())
     : enableBlTracing("enableBlTracing", recording_enabled)
     , enableNbTracing("enableNbTracing", recording_enabled)
+    , filter(name)
     , bus_width(bus_width)
     , m_db(tr_db)
     , fixed_basename(name) {
@@ -102,10 +134,6 @@ public:
     }
 
     virtual ~axi_recorder() override {
-        nbtx_req_handle_map.clear();
-        nbtx_last_req_handle_map.clear();
-        nbtx_resp_handle_map.clear();
-        nbtx_last_resp_handle_map.clear();
         delete b_streamHandle;
         for(auto* p : b_trHandle)
             delete p; // NOLINT
@@ -115,6 +143,8 @@ public:
         delete nb_streamHandle;
         for(auto* p : nb_trHandle)
             delete p; // NOLINT
+        for(auto* p : nb_trIdHandle)
+            delete p; // NOLINT
         delete nb_streamHandleTimed;
         for(auto* p : nb_trTimedHandle)
             delete p; // NOLINT
@@ -218,12 +248,15 @@ private:
     SCVNS scv_tr_stream* nb_streamHandleTimed{nullptr};
     //! transaction generator handle for non-blocking transactions
     std::array<SCVNS scv_tr_generator<std::string, std::string>*, 2> nb_trHandle{{nullptr, nullptr}};
+    //! transaction generator handle for non-blocking transactions recording the phases as ids
+    std::array<SCVNS scv_tr_generator<unsigned, unsigned>*, 2> nb_trIdHandle{{nullptr, nullptr}};
     //! transaction generator handle for non-blocking transactions with annotated delays
     std::array<SCVNS scv_tr_generator<>*, 2> nb_trTimedHandle{{nullptr, nullptr}};
-    std::unordered_map<uint64_t, SCVNS scv_tr_handle> nbtx_req_handle_map;
-    std::unordered_map<uint64_t, SCVNS scv_tr_handle> nbtx_last_req_handle_map;
-    std::unordered_map<uint64_t, SCVNS scv_tr_handle> nbtx_resp_handle_map;
-    std::unordered_map<uint64_t, SCVNS scv_tr_handle> nbtx_last_resp_handle_map;
+    //! the handles of the open timed transactions, kept in the tx_state_ext of the payload
+    struct nb_tx_handles {
+        SCVNS scv_tr_handle req, last_req, resp, last_resp;
+    };
+    using nb_tx_state = tx_state<nb_tx_handles>;
     //! dmi transaction recording stream handle
     SCVNS scv_tr_stream* dmi_streamHandle{nullptr};
     //! transaction generator handle for DMI transactions
@@ -231,7 +264,16 @@ private:
     SCVNS scv_tr_generator<sc_dt::uint64, sc_dt::uint64>* dmi_trInvalidateHandle{nullptr};
 
 protected:
+    //! checks the phases the protocol checker still holds, called by the module wrapping the recorder at the end of
+    //! the simulation so that the reports carry simulation time
+    void end_of_simulation() {
+        if(checker)
+            checker->flush();
+    }
+
     void initialize_streams() {
+        filter.init();
+        ext_recorder_list.init(tlm::scc::scv::tlm_extension_recording_registry<TYPES>::get(), extensionRecordingWarmUp.get_value());
         if(isRecordingBlockingTxEnabled()) {
             b_streamHandle = new SCVNS scv_tr_stream((fixed_basename + "_bl").c_str(), "[TLM][axi][b]", m_db);
             b_trHandle[tlm::TLM_READ_COMMAND] =
@@ -247,12 +289,26 @@ protected:
                 b_trTimedHandle[tlm::TLM_IGNORE_COMMAND] = new SCVNS scv_tr_generator<>("ignore", *b_streamHandleTimed);
             }
         }
+        if(m_db && enableInternedAttributes.get_value()) {
+            interned = true;
+            ext_recorders().set_interned(true);
+        }
+        // the delays of blocking tx and the interned delays are recorded in units of the time resolution
+        if(m_db)
+            record_attribute_dictionary(m_db, interned);
         if(isRecordingNonBlockingTxEnabled()) {
             nb_streamHandle = new SCVNS scv_tr_stream((fixed_basename + "_nb").c_str(), "[TLM][axi][nb]", m_db);
-            nb_trHandle[FW] =
-                new SCVNS scv_tr_generator<std::string, std::string>("fw", *nb_streamHandle, "tlm_phase", "tlm_phase[return_path]");
-            nb_trHandle[BW] =
-                new SCVNS scv_tr_generator<std::string, std::string>("bw", *nb_streamHandle, "tlm_phase", "tlm_phase[return_path]");
+            if(interned) {
+                nb_trIdHandle[FW] =
+                    new SCVNS scv_tr_generator<unsigned, unsigned>("fw", *nb_streamHandle, "tlm_phase", "tlm_phase[return_path]");
+                nb_trIdHandle[BW] =
+                    new SCVNS scv_tr_generator<unsigned, unsigned>("bw", *nb_streamHandle, "tlm_phase", "tlm_phase[return_path]");
+            } else {
+                nb_trHandle[FW] =
+                    new SCVNS scv_tr_generator<std::string, std::string>("fw", *nb_streamHandle, "tlm_phase", "tlm_phase[return_path]");
+                nb_trHandle[BW] =
+                    new SCVNS scv_tr_generator<std::string, std::string>("bw", *nb_streamHandle, "tlm_phase", "tlm_phase[return_path]");
+            }
             if(enableTimedTracing.get_value()) {
                 nb_streamHandleTimed = new SCVNS scv_tr_stream((fixed_basename + "_nb_timed").c_str(), "[TLM][axi][nb][timed]", m_db);
                 nb_trTimedHandle[FW] = new SCVNS scv_tr_generator<>("request", *nb_streamHandleTimed);
@@ -267,17 +323,67 @@ protected:
         }
         if(enableProtocolChecker.get_value()) {
             checker = new axi::checker::axi_protocol(fixed_basename, bus_width / 8, rd_response_timeout.get_value(),
-                                                     wr_response_timeout.get_value());
+                                                     wr_response_timeout.get_value(), checkerSampleRate.get_value(),
+                                                     checkerBatchSize.get_value());
         }
     }
 
 private:
     const std::string fixed_basename;
+    //! the registered extension recorders, built when the streams are initialized
+    axi::extension_recorder_list<tlm::scc::scv::tlm_extensions_recording_if<TYPES>> ext_recorder_list;
+    inline axi::extension_recorder_list<tlm::scc::scv::tlm_extensions_recording_if<TYPES>>& ext_recorders() {
+        if(!ext_recorder_list.is_initialized())
+            ext_recorder_list.init(tlm::scc::scv::tlm_extension_recording_registry<TYPES>::get(), extensionRecordingWarmUp.get_value());
+        return ext_recorder_list;
+    }
     axi::checker::checker_if<TYPES>* checker{nullptr};
-    inline std::string phase2string(const tlm::tlm_phase& p) {
-        std::stringstream ss;
-        ss << p;
-        return ss.str();
+    //! phases, commands, responses and enumerations are recorded as integer ids
+    bool interned{false};
+    inline recording_filter::tx_kind get_kind(typename TYPES::tlm_payload_type& trans) {
+        return trans.is_write() ? recording_filter::tx_kind::WRITE : recording_filter::tx_kind::READ;
+    }
+    inline bool is_nb_recorded(typename TYPES::tlm_payload_type& trans, const tlm::tlm_phase& p) {
+        return !filter.is_active() || filter.accept_nb(reinterpret_cast<uintptr_t>(&trans), p == tlm::BEGIN_REQ || p == axi::BEGIN_PARTIAL_REQ,
+                                                       trans.get_address(), axi::get_axi_id(trans), get_kind(trans));
+    }
+    inline void finish_nb(typename TYPES::tlm_payload_type& trans, const tlm::tlm_phase& p, tlm::tlm_sync_enum status) {
+        if(status == tlm::TLM_COMPLETED || p == tlm::END_RESP)
+            filter.finish_nb(reinterpret_cast<uintptr_t>(&trans));
+    }
+    inline SCVNS scv_tr_handle begin_nb_tx(DIR dir, const tlm::tlm_phase& p) {
+        return interned ? nb_trIdHandle[dir]->begin_transaction(static_cast<unsigned>(p))
+                        : nb_trHandle[dir]->begin_transaction(phase_name(p));
+    }
+    inline void end_nb_tx(DIR dir, SCVNS scv_tr_handle& h, const tlm::tlm_phase& p) {
+        if(interned)
+            nb_trIdHandle[dir]->end_transaction(h, static_cast<unsigned>(p));
+        else
+            nb_trHandle[dir]->end_transaction(h, phase_name(p));
+    }
+    inline void record_delay(SCVNS scv_tr_handle& h, const char* name, const sc_core::sc_time& delay) {
+        if(interned)
+            h.record_attribute(name, delay.value());
+        else
+            h.record_attribute(name, delay.to_string());
+    }
+    inline void record_status(SCVNS scv_tr_handle& h, tlm::tlm_sync_enum status) {
+        if(interned)
+            h.record_attribute("tlm_sync", static_cast<unsigned>(status));
+        else
+            tlm::scc::scv::record(h, status);
+    }
+    void record_trans(SCVNS scv_tr_handle& h, typename TYPES::tlm_payload_type& trans) {
+        if(interned) {
+            h.record_attribute("trans.address", trans.get_address());
+            h.record_attribute("trans.cmd", static_cast<unsigned>(trans.get_command()));
+            h.record_attribute("trans.data_length", trans.get_data_length());
+            h.record_attribute("trans.response", static_cast<int>(trans.get_response_status()));
+            h.record_attribute("trans.streaming_width", trans.get_streaming_width());
+            h.record_attribute("trans.byte_enable_length", trans.get_byte_enable_length());
+            h.record_attribute("trans.dmi", trans.is_dmi_allowed());
+        } else
+            tlm::scc::scv::record(h, trans);
     }
 };
 
@@ -286,7 +392,7 @@ private:
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 template <typename TYPES> void axi_recorder<TYPES>::b_transport(typename TYPES::tlm_payload_type& trans, sc_core::sc_time& delay) {
-    if(!isRecordingBlockingTxEnabled()) {
+    if(!isRecordingBlockingTxEnabled() || !filter.accept(trans.get_address(), axi::get_axi_id(trans), get_kind(trans))) {
         get_fw_if()->b_transport(trans, delay);
         return;
     }
@@ -301,9 +407,7 @@ template <typename TYPES> void axi_recorder<TYPES>::b_transport(typename TYPES::
         bh.add_relation(tlm::scc::scv::rel_str(tlm::scc::scv::PARENT_CHILD), h);
     }
 
-    for(auto& ext : tlm::scc::scv::tlm_extension_recording_registry<TYPES>::get())
-        if(ext)
-            ext->recordBeginTx(h, trans);
+    ext_recorders().record_begin(h, trans);
     tlm::scc::scv::tlm_recording_extension* preExt = nullptr;
 
     trans.get_extension(preExt);
@@ -330,15 +434,13 @@ template <typename TYPES> void axi_recorder<TYPES>::b_transport(typename TYPES::
         preExt->txHandle = preTx;
     }
 
-    tlm::scc::scv::record(h, trans);
-    for(auto& ext : tlm::scc::scv::tlm_extension_recording_registry<TYPES>::get())
-        if(ext)
-            ext->recordEndTx(h, trans);
+    record_trans(h, trans);
+    ext_recorders().record_end(h, trans);
     // End the transaction
     b_trHandle[trans.get_command()]->end_transaction(h, delay.value(), sc_core::sc_time_stamp());
     // and now the stuff for the timed tx
     if(bh.is_valid()) {
-        tlm::scc::scv::record(h, trans);
+        record_trans(bh, trans);
         b_trTimedHandle[trans.get_command()]->end_transaction(bh, sc_core::sc_time_stamp() + delay);
     }
 }
@@ -346,20 +448,20 @@ template <typename TYPES> void axi_recorder<TYPES>::b_transport(typename TYPES::
 template <typename TYPES>
 tlm::tlm_sync_enum axi_recorder<TYPES>::nb_transport_fw(typename TYPES::tlm_payload_type& trans, typename TYPES::tlm_phase_type& phase,
                                                         sc_core::sc_time& delay) {
-    if(!isRecordingNonBlockingTxEnabled()) {
-        if(checker) {
+    if(!isRecordingNonBlockingTxEnabled() || !is_nb_recorded(trans, phase)) {
+        if(checker)
             checker->fw_pre(trans, phase);
-            tlm::tlm_sync_enum status = get_fw_if()->nb_transport_fw(trans, phase, delay);
+        tlm::tlm_sync_enum status = get_fw_if()->nb_transport_fw(trans, phase, delay);
+        if(checker)
             checker->fw_post(trans, phase, status);
-            return status;
-        } else
-            return get_fw_if()->nb_transport_fw(trans, phase, delay);
+        finish_nb(trans, phase, status);
+        return status;
     }
     /*************************************************************************
      * prepare recording
      *************************************************************************/
     // Get a handle for the new transaction
-    SCVNS scv_tr_handle h = nb_trHandle[FW]->begin_transaction(phase2string(phase));
+    SCVNS scv_tr_handle h = begin_nb_tx(FW, phase);
     tlm::scc::scv::tlm_recording_extension* preExt = nullptr;
     trans.get_extension(preExt);
     if((phase == axi::BEGIN_PARTIAL_REQ || phase == tlm::BEGIN_REQ) && preExt == nullptr) { // we are the first recording this transaction
@@ -376,10 +478,8 @@ tlm::tlm_sync_enum axi_recorder<TYPES>::nb_transport_fw(typename TYPES::tlm_payl
     }
     // update the extension
     preExt->txHandle = h;
-    h.record_attribute("delay", delay.to_string());
-    for(auto& ext : tlm::scc::scv::tlm_extension_recording_registry<TYPES>::get())
-        if(ext)
-            ext->recordBeginTx(h, trans);
+    record_delay(h, "delay", delay);
+    ext_recorders().record_begin(h, trans);
     /*************************************************************************
      * do the timed notification
      *************************************************************************/
@@ -397,12 +497,10 @@ tlm::tlm_sync_enum axi_recorder<TYPES>::nb_transport_fw(typename TYPES::tlm_payl
     /*************************************************************************
      * handle recording
      *************************************************************************/
-    tlm::scc::scv::record(h, status);
-    h.record_attribute("delay[return_path]", delay.to_string());
-    tlm::scc::scv::record(h, trans);
-    for(auto& ext : tlm::scc::scv::tlm_extension_recording_registry<TYPES>::get())
-        if(ext)
-            ext->recordEndTx(h, trans);
+    record_status(h, status);
+    record_delay(h, "delay[return_path]", delay);
+    record_trans(h, trans);
+    ext_recorders().record_end(h, trans);
     // get the extension and free the memory if it was mine
     if(status == tlm::TLM_COMPLETED || (status == tlm::TLM_ACCEPTED && phase == tlm::END_RESP)) {
         // the transaction is finished
@@ -424,27 +522,28 @@ tlm::tlm_sync_enum axi_recorder<TYPES>::nb_transport_fw(typename TYPES::tlm_payl
         record_nb_tx(trans, phase, delay, h);
     }
     // End the transaction
-    nb_trHandle[FW]->end_transaction(h, phase2string(phase));
+    end_nb_tx(FW, h, phase);
+    finish_nb(trans, phase, status);
     return status;
 }
 
 template <typename TYPES>
 tlm::tlm_sync_enum axi_recorder<TYPES>::nb_transport_bw(typename TYPES::tlm_payload_type& trans, typename TYPES::tlm_phase_type& phase,
                                                         sc_core::sc_time& delay) {
-    if(!isRecordingNonBlockingTxEnabled()) {
-        if(checker) {
+    if(!isRecordingNonBlockingTxEnabled() || !is_nb_recorded(trans, phase)) {
+        if(checker)
             checker->bw_pre(trans, phase);
-            tlm::tlm_sync_enum status = get_bw_if()->nb_transport_bw(trans, phase, delay);
+        tlm::tlm_sync_enum status = get_bw_if()->nb_transport_bw(trans, phase, delay);
+        if(checker)
             checker->bw_post(trans, phase, status);
-            return status;
-        } else
-            return get_bw_if()->nb_transport_bw(trans, phase, delay);
+        finish_nb(trans, phase, status);
+        return status;
     }
     /*************************************************************************
      * prepare recording
      *************************************************************************/
     // Get a handle for the new transaction
-    SCVNS scv_tr_handle h = nb_trHandle[BW]->begin_transaction(phase2string(phase));
+    SCVNS scv_tr_handle h = begin_nb_tx(BW, phase);
     tlm::scc::scv::tlm_recording_extension* preExt = nullptr;
     trans.get_extension(preExt);
     if(phase == tlm::BEGIN_REQ && preExt == nullptr) { // we are the first recording this transaction
@@ -461,10 +560,8 @@ tlm::tlm_sync_enum axi_recorder<TYPES>::nb_transport_bw(typename TYPES::tlm_payl
     }
     // and set the extension handle to this transaction
     preExt->txHandle = h;
-    h.record_attribute("delay", delay.to_string());
-    for(auto& ext : tlm::scc::scv::tlm_extension_recording_registry<TYPES>::get())
-        if(ext)
-            ext->recordBeginTx(h, trans);
+    record_delay(h, "delay", delay);
+    ext_recorders().record_begin(h, trans);
     /*************************************************************************
      * do the timed notification
      *************************************************************************/
@@ -482,12 +579,10 @@ tlm::tlm_sync_enum axi_recorder<TYPES>::nb_transport_bw(typename TYPES::tlm_payl
     /*************************************************************************
      * handle recording
      *************************************************************************/
-    tlm::scc::scv::record(h, status);
-    h.record_attribute("delay[return_path]", delay.to_string());
-    tlm::scc::scv::record(h, trans);
-    for(auto& ext : tlm::scc::scv::tlm_extension_recording_registry<TYPES>::get())
-        if(ext)
-            ext->recordEndTx(h, trans);
+    record_status(h, status);
+    record_delay(h, "delay[return_path]", delay);
+    record_trans(h, trans);
+    ext_recorders().record_end(h, trans);
     // get the extension and free the memory if it was mine
     if(status == tlm::TLM_COMPLETED || (status == tlm::TLM_UPDATED && phase == tlm::END_RESP)) {
         // the transaction is finished
@@ -509,7 +604,8 @@ tlm::tlm_sync_enum axi_recorder<TYPES>::nb_transport_bw(typename TYPES::tlm_payl
         record_nb_tx(trans, phase, delay, h);
     }
     // End the transaction
-    nb_trHandle[BW]->end_transaction(h, phase2string(phase));
+    end_nb_tx(BW, h, phase);
+    finish_nb(trans, phase, status);
     return status;
 }
 
@@ -519,55 +615,44 @@ void axi_recorder<TYPES>::record_nb_tx(typename TYPES::tlm_payload_type& trans,
     SCVNS scv_tr_handle h;
     // Now process outstanding recordings
     auto t = sc_core::sc_time_stamp() + delay;
-    auto id = reinterpret_cast<uintptr_t>(&trans);
+    auto& st = *get_tx_state<nb_tx_state>(trans, this);
     if(phase == tlm::BEGIN_REQ || phase == axi::BEGIN_PARTIAL_REQ) {
         h = nb_trTimedHandle[REQ]->begin_transaction(t);
-        tlm::scc::scv::record(h, trans);
+        record_trans(h, trans);
         h.add_relation(tlm::scc::scv::rel_str(tlm::scc::scv::PARENT_CHILD), parent);
-        nbtx_req_handle_map[id] = h;
+        st.req = h;
     } else if(phase == tlm::END_REQ || phase == axi::END_PARTIAL_REQ) {
-        auto it = nbtx_req_handle_map.find(id);
-        if(it != nbtx_req_handle_map.end()) {
-            h = it->second;
-            nbtx_req_handle_map.erase(it);
-            h.end_transaction(t);
-            nbtx_last_req_handle_map[id] = h;
+        if(st.req.is_valid()) {
+            st.req.end_transaction(t);
+            st.last_req = st.req;
+            st.req = SCVNS scv_tr_handle();
         }
     } else if(phase == tlm::BEGIN_RESP || phase == axi::BEGIN_PARTIAL_RESP) {
-        auto it = nbtx_req_handle_map.find(id);
-        if(it != nbtx_req_handle_map.end()) {
-            h = it->second;
-            nbtx_req_handle_map.erase(it);
-            h.end_transaction(t);
-            nbtx_last_req_handle_map[id] = h;
+        if(st.req.is_valid()) {
+            st.req.end_transaction(t);
+            st.last_req = st.req;
+            st.req = SCVNS scv_tr_handle();
         }
         h = nb_trTimedHandle[RESP]->begin_transaction(t);
-        tlm::scc::scv::record(h, trans);
+        record_trans(h, trans);
         h.add_relation(tlm::scc::scv::rel_str(tlm::scc::scv::PARENT_CHILD), parent);
-        nbtx_resp_handle_map[id] = h;
-        it = nbtx_last_req_handle_map.find(id);
-        if(it != nbtx_last_req_handle_map.end()) {
-            SCVNS scv_tr_handle& pred = it->second;
-            h.add_relation(tlm::scc::scv::rel_str(tlm::scc::scv::PREDECESSOR_SUCCESSOR), pred);
-            nbtx_last_req_handle_map.erase(it);
-        } else {
-            it = nbtx_last_resp_handle_map.find(id);
-            if(it != nbtx_last_resp_handle_map.end()) {
-                SCVNS scv_tr_handle& pred = it->second;
-                h.add_relation(tlm::scc::scv::rel_str(tlm::scc::scv::PREDECESSOR_SUCCESSOR), pred);
-                nbtx_last_resp_handle_map.erase(it);
-            }
+        st.resp = h;
+        if(st.last_req.is_valid()) {
+            h.add_relation(tlm::scc::scv::rel_str(tlm::scc::scv::PREDECESSOR_SUCCESSOR), st.last_req);
+            st.last_req = SCVNS scv_tr_handle();
+        } else if(st.last_resp.is_valid()) {
+            h.add_relation(tlm::scc::scv::rel_str(tlm::scc::scv::PREDECESSOR_SUCCESSOR), st.last_resp);
+            st.last_resp = SCVNS scv_tr_handle();
         }
     } else if(phase == tlm::END_RESP || phase == axi::END_PARTIAL_RESP) {
-        auto it = nbtx_resp_handle_map.find(id);
-        if(it != nbtx_resp_handle_map.end()) {
-            h = it->second;
-            nbtx_resp_handle_map.erase(it);
-            h.end_transaction(t);
-            if(phase == axi::END_PARTIAL_RESP) {
-                nbtx_last_resp_handle_map[id] = h;
-            }
+        if(st.resp.is_valid()) {
+            st.resp.end_transaction(t);
+            if(phase == axi::END_PARTIAL_RESP)
+                st.last_resp = st.resp;
+            st.resp = SCVNS scv_tr_handle();
         }
+        if(phase == tlm::END_RESP)
+            release_tx_state(trans, this);
     } else
         sc_assert(!"phase not supported!");
     return;
@@ -580,7 +665,7 @@ template <typename TYPES> bool axi_recorder<TYPES>::get_direct_mem_ptr(typename
         initialize_streams();
     SCVNS scv_tr_handle h = dmi_trGetHandle->begin_transaction();
     bool status = get_fw_if()->get_direct_mem_ptr(trans, dmi_data);
-    tlm::scc::scv::record(h, trans);
+    record_trans(h, trans);
     tlm::scc::scv::record(h, dmi_data);
     h.end_transaction();
     return status;
@@ -68,6 +68,8 @@ public:
 
 private:
     void start_of_simulation() override { BASE::initialize_streams(); }
+
+    void end_of_simulation() override { BASE::end_of_simulation(); }
 };
 
 template <unsigned int BUSWIDTH = 32>
@@ -0,0 +1,428 @@
+/*
+ * Copyright 2023 Arteris IP
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "trace_file.h"
+#include "axi_tlm.h"
+#include "interned_attributes.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <systemc>
+#include <unordered_map>
+
+namespace axi {
+namespace {
+const size_t FILE_BUFFER_SIZE = 1 << 20;
+const size_t BLOCK_SIZE = 1 << 16;
+const unsigned COLUMNS = 11;
+
+inline void put_varint(std::string& out, uint64_t val) {
+    while(val >= 0x80) {
+        out.push_back(static_cast<char>(val | 0x80));
+        val >>= 7;
+    }
+    out.push_back(static_cast<char>(val));
+}
+
+inline bool get_varint(char const*& p, char const* end, uint64_t& val) {
+    val = 0;
+    for(unsigned shift = 0; p != end && shift < 64; shift += 7) {
+        auto byte = static_cast<uint8_t>(*p++);
+        val |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        if(!(byte & 0x80))
+            return true;
+    }
+    return false;
+}
+
+inline uint64_t zigzag(uint64_t cur, uint64_t prev) {
+    auto diff = static_cast<int64_t>(cur - prev);
+    return (static_cast<uint64_t>(diff) << 1) ^ static_cast<uint64_t>(diff >> 63);
+}
+
+inline uint64_t unzigzag(uint64_t val, uint64_t prev) { return prev + ((val >> 1) ^ (~(val & 1) + 1)); }
+
+// encodes one column of the records, the column is prefixed by its size
+template <typename F> void put_column(std::string& out, std::string& col, std::vector<trace_record> const& records, F f) {
+    col.clear();
+    for(auto const& r : records)
+        f(col, r);
+    put_varint(out, col.size());
+    out.append(col);
+}
+
+void put_block(std::ofstream& ofs, trace_block type, std::string const& content) {
+    std::string hdr;
+    hdr.push_back(static_cast<char>(type));
+    put_varint(hdr, content.size());
+    ofs.write(hdr.data(), hdr.size());
+    ofs.write(content.data(), content.size());
+}
+
+struct writer_registry {
+    std::unordered_map<std::string, std::unique_ptr<trace_writer>> writers;
+    std::mutex mtx;
+    ~writer_registry() {
+        for(auto& e : writers)
+            e.second->close();
+    }
+};
+
+writer_registry& get_registry() {
+    static writer_registry registry;
+    return registry;
+}
+} // namespace
+
+void fill_axi_trace_record(trace_record& r, tlm::tlm_generic_payload const& trans) {
+    r.addr = trans.get_address();
+    r.flags = trans.is_write() ? TRACE_WRITE : 0;
+    if(auto* e = trans.get_extension<ace_extension>()) {
+        r.id = e->get_id();
+        r.len = e->get_length() + 1;
+        r.size = e->get_size();
+        r.resp = static_cast<uint8_t>(e->get_resp());
+        r.opcode = static_cast<uint16_t>(e->get_snoop());
+        // RACK/WACK are optional, they are only sent if the initiator is configured to
+        r.flags |= TRACE_ACK;
+    } else if(auto* e = trans.get_extension<axi4_extension>()) {
+        r.id = e->get_id();
+        r.len = e->get_length() + 1;
+        r.size = e->get_size();
+        r.resp = static_cast<uint8_t>(e->get_resp());
+    } else if(auto* e = trans.get_extension<axi3_extension>()) {
+        r.id = e->get_id();
+        r.len = e->get_length() + 1;
+        r.size = e->get_size();
+        r.resp = static_cast<uint8_t>(e->get_resp());
+    }
+}
+
+trace_writer& trace_writer::get(std::string const& name) {
+    auto& registry = get_registry();
+    std::lock_guard<std::mutex> lock(registry.mtx);
+    auto& writer = registry.writers[name];
+    if(!writer)
+        writer.reset(new trace_writer(name, BLOCK_SIZE));
+    return *writer;
+}
+
+void trace_writer::close_all() {
+    auto& registry = get_registry();
+    std::lock_guard<std::mutex> lock(registry.mtx);
+    for(auto& e : registry.writers)
+        e.second->close();
+}
+
+uint64_t trace_writer::get_time_resolution() {
+    return static_cast<uint64_t>(std::llround(sc_core::sc_get_time_resolution().to_seconds() * 1e15));
+}
+
+trace_writer::trace_writer(std::string const& name, size_t block_size)
+: block_size(block_size)
+, buffer(FILE_BUFFER_SIZE) {
+    block.reserve(block_size);
+    ofs.rdbuf()->pubsetbuf(buffer.data(), buffer.size());
+    ofs.open(name, std::ios::out | std::ios::binary | std::ios::trunc);
+    if(!ofs.is_open())
+        return;
+    ofs.write(TRACE_MAGIC, sizeof(TRACE_MAGIC));
+    writer_thread = std::thread([this]() { writer_loop(); });
+}
+
+trace_writer::~trace_writer() { close(); }
+
+uint16_t trace_writer::add_stream(std::string const& name) {
+    std::lock_guard<std::mutex> lock(queue_mtx);
+    streams.push_back(name);
+    return static_cast<uint16_t>(streams.size() - 1);
+}
+
+void trace_writer::add_phases(unsigned max_id) {
+    std::lock_guard<std::mutex> lock(queue_mtx);
+    for(; known_phases <= max_id; ++known_phases)
+        phases.push_back(phase_name(tlm::tlm_phase(known_phases)));
+}
+
+void trace_writer::submit() {
+    std::vector<trace_record> next;
+    next.reserve(block_size);
+    std::swap(next, block);
+    {
+        std::lock_guard<std::mutex> lock(queue_mtx);
+        write_queue.emplace_back(std::move(next));
+    }
+    queue_cv.notify_one();
+}
+
+void trace_writer::close() {
+    if(!writer_thread.joinable())
+        return;
+    {
+        std::lock_guard<std::mutex> lock(queue_mtx);
+        if(block.size())
+            write_queue.emplace_back(std::move(block));
+        block.clear();
+        stop = true;
+    }
+    queue_cv.notify_one();
+    writer_thread.join();
+    ofs.close();
+}
+
+void trace_writer::writer_loop() {
+    std::unique_lock<std::mutex> lock(queue_mtx);
+    while(true) {
+        queue_cv.wait(lock, [this]() { return stop || !write_queue.empty(); });
+        while(!write_queue.empty()) {
+            auto next = std::move(write_queue.front());
+            write_queue.pop_front();
+            write_names();
+            lock.unlock();
+            write_block(next);
+            lock.lock();
+        }
+        if(stop)
+            break;
+    }
+    write_names();
+}
+// needs to be called with the queue mutex locked
+void trace_writer::write_names() {
+    for(; written_streams < streams.size(); ++written_streams) {
+        std::string content;
+        put_varint(content, written_streams);
+        content.append(streams[written_streams]);
+        put_block(ofs, trace_block::STREAM, content);
+    }
+    for(; written_phases < phases.size(); ++written_phases) {
+        std::string content;
+        put_varint(content, written_phases);
+        content.append(phases[written_phases]);
+        put_block(ofs, trace_block::PHASE, content);
+    }
+}
+
+void trace_writer::write_block(std::vector<trace_record> const& records) {
+    if(!resolution_written) {
+        std::string content;
+        put_varint(content, resolution);
+        put_block(ofs, trace_block::RESOLUTION, content);
+        resolution_written = true;
+    }
+    encoded.clear();
+    put_varint(encoded, records.size());
+    std::string col;
+    uint64_t prev = 0;
+    put_column(encoded, col, records, [&prev](std::string& out, trace_record const& r) {
+        put_varint(out, zigzag(r.time, prev));
+        prev = r.time;
+    });
+    prev = 0;
+    put_column(encoded, col, records, [&prev](std::string& out, trace_record const& r) {
+        put_varint(out, zigzag(r.tx, prev));
+        prev = r.tx;
+    });
+    prev = 0;
+    put_column(encoded, col, records, [&prev](std::string& out, trace_record const& r) {
+        put_varint(out, zigzag(r.addr, prev));
+        prev = r.addr;
+    });
+    put_column(encoded, col, records, [](std::string& out, trace_record const& r) { put_varint(out, r.id); });
+    put_column(encoded, col, records, [](std::string& out, trace_record const& r) { put_varint(out, r.phase); });
+    put_column(encoded, col, records, [](std::string& out, trace_record const& r) { put_varint(out, r.stream); });
+    put_column(encoded, col, records, [](std::string& out, trace_record const& r) { put_varint(out, r.len); });
+    put_column(encoded, col, records, [](std::string& out, trace_record const& r) { put_varint(out, r.opcode); });
+    put_column(encoded, col, records, [](std::string& out, trace_record const& r) { out.push_back(static_cast<char>(r.flags)); });
+    put_column(encoded, col, records, [](std::string& out, trace_record const& r) { out.push_back(static_cast<char>(r.size)); });
+    put_column(encoded, col, records, [](std::string& out, trace_record const& r) { out.push_back(static_cast<char>(r.resp)); });
+    put_block(ofs, trace_block::DATA, encoded);
+}
+
+trace_reader::trace_reader()
+: buffer(FILE_BUFFER_SIZE) {}
+
+bool trace_reader::open(std::string const& name) {
+    ifs.rdbuf()->pubsetbuf(buffer.data(), buffer.size());
+    ifs.open(name, std::ios::in | std::ios::binary);
+    if(!ifs.is_open())
+        return false;
+    char magic[sizeof(TRACE_MAGIC)];
+    if(!ifs.read(magic, sizeof(magic)) || std::memcmp(magic, TRACE_MAGIC, sizeof(magic))) {
+        ifs.close();
+        return false;
+    }
+    return true;
+}
+
+bool trace_reader::read_raw(std::string& raw) {
+    auto const status = read_block(trace_block::DATA, raw);
+    if(status == block_status::CORRUPTED)
+        corrupted = true;
+    return status == block_status::FOUND;
+}
+
+trace_reader::block_status trace_reader::read_block(trace_block wanted, std::string& raw) {
+    while(true) {
+        auto type = ifs.get();
+        if(type == std::char_traits<char>::eof())
+            return block_status::END;
+        uint64_t size = 0;
+        for(unsigned shift = 0;; shift += 7) {
+            auto byte = ifs.get();
+            if(byte == std::char_traits<char>::eof() || shift >= 64)
+                return block_status::CORRUPTED;
+            size |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if(!(byte & 0x80))
+                break;
+        }
+        raw.resize(size);
+        if(size && !ifs.read(&raw[0], size))
+            return block_status::CORRUPTED;
+        char const* p = raw.data();
+        char const* end = p + raw.size();
+        uint64_t val;
+        switch(static_cast<trace_block>(type)) {
+        case trace_block::STREAM:
+            if(!get_varint(p, end, val))
+                return block_status::CORRUPTED;
+            if(val >= streams.size())
+                streams.resize(val + 1);
+            streams[val].assign(p, end);
+            break;
+        case trace_block::PHASE:
+            if(!get_varint(p, end, val))
+                return block_status::CORRUPTED;
+            if(val >= phases.size())
+                phases.resize(val + 1);
+            phases[val].assign(p, end);
+            break;
+        case trace_block::RESOLUTION:
+            if(!get_varint(p, end, resolution))
+                return block_status::CORRUPTED;
+            break;
+        default:
+            if(static_cast<trace_block>(type) == wanted)
+                return block_status::FOUND;
+            // other blocks are skipped, this allows later extensions of the format
+            break;
+        }
+    }
+}
+
+bool trace_reader::read_stimulus(std::vector<stimulus_record>& records) {
+    std::string raw;
+    block_status status;
+    while((status = read_block(trace_block::STIMULUS, raw)) == block_status::FOUND) {
+        if(raw.size() % sizeof(stimulus_record)) {
+            corrupted = true;
+            return false;
+        }
+        auto const offs = records.size();
+        records.resize(offs + raw.size() / sizeof(stimulus_record));
+        if(raw.size())
+            std::memcpy(&records[offs], raw.data(), raw.size());
+    }
+    if(status == block_status::CORRUPTED)
+        corrupted = true;
+    return !corrupted;
+}
+
+bool write_stimulus(std::string const& name, std::vector<stimulus_record> const& records) {
+    std::ofstream ofs(name, std::ios::out | std::ios::binary | std::ios::trunc);
+    if(!ofs.is_open())
+        return false;
+    ofs.write(TRACE_MAGIC, sizeof(TRACE_MAGIC));
+    for(size_t idx = 0; idx < records.size(); idx += BLOCK_SIZE) {
+        auto const count = std::min(BLOCK_SIZE, records.size() - idx);
+        put_block(ofs, trace_block::STIMULUS,
+                  std::string(reinterpret_cast<char const*>(&records[idx]), count * sizeof(stimulus_record)));
+    }
+    return ofs.good();
+}
+
+bool trace_reader::read(std::vector<trace_record>& records) {
+    std::string raw;
+    return read_raw(raw) && decode(raw, records);
+}
+
+bool trace_reader::decode(std::string const& raw, std::vector<trace_record>& records) {
+    char const* p = raw.data();
+    char const* end = p + raw.size();
+    uint64_t count;
+    // each record takes at least one byte per column, this rejects corrupt counts before allocating
+    if(!get_varint(p, end, count) || count > static_cast<uint64_t>(end - p) / COLUMNS)
+        return false;
+    records.clear();
+    records.resize(count);
+    for(unsigned c = 0; c < COLUMNS; ++c) {
+        uint64_t size;
+        if(!get_varint(p, end, size) || size > static_cast<uint64_t>(end - p))
+            return false;
+        char const* col = p;
+        char const* col_end = p + size;
+        p = col_end;
+        uint64_t val, prev = 0;
+        for(auto& r : records) {
+            if(c < 8) {
+                if(!get_varint(col, col_end, val))
+                    return false;
+            } else {
+                if(col == col_end)
+                    return false;
+                val = static_cast<uint8_t>(*col++);
+            }
+            switch(c) {
+            case 0:
+                r.time = prev = unzigzag(val, prev);
+                break;
+            case 1:
+                r.tx = prev = unzigzag(val, prev);
+                break;
+            case 2:
+                r.addr = prev = unzigzag(val, prev);
+                break;
+            case 3:
+                r.id = static_cast<uint32_t>(val);
+                break;
+            case 4:
+                r.phase = static_cast<uint32_t>(val);
+                break;
+            case 5:
+                r.stream = static_cast<uint16_t>(val);
+                break;
+            case 6:
+                r.len = static_cast<uint16_t>(val);
+                break;
+            case 7:
+                r.opcode = static_cast<uint16_t>(val);
+                break;
+            case 8:
+                r.flags = static_cast<uint8_t>(val);
+                break;
+            case 9:
+                r.size = static_cast<uint8_t>(val);
+                break;
+            default:
+                r.resp = static_cast<uint8_t>(val);
+                break;
+            }
+        }
+    }
+    return true;
+}
+} // namespace axi
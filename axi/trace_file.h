@@ -0,0 +1,261 @@
+/*
+ * Copyright 2023 Arteris IP
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <tlm>
+#include <vector>
+
+namespace axi {
+//! the flags of a trace_record
+enum trace_flags : uint8_t {
+    TRACE_WRITE = 1,    //!< the transaction is a write
+    TRACE_BW = 2,       //!< the phase was sent on the backward path
+    TRACE_RETURN = 4,   //!< the phase was returned by the callee (TLM_UPDATED or TLM_COMPLETED)
+    TRACE_BLOCKING = 8,  //!< the phase belongs to a blocking transaction
+    TRACE_SNOOP = 16,    //!< the transaction is a snoop
+    TRACE_CHI = 32,      //!< the transaction is a CHI transaction
+    TRACE_ACK = 64,      //!< the transaction may end with an ACK (ACE RACK/WACK or CHI CompAck)
+    TRACE_DATALESS = 128 //!< the CHI transaction transfers no data
+};
+/**
+ * @brief the fixed-width record of the compact trace format, one record is written per phase
+ *
+ * The time is given in units of the time resolution of the simulation which is stored in the trace file.
+ */
+struct trace_record {
+    uint64_t time{0};
+    //! the identity of the transaction, usually the address of the payload
+    uint64_t tx{0};
+    uint64_t addr{0};
+    //! the AXI ID resp. CHI TxnID
+    uint32_t id{0};
+    //! the id of the tlm_phase
+    uint32_t phase{0};
+    //! the stream (recorder) id as returned by trace_writer::add_stream()
+    uint16_t stream{0};
+    //! the burst length in beats
+    uint16_t len{0};
+    //! the AXI snoop type resp. CHI opcode
+    uint16_t opcode{0};
+    uint8_t flags{0};
+    //! the burst size in bytes as log2
+    uint8_t size{0};
+    uint8_t resp{0};
+};
+/**
+ * @brief fills the transaction fields of a record (address, id, burst, response, snoop and write flag) from an AXI/ACE
+ * payload
+ *
+ * @param r the record
+ * @param trans the payload
+ */
+void fill_axi_trace_record(trace_record& r, tlm::tlm_generic_payload const& trans);
+/**
+ * @brief a record of a stimulus trace replayed by the axi::pe::trace_player, one record is given per transaction
+ *
+ * The records are stored in host byte order in the STIMULUS blocks of a trace file, sorted by issue_cycle.
+ */
+struct stimulus_record {
+    //! the clock cycle (relative to the start of simulation) the transaction is issued
+    uint64_t issue_cycle;
+    uint64_t addr;
+    uint32_t id;
+    //! the 1-based index of the record which needs to be finished before this one is issued, 0 means none
+    uint32_t depends_on;
+    //! 0: read, 1: write
+    uint8_t cmd;
+    //! AxLEN
+    uint8_t length;
+    //! AxSIZE
+    uint8_t size;
+    //! AxBURST
+    uint8_t burst;
+    uint8_t cache;
+    uint8_t prot;
+    uint8_t qos;
+    uint8_t region;
+    //! the ACE domain, snoop and barrier, only used if STIMULUS_ACE is set
+    uint8_t domain;
+    uint8_t snoop;
+    uint8_t barrier;
+    //! a combination of the stimulus_flags
+    uint8_t flags;
+    uint32_t reserved;
+};
+static_assert(sizeof(stimulus_record) == 40, "unexpected size of stimulus_record");
+//! the flags of a stimulus_record
+enum stimulus_flags : uint8_t {
+    STIMULUS_ACE = 1,       //!< the transaction uses an ACE extension
+    STIMULUS_EXCLUSIVE = 2, //!< the transaction is an exclusive access
+    STIMULUS_UNIQUE = 4     //!< the ACE unique bit (AWUNIQUE) is set
+};
+//! the magic identifying the compact trace format
+constexpr char TRACE_MAGIC[8] = {'T', 'L', 'M', 'T', 'R', 'C', '0', '1'};
+/**
+ * @brief the block types of the compact trace format
+ *
+ * The file starts with TRACE_MAGIC followed by blocks of a type byte, the varint encoded size of the content and the
+ * content. Stream, phase and resolution blocks define the names of the stream and phase ids and the time unit used by
+ * the following data blocks. A data block holds a varint record count and the columns of the records. Each column is
+ * prefixed by its varint encoded size. Time, transaction and address are delta encoded relative to the previous record
+ * in the block and stored as zigzag varint, the remaining columns are varints resp. bytes. Blocks are decodable
+ * independently. A stimulus block holds stimulus_record structures.
+ */
+enum class trace_block : uint8_t { STREAM = 0, RESOLUTION = 1, DATA = 2, PHASE = 3, STIMULUS = 4 };
+/**
+ * @brief writes a stimulus trace for the axi::pe::trace_player
+ *
+ * @param name the file name
+ * @param records the records sorted by issue cycle
+ * @return false if the file could not be written
+ */
+bool write_stimulus(std::string const& name, std::vector<stimulus_record> const& records);
+/**
+ * @brief a writer for the compact columnar trace format. Records are collected in blocks which are encoded and written
+ * by a background thread so that the simulation does not wait for the file I/O.
+ *
+ * Writers are shared by file name so that several recorders can write into one trace.
+ */
+class trace_writer {
+public:
+    /**
+     * @brief get the writer of a file, the file is opened when it is requested the first time
+     * @param name the file name
+     * @return the writer, check is_open() to see if the file could be opened
+     */
+    static trace_writer& get(std::string const& name);
+    /**
+     * @brief writes all pending records and closes all trace files. This is also done when the program exits.
+     */
+    static void close_all();
+
+    ~trace_writer();
+
+    bool is_open() const { return ofs.is_open(); }
+    /**
+     * @brief register a stream (usually a recorder) writing to this trace
+     * @param name the name of the stream
+     * @return the stream id to be used in the records
+     */
+    uint16_t add_stream(std::string const& name);
+
+    inline void write(trace_record const& r) {
+        if(!resolution)
+            resolution = get_time_resolution();
+        if(r.phase >= known_phases)
+            add_phases(r.phase);
+        block.push_back(r);
+        if(block.size() >= block_size)
+            submit();
+    }
+    /**
+     * @brief write all pending records, stop the writer thread and close the file
+     */
+    void close();
+
+private:
+    trace_writer(std::string const& name, size_t block_size);
+    static uint64_t get_time_resolution();
+    void add_phases(unsigned max_id);
+    void submit();
+    void writer_loop();
+    void write_names();
+    void write_block(std::vector<trace_record> const& records);
+    size_t const block_size;
+    std::vector<char> buffer;
+    std::ofstream ofs;
+    std::vector<trace_record> block;
+    std::vector<std::string> streams;
+    size_t written_streams{0};
+    std::vector<std::string> phases;
+    size_t written_phases{0};
+    unsigned known_phases{0};
+    uint64_t resolution{0};
+    bool resolution_written{false};
+    std::string encoded;
+    std::deque<std::vector<trace_record>> write_queue;
+    std::mutex queue_mtx;
+    std::condition_variable queue_cv;
+    bool stop{false};
+    std::thread writer_thread;
+};
+/**
+ * @brief a sequential reader for the compact trace format
+ */
+class trace_reader {
+public:
+    trace_reader();
+    /**
+     * @brief open a trace file
+     * @param name the file name
+     * @return true if the file could be opened and has the right format
+     */
+    bool open(std::string const& name);
+
+    bool is_open() const { return ifs.is_open(); }
+    /**
+     * @brief read the next data block without decoding it, stream and resolution blocks are processed on the way
+     * @param raw the content of the data block
+     * @return false if the end of the file is reached or the file is corrupted, see is_corrupted()
+     */
+    bool read_raw(std::string& raw);
+    //! \return true if reading stopped at a truncated or malformed block instead of the end of the file
+    bool is_corrupted() const { return corrupted; }
+    /**
+     * @brief read and decode the next data block
+     * @param records the records of the block
+     * @return false if the end of the file is reached or the file is corrupted
+     */
+    bool read(std::vector<trace_record>& records);
+    /**
+     * @brief read the records of all remaining stimulus blocks
+     * @param records the records, new records are appended
+     * @return false if the file is corrupted
+     */
+    bool read_stimulus(std::vector<stimulus_record>& records);
+    /**
+     * @brief decode the content of a data block, can be called concurrently for different blocks
+     * @param raw the content of the data block
+     * @param records the records of the block
+     * @return false if the block is corrupted
+     */
+    static bool decode(std::string const& raw, std::vector<trace_record>& records);
+    //! the names of the streams read so far indexed by the stream id
+    std::vector<std::string> const& get_streams() const { return streams; }
+    //! the names of the phases read so far indexed by the phase id
+    std::vector<std::string> const& get_phases() const { return phases; }
+    //! the time resolution of the trace in femtoseconds, 0 if not known yet
+    uint64_t get_resolution() const { return resolution; }
+
+private:
+    enum class block_status { FOUND, END, CORRUPTED };
+    block_status read_block(trace_block type, std::string& raw);
+    std::vector<char> buffer;
+    std::ifstream ifs;
+    std::vector<std::string> streams;
+    std::vector<std::string> phases;
+    uint64_t resolution{0};
+    bool corrupted{false};
+};
+} // namespace axi
@@ -0,0 +1,165 @@
+/*
+ * Copyright 2023 Arteris IP
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <tlm>
+#include <vector>
+
+namespace axi {
+/**
+ * @brief the base of the per transaction state a recorder keeps in the tx_state_ext of a payload
+ *
+ * The states are reference counted: the extension holds one reference, a recorder may take further ones e.g. for
+ * pending timed recordings which outlive the payload.
+ */
+struct tx_state_base {
+    void const* owner{nullptr};
+    tx_state_base* next{nullptr};
+    unsigned refs{0};
+
+    void acquire() { ++refs; }
+
+    void release() {
+        if(--refs == 0)
+            recycle();
+    }
+
+protected:
+    virtual ~tx_state_base() = default;
+    //! returns the state to its pool
+    virtual void recycle() = 0;
+};
+/**
+ * @brief the pooled per transaction state of a recorder holding DATA, e.g. the handles of the open timed transactions
+ *
+ * DATA needs to be default constructible, a recycled state is reset to a default constructed DATA.
+ */
+template <typename DATA> struct tx_state : public tx_state_base, public DATA {
+    static tx_state* create(void const* owner) {
+        auto& pool = free_list();
+        tx_state* ret;
+        if(pool.empty())
+            ret = new tx_state();
+        else {
+            ret = pool.back();
+            pool.pop_back();
+        }
+        ret->owner = owner;
+        ret->refs = 1;
+        return ret;
+    }
+
+private:
+    void recycle() override {
+        static_cast<DATA&>(*this) = DATA();
+        owner = nullptr;
+        next = nullptr;
+        free_list().push_back(this);
+    }
+    // the pool is never freed as payloads of a memory manager may release their extensions during static destruction
+    static std::vector<tx_state*>& free_list() {
+        static auto* pool = new std::vector<tx_state*>();
+        return *pool;
+    }
+};
+/**
+ * @brief the pooled extension carrying the states of all recorders along the path of a transaction
+ *
+ * Each recorder finds its state by a short list walk instead of a hash map lookup keyed by the payload address. The
+ * extension is not copied to other payloads.
+ */
+struct tx_state_ext : public tlm::tlm_extension<tx_state_ext> {
+    tx_state_base* states{nullptr};
+
+    static tx_state_ext* create() {
+        auto& pool = free_list();
+        if(pool.empty())
+            return new tx_state_ext();
+        auto* ret = pool.back();
+        pool.pop_back();
+        return ret;
+    }
+
+    tlm::tlm_extension_base* clone() const override { return nullptr; }
+
+    void copy_from(tlm::tlm_extension_base const&) override {}
+
+    void free() override {
+        while(states) {
+            auto* s = states;
+            states = s->next;
+            s->next = nullptr;
+            s->release();
+        }
+        free_list().push_back(this);
+    }
+
+private:
+    static std::vector<tx_state_ext*>& free_list() {
+        static auto* pool = new std::vector<tx_state_ext*>();
+        return *pool;
+    }
+};
+/**
+ * @brief get the state of a recorder for a transaction, creates it if there is none
+ *
+ * @param trans the payload of the transaction
+ * @param owner the recorder
+ * @return the state
+ */
+template <typename STATE> inline STATE* get_tx_state(tlm::tlm_generic_payload& trans, void const* owner) {
+    auto* ext = trans.get_extension<tx_state_ext>();
+    if(!ext) {
+        ext = tx_state_ext::create();
+        if(trans.has_mm())
+            trans.set_auto_extension(ext);
+        else
+            trans.set_extension(ext);
+    }
+    for(auto* s = ext->states; s; s = s->next)
+        if(s->owner == owner)
+            return static_cast<STATE*>(s);
+    auto* s = STATE::create(owner);
+    s->next = ext->states;
+    ext->states = s;
+    return s;
+}
+/**
+ * @brief releases the state of a recorder once a transaction is finished
+ *
+ * Payloads with memory manager release the states automatically, payloads without need to release them explicitly.
+ * @param trans the payload of the transaction
+ * @param owner the recorder
+ */
+inline void release_tx_state(tlm::tlm_generic_payload& trans, void const* owner) {
+    auto* ext = trans.get_extension<tx_state_ext>();
+    if(!ext)
+        return;
+    for(auto** s = &ext->states; *s; s = &(*s)->next)
+        if((*s)->owner == owner) {
+            auto* state = *s;
+            *s = state->next;
+            state->next = nullptr;
+            state->release();
+            break;
+        }
+    if(!ext->states && !trans.has_mm()) {
+        trans.clear_extension<tx_state_ext>();
+        ext->free();
+    }
+}
+} // namespace axi
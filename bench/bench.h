@@ -0,0 +1,166 @@
+/*
+ * Copyright 2021 Arteris IP
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#ifndef _MSC_VER
+#include <sys/resource.h>
+#endif
+
+//! a minimal self-contained benchmark harness
+namespace bench {
+//! prevent the compiler from optimizing away the computation of a value
+template <typename T> inline void do_not_optimize(T const& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile char const* sink;
+    sink = reinterpret_cast<char const*>(&value);
+#endif
+}
+
+using clock = std::chrono::steady_clock;
+
+inline double elapsed_ns(clock::time_point start, clock::time_point end) {
+    return std::chrono::duration<double, std::nano>(end - start).count();
+}
+
+//! the peak resident set size of the process in KiB, 0 if it cannot be determined
+inline uint64_t peak_rss_kb() {
+#ifdef _MSC_VER
+    return 0;
+#else
+    struct rusage usage;
+    if(getrusage(RUSAGE_SELF, &usage))
+        return 0;
+#ifdef __APPLE__
+    return usage.ru_maxrss / 1024;
+#else
+    return usage.ru_maxrss;
+#endif
+#endif
+}
+/**
+ * @brief looks up a command line option of the form <prefix><value>, e.g. --mix=single
+ * @return the value of the last occurrence or the default value if the option is not given
+ */
+inline std::string get_option(int argc, char* argv[], char const* prefix, std::string const& default_value = "") {
+    auto len = std::strlen(prefix);
+    std::string ret = default_value;
+    for(int i = 1; i < argc; ++i)
+        if(!std::strncmp(argv[i], prefix, len))
+            ret = argv[i] + len;
+    return ret;
+}
+//! checks if a command line flag is given
+inline bool has_flag(int argc, char* argv[], char const* flag) {
+    for(int i = 1; i < argc; ++i)
+        if(!std::strcmp(argv[i], flag))
+            return true;
+    return false;
+}
+
+struct result {
+    std::string name;
+    uint64_t iterations;
+    double ns_per_op;
+};
+/**
+ * @brief runs benchmarks and reports the results as table or CSV
+ *
+ * Command line options: --filter=<substring> runs only benchmarks whose name contains the substring, --csv prints CSV
+ * and --min-time=<seconds> sets the minimum measurement time of a benchmark (default 0.2s).
+ */
+class runner {
+public:
+    runner(int argc, char* argv[]) {
+        for(int i = 1; i < argc; ++i) {
+            if(!std::strncmp(argv[i], "--filter=", 9))
+                filter = argv[i] + 9;
+            else if(!std::strcmp(argv[i], "--csv"))
+                csv = true;
+            else if(!std::strncmp(argv[i], "--min-time=", 11))
+                min_time_ns = std::atof(argv[i] + 11) * 1e9;
+        }
+    }
+
+    bool enabled(std::string const& name) const { return filter.empty() || name.find(filter) != std::string::npos; }
+    /**
+     * @brief run a benchmark
+     *
+     * The function is called with the number of iterations to execute, the number is increased until the execution
+     * takes at least the minimum measurement time.
+     * @param name the name of the benchmark
+     * @param func a callable taking the number of iterations as uint64_t
+     * @param ops_per_iteration the number of operations executed per iteration, the result is reported per operation
+     */
+    template <typename F> void run(std::string const& name, F&& func, unsigned ops_per_iteration = 1) {
+        if(!enabled(name))
+            return;
+        func(1); // warm up
+        uint64_t iterations = 1;
+        while(true) {
+            auto start = clock::now();
+            func(iterations);
+            auto ns = elapsed_ns(start, clock::now());
+            if(ns >= min_time_ns || iterations >= (uint64_t(1) << 40)) {
+                report(name, iterations * ops_per_iteration, ns);
+                return;
+            }
+            auto factor = ns > 0 ? min_time_ns * 1.2 / ns : 100.0;
+            iterations = static_cast<uint64_t>(iterations * std::min(100.0, std::max(2.0, factor)));
+        }
+    }
+    /**
+     * @brief report a measurement taken by the caller
+     */
+    void report(std::string const& name, uint64_t iterations, double total_ns) {
+        if(!enabled(name))
+            return;
+        results.push_back({name, iterations, total_ns / iterations});
+        auto const& r = results.back();
+        if(csv) {
+            if(results.size() == 1)
+                std::printf("name,iterations,ns_per_op,mops_per_s\n");
+            std::printf("%s,%llu,%.3f,%.3f\n", r.name.c_str(), static_cast<unsigned long long>(r.iterations), r.ns_per_op,
+                        1e3 / r.ns_per_op);
+        } else {
+            if(results.size() == 1)
+                std::printf("%-56s %14s %12s %12s\n", "benchmark", "iterations", "ns/op", "Mops/s");
+            std::printf("%-56s %14llu %12.3f %12.3f\n", r.name.c_str(), static_cast<unsigned long long>(r.iterations), r.ns_per_op,
+                        1e3 / r.ns_per_op);
+        }
+        std::fflush(stdout);
+    }
+
+    std::vector<result> const& get_results() const { return results; }
+
+private:
+    std::string filter;
+    bool csv{false};
+    double min_time_ns{2e8};
+    std::vector<result> results;
+};
+
+} // namespace bench
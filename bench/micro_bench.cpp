@@ -0,0 +1,306 @@
+/*
+ * Copyright 2021 Arteris IP
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "bench.h"
+#include <array>
+#include <axi/axi_tlm.h>
+#include <axi/checker/axi_protocol.h>
+#include <axi/fsm/base.h>
+#include <chi/chi_tlm.h>
+#include <chi/pe/chi_rn_initiator.h>
+#include <scc/report.h>
+#include <sstream>
+#include <systemc>
+#include <tlm/scc/tlm_gp_shared.h>
+#include <tlm/scc/tlm_mm.h>
+
+namespace {
+constexpr unsigned BUS_WIDTH_BYTES = 8;
+
+template <typename EXT> tlm::scc::tlm_gp_shared_ptr make_axi_payload(bool write, unsigned id, unsigned beats, unsigned size = 3) {
+    auto len = beats << size;
+    tlm::scc::tlm_gp_shared_ptr gp = tlm::scc::tlm_mm<>::get().allocate<EXT>(len);
+    auto* ext = gp->template get_extension<EXT>();
+    gp->set_command(write ? tlm::TLM_WRITE_COMMAND : tlm::TLM_READ_COMMAND);
+    gp->set_address(0x1000);
+    gp->set_data_length(len);
+    gp->set_streaming_width(len);
+    ext->set_id(id);
+    ext->set_length(beats - 1);
+    ext->set_size(size);
+    ext->set_burst(axi::burst_e::INCR);
+    return gp;
+}
+
+tlm::scc::tlm_gp_shared_ptr make_ace_payload(bool write, unsigned id, unsigned beats, unsigned size = 3) {
+    auto gp = make_axi_payload<axi::ace_extension>(write, id, beats, size);
+    auto* ext = gp->get_extension<axi::ace_extension>();
+    ext->set_domain(axi::domain_e::NON_SHAREABLE);
+    ext->set_snoop(write ? axi::snoop_e::WRITE_NO_SNOOP : axi::snoop_e::READ_NO_SNOOP);
+    ext->set_barrier(axi::bar_e::RESPECT_BARRIER);
+    return gp;
+}
+//! a protocol FSM without any reactions, measures the cost of the FSM dispatch itself
+struct bench_fsm : public axi::fsm::base {
+    bench_fsm()
+    : axi::fsm::base(BUS_WIDTH_BYTES) {}
+    axi::fsm::fsm_handle* create_fsm_handle() override { return new axi::fsm::fsm_handle(); }
+    void setup_callbacks(axi::fsm::fsm_handle*) override {}
+};
+
+struct micro_bench : public sc_core::sc_module {
+    bench::runner& runner;
+    bench_fsm fsm;
+
+    micro_bench(sc_core::sc_module_name const& nm, bench::runner& runner)
+    : sc_core::sc_module(nm)
+    , runner(runner) {
+#if SYSTEMC_VERSION < 20250221
+        SC_HAS_PROCESS(micro_bench);
+#endif
+        SC_THREAD(run);
+    }
+
+    void run() {
+        bench_payload_helpers();
+        bench_validation();
+        bench_fsm_react();
+        bench_conversion();
+        bench_formatter();
+        bench_checker();
+        sc_core::sc_stop();
+    }
+
+    void bench_payload_helpers() {
+        std::array<std::pair<char const*, tlm::scc::tlm_gp_shared_ptr>, 3> gps{
+            {{"ace", make_ace_payload(false, 5, 4)},
+             {"axi4", make_axi_payload<axi::axi4_extension>(false, 5, 4)},
+             {"axi3", make_axi_payload<axi::axi3_extension>(false, 5, 4)}}};
+        for(auto& e : gps) {
+            auto& gp = *e.second;
+            runner.run(std::string("get_axi_id/") + e.first, [&gp](uint64_t n) {
+                for(uint64_t i = 0; i < n; ++i)
+                    bench::do_not_optimize(axi::get_axi_id(gp));
+            });
+            runner.run(std::string("get_burst_length/") + e.first, [&gp](uint64_t n) {
+                for(uint64_t i = 0; i < n; ++i)
+                    bench::do_not_optimize(axi::get_burst_length(gp));
+            });
+        }
+    }
+
+    void bench_validation() {
+        auto ace_gp = make_ace_payload(false, 5, 4);
+        auto* ace_ext = ace_gp->get_extension<axi::ace_extension>();
+        runner.run("is_valid_msg/ace", [ace_ext](uint64_t n) {
+            for(uint64_t i = 0; i < n; ++i)
+                bench::do_not_optimize(axi::is_valid_msg(ace_ext));
+        });
+        auto axi_gp = make_axi_payload<axi::axi4_extension>(false, 5, 4);
+        auto* axi_ext = axi_gp->get_extension<axi::axi4_extension>();
+        runner.run("is_valid_msg/axi4", [axi_ext](uint64_t n) {
+            for(uint64_t i = 0; i < n; ++i)
+                bench::do_not_optimize(axi::is_valid_msg(axi_ext));
+        });
+        chi::chi_ctrl_extension chi_ext;
+        chi_ext.set_txn_id(5);
+        chi_ext.req.set_opcode(chi::req_optype_e::ReadNoSnp);
+        chi_ext.req.set_size(6);
+        runner.run("is_valid_msg/chi_ctrl", [&chi_ext](uint64_t n) {
+            for(uint64_t i = 0; i < n; ++i)
+                bench::do_not_optimize(chi::is_valid_msg(&chi_ext));
+        });
+    }
+    /**
+     * measures each event separately, the overhead of the time measurement is subtracted
+     */
+    void bench_fsm_react() {
+        constexpr unsigned TXN_CNT = 100000;
+        constexpr unsigned BEATS = 4;
+        if(!runner.enabled("fsm::base::react"))
+            return;
+        auto overhead = 0.0;
+        {
+            constexpr unsigned CAL_CNT = 1000000;
+            auto total = 0.0;
+            for(unsigned i = 0; i < CAL_CNT; ++i) {
+                auto start = bench::clock::now();
+                total += bench::elapsed_ns(start, bench::clock::now());
+            }
+            overhead = total / CAL_CNT;
+        }
+        std::array<double, axi::fsm::CB_CNT + 1> ns{};
+        std::array<uint64_t, axi::fsm::CB_CNT + 1> cnt{};
+        auto const find_idx = axi::fsm::CB_CNT;
+        auto timed_react = [this, &ns, &cnt, overhead](axi::fsm::protocol_time_point_e e, axi::fsm::fsm_handle* h) {
+            auto start = bench::clock::now();
+            fsm.react(e, h);
+            ns[e] += bench::elapsed_ns(start, bench::clock::now()) - overhead;
+            cnt[e]++;
+        };
+        auto rd = make_axi_payload<axi::axi4_extension>(false, 1, BEATS);
+        auto wr = make_axi_payload<axi::axi4_extension>(true, 2, BEATS);
+        for(unsigned i = 0; i < TXN_CNT; ++i) {
+            auto start = bench::clock::now();
+            auto* h = fsm.find_or_create(rd.get());
+            ns[find_idx] += bench::elapsed_ns(start, bench::clock::now()) - overhead;
+            cnt[find_idx]++;
+            timed_react(axi::fsm::RequestPhaseBeg, h);
+            timed_react(axi::fsm::EndReqE, h);
+            for(unsigned b = 0; b < BEATS - 1; ++b) {
+                timed_react(axi::fsm::BegPartRespE, h);
+                timed_react(axi::fsm::EndPartRespE, h);
+            }
+            timed_react(axi::fsm::BegRespE, h);
+            timed_react(axi::fsm::EndRespE, h);
+
+            start = bench::clock::now();
+            h = fsm.find_or_create(wr.get());
+            ns[find_idx] += bench::elapsed_ns(start, bench::clock::now()) - overhead;
+            cnt[find_idx]++;
+            timed_react(axi::fsm::RequestPhaseBeg, h);
+            timed_react(axi::fsm::EndPartReqE, h);
+            for(unsigned b = 1; b < BEATS - 1; ++b) {
+                timed_react(axi::fsm::BegPartReqE, h);
+                timed_react(axi::fsm::EndPartReqE, h);
+            }
+            timed_react(axi::fsm::BegReqE, h);
+            timed_react(axi::fsm::EndReqE, h);
+            timed_react(axi::fsm::BegRespE, h);
+            timed_react(axi::fsm::EndRespE, h);
+        }
+        runner.report("fsm::base::find_or_create", cnt[find_idx], ns[find_idx]);
+        for(unsigned e = 0; e < axi::fsm::CB_CNT; ++e)
+            if(cnt[e])
+                runner.report(std::string("fsm::base::react/") + axi::fsm::evt2str(e), cnt[e], ns[e]);
+    }
+
+    void bench_conversion() {
+        runner.run("payload allocation/axi4 (baseline)", [](uint64_t n) {
+            for(uint64_t i = 0; i < n; ++i)
+                bench::do_not_optimize(make_axi_payload<axi::axi4_extension>(i & 1, i & 0xf, 1, 6).get());
+        });
+        runner.run("convert_axi4ace_to_chi/axi4 (incl. allocation)", [](uint64_t n) {
+            for(uint64_t i = 0; i < n; ++i) {
+                auto gp = make_axi_payload<axi::axi4_extension>(i & 1, i & 0xf, 1, 6);
+                chi::pe::convert_axi4ace_to_chi(*gp, "bench");
+                bench::do_not_optimize(gp->get_extension<chi::chi_ctrl_extension>());
+            }
+        });
+        runner.run("payload allocation/ace (baseline)", [](uint64_t n) {
+            for(uint64_t i = 0; i < n; ++i)
+                bench::do_not_optimize(make_ace_payload(i & 1, i & 0xf, 1, 6).get());
+        });
+        runner.run("convert_axi4ace_to_chi/ace (incl. allocation)", [](uint64_t n) {
+            for(uint64_t i = 0; i < n; ++i) {
+                auto gp = make_ace_payload(i & 1, i & 0xf, 1, 6);
+                chi::pe::convert_axi4ace_to_chi(*gp, "bench");
+                bench::do_not_optimize(gp->get_extension<chi::chi_ctrl_extension>());
+            }
+        });
+    }
+
+    void bench_formatter() {
+        std::ostringstream os;
+        auto axi_gp = make_axi_payload<axi::axi4_extension>(false, 5, 4);
+        runner.run("operator<</axi4", [&os, &axi_gp](uint64_t n) {
+            for(uint64_t i = 0; i < n; ++i) {
+                os.str("");
+                axi::operator<<(os, *axi_gp);
+            }
+        });
+        auto ace_gp = make_ace_payload(false, 5, 4);
+        runner.run("operator<</ace", [&os, &ace_gp](uint64_t n) {
+            for(uint64_t i = 0; i < n; ++i) {
+                os.str("");
+                axi::operator<<(os, *ace_gp);
+            }
+        });
+        auto chi_gp = make_axi_payload<axi::axi4_extension>(false, 5, 1, 6);
+        chi::pe::convert_axi4ace_to_chi(*chi_gp, "bench");
+        runner.run("operator<</chi", [&os, &chi_gp](uint64_t n) {
+            for(uint64_t i = 0; i < n; ++i) {
+                os.str("");
+                chi::operator<<(os, *chi_gp);
+            }
+        });
+    }
+
+    void bench_checker() {
+        axi::checker::axi_protocol checker("bench.checker", BUS_WIDTH_BYTES, 0, 0);
+        auto rd = make_axi_payload<axi::axi4_extension>(false, 1, 1);
+        runner.run(
+            "axi_protocol::fw_pre/bw_pre (single beat read)",
+            [&checker, &rd](uint64_t n) {
+                for(uint64_t i = 0; i < n; ++i) {
+                    checker.fw_pre(*rd, tlm::BEGIN_REQ);
+                    checker.bw_pre(*rd, tlm::END_REQ);
+                    checker.bw_pre(*rd, tlm::BEGIN_RESP);
+                    checker.fw_pre(*rd, tlm::END_RESP);
+                }
+            },
+            4);
+        auto wr = make_axi_payload<axi::axi4_extension>(true, 2, 4);
+        runner.run(
+            "axi_protocol::fw_pre/bw_pre (4 beat write)",
+            [&checker, &wr](uint64_t n) {
+                for(uint64_t i = 0; i < n; ++i) {
+                    for(unsigned b = 0; b < 3; ++b) {
+                        checker.fw_pre(*wr, axi::BEGIN_PARTIAL_REQ);
+                        checker.bw_pre(*wr, axi::END_PARTIAL_REQ);
+                    }
+                    checker.fw_pre(*wr, tlm::BEGIN_REQ);
+                    checker.bw_pre(*wr, tlm::END_REQ);
+                    checker.bw_pre(*wr, tlm::BEGIN_RESP);
+                    checker.fw_pre(*wr, tlm::END_RESP);
+                }
+            },
+            10);
+        axi::checker::axi_protocol sampled_checker("bench.sampled_checker", BUS_WIDTH_BYTES, 0, 0, 16);
+        runner.run(
+            "axi_protocol::fw_pre/bw_pre (single beat read, 1 in 16 sampled)",
+            [&sampled_checker, &rd](uint64_t n) {
+                for(uint64_t i = 0; i < n; ++i) {
+                    sampled_checker.fw_pre(*rd, tlm::BEGIN_REQ);
+                    sampled_checker.bw_pre(*rd, tlm::END_REQ);
+                    sampled_checker.bw_pre(*rd, tlm::BEGIN_RESP);
+                    sampled_checker.fw_pre(*rd, tlm::END_RESP);
+                }
+            },
+            4);
+        axi::checker::axi_protocol batched_checker("bench.batched_checker", BUS_WIDTH_BYTES, 0, 0, 1, 1024);
+        runner.run(
+            "axi_protocol::fw_pre/bw_pre (single beat read, batches of 1024)",
+            [&batched_checker, &rd](uint64_t n) {
+                for(uint64_t i = 0; i < n; ++i) {
+                    batched_checker.fw_pre(*rd, tlm::BEGIN_REQ);
+                    batched_checker.bw_pre(*rd, tlm::END_REQ);
+                    batched_checker.bw_pre(*rd, tlm::BEGIN_RESP);
+                    batched_checker.fw_pre(*rd, tlm::END_RESP);
+                }
+            },
+            4);
+    }
+};
+} // namespace
+
+int sc_main(int argc, char* argv[]) {
+    scc::init_logging(scc::LogConfig().logLevel(scc::log::WARNING).logAsync(false));
+    bench::runner runner(argc, argv);
+    micro_bench mb("micro_bench", runner);
+    sc_core::sc_start();
+    return 0;
+}
@@ -0,0 +1,40 @@
+#!/bin/sh
+# Copyright 2021 Arteris IP
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+# runs the throughput benchmark for all scenarios and prints the results as CSV
+# usage: run_throughput.sh <path to throughput_bench> [transactions]
+
+BENCH=${1:-./throughput_bench}
+TXNS=${2:-100000}
+HEADER=1
+for initiator in simple axi; do
+    for target in simple ordered reordering replay; do
+        for mix in single burst16 mixed many_ids; do
+            for recording in none none+checker lwtr lwtr+checker scv; do
+                case $recording in
+                    *+checker) opts="--recording=${recording%+checker} --checker";;
+                    *) opts="--recording=$recording";;
+                esac
+                out=$("$BENCH" --initiator=$initiator --target=$target --mix=$mix $opts --transactions=$TXNS --csv) || exit 1
+                if [ $HEADER -eq 1 ]; then
+                    echo "$out" | tail -n 2
+                    HEADER=0
+                else
+                    echo "$out" | tail -n 1
+                fi
+            done
+        done
+    done
+done
@@ -0,0 +1,245 @@
+/*
+ * Copyright 2021 Arteris IP
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SC_INCLUDE_DYNAMIC_PROCESSES
+#define SC_INCLUDE_DYNAMIC_PROCESSES
+#endif
+
+#include "bench.h"
+#include <axi/axi_tlm.h>
+#include <axi/lwtr/axi_lwtr.h>
+#include <axi/pe/axi_initiator.h>
+#include <axi/pe/ordered_target.h>
+#include <axi/pe/reordering_target.h>
+#include <axi/pe/replay_target.h>
+#include <axi/pe/simple_initiator.h>
+#include <axi/pe/simple_target.h>
+#include <axi/scv/recorder_modules.h>
+#include <cci_configuration>
+#include <memory>
+#include <scc/report.h>
+#include <scc/tracer.h>
+#include <systemc>
+#include <tlm/scc/pe/intor_if.h>
+#include <tlm/scc/tlm_gp_shared.h>
+#include <tlm/scc/tlm_mm.h>
+
+namespace {
+constexpr unsigned BUSWIDTH = 64;
+//! log2 of the number of bytes per beat
+constexpr unsigned BEAT_SIZE = 3;
+
+struct bench_config {
+    //! simple or axi
+    std::string initiator;
+    //! simple, ordered, reordering or replay
+    std::string target;
+    //! none, scv or lwtr
+    std::string recording;
+    //! single, burst16, mixed or many_ids
+    std::string mix;
+    bool checker;
+    uint64_t transactions;
+    unsigned outstanding;
+    bool csv;
+
+    bench_config(int argc, char* argv[])
+    : initiator(bench::get_option(argc, argv, "--initiator=", "axi"))
+    , target(bench::get_option(argc, argv, "--target=", "simple"))
+    , recording(bench::get_option(argc, argv, "--recording=", "none"))
+    , mix(bench::get_option(argc, argv, "--mix=", "single"))
+    , checker(bench::has_flag(argc, argv, "--checker"))
+    , transactions(std::strtoull(bench::get_option(argc, argv, "--transactions=", "100000").c_str(), nullptr, 10))
+    , outstanding(std::max(1UL, std::strtoul(bench::get_option(argc, argv, "--outstanding=", "16").c_str(), nullptr, 10)))
+    , csv(bench::has_flag(argc, argv, "--csv")) {}
+
+    std::string scenario() const {
+        return initiator + "/" + target + "/" + mix + "/" + recording + (checker ? "+checker" : "");
+    }
+};
+/**
+ * the transaction issued at a given index of a traffic mix. The mixes are deterministic so that runs are comparable.
+ */
+struct txn_desc {
+    bool write;
+    unsigned id;
+    unsigned beats;
+};
+
+txn_desc get_txn(std::string const& mix, uint64_t idx) {
+    static unsigned const mixed_beats[] = {1, 4, 8, 16};
+    if(mix == "burst16")
+        return {false, 0, 16};
+    if(mix == "mixed")
+        return {(idx & 1) != 0, static_cast<unsigned>(idx & 0x3), mixed_beats[(idx >> 1) & 0x3]};
+    if(mix == "many_ids")
+        return {(idx & 1) != 0, static_cast<unsigned>(idx & 0x3f), 4};
+    return {false, 0, 1};
+}
+/**
+ * issues the transactions of a traffic mix from outstanding worker threads and stops the simulation once all of them
+ * are finished
+ */
+class traffic_driver : public sc_core::sc_module {
+public:
+    sc_core::sc_port<tlm::scc::pe::intor_fw_b> fw_o{"fw_o"};
+
+    traffic_driver(sc_core::sc_module_name const& nm, bench_config const& cfg)
+    : sc_core::sc_module(nm)
+    , cfg(cfg) {}
+
+    bench::clock::time_point start_time, end_time;
+    uint64_t start_delta_count{0}, end_delta_count{0};
+
+private:
+    void start_of_simulation() override {
+        for(auto i = 0U; i < cfg.outstanding; ++i)
+            sc_core::sc_spawn([this]() { worker_thread(); }, sc_core::sc_gen_unique_name("worker"));
+        start_time = bench::clock::now();
+        start_delta_count = sc_core::sc_delta_count();
+    }
+
+    void worker_thread() {
+        while(next_idx < cfg.transactions) {
+            auto trans = create_payload(next_idx++);
+            fw_o->transport(*trans, false);
+            if(++finished_cnt == cfg.transactions) {
+                end_time = bench::clock::now();
+                end_delta_count = sc_core::sc_delta_count();
+                sc_core::sc_stop();
+            }
+        }
+    }
+
+    tlm::scc::tlm_gp_shared_ptr create_payload(uint64_t idx) {
+        auto desc = get_txn(cfg.mix, idx);
+        auto len = desc.beats * BUSWIDTH / 8;
+        tlm::scc::tlm_gp_shared_ptr trans = tlm::scc::tlm_mm<>::get().allocate<axi::axi4_extension>(len);
+        auto* ext = trans->get_extension<axi::axi4_extension>();
+        trans->set_command(desc.write ? tlm::TLM_WRITE_COMMAND : tlm::TLM_READ_COMMAND);
+        trans->set_address((idx * 1024) & 0xfffffULL);
+        trans->set_data_length(len);
+        trans->set_streaming_width(len);
+        ext->set_id(desc.id);
+        ext->set_length(desc.beats - 1);
+        ext->set_size(BEAT_SIZE);
+        ext->set_burst(axi::burst_e::INCR);
+        return trans;
+    }
+
+    bench_config const& cfg;
+    uint64_t next_idx{0}, finished_cnt{0};
+};
+/**
+ * the system under test: traffic_driver -> initiator PE -> [recorder] -> target
+ */
+class testbench : public sc_core::sc_module {
+public:
+    sc_core::sc_clock clk{"clk", 1.0, sc_core::SC_NS};
+    sc_core::sc_signal<bool> rst{"rst", false};
+    axi::axi_initiator_socket<BUSWIDTH> isck{"isck"};
+    traffic_driver driver;
+
+    testbench(sc_core::sc_module_name const& nm, bench_config const& cfg)
+    : sc_core::sc_module(nm)
+    , driver("driver", cfg) {
+        if(cfg.initiator == "simple") {
+            auto* intor = new axi::pe::simple_axi_initiator<BUSWIDTH>("intor", isck);
+            intor->clk_i(clk);
+            driver.fw_o(*intor);
+            initiator.reset(intor);
+        } else {
+            auto* intor = new axi::pe::axi_initiator<BUSWIDTH>("intor", isck);
+            intor->clk_i(clk);
+            driver.fw_o(*intor);
+            initiator.reset(intor);
+        }
+        axi::axi_target_socket<BUSWIDTH>* tsck{nullptr};
+        if(cfg.target == "ordered") {
+            auto* tgt = new axi::pe::ordered_target<BUSWIDTH>("target");
+            tgt->clk_i(clk);
+            tsck = &tgt->sckt;
+            target.reset(tgt);
+        } else if(cfg.target == "reordering") {
+            auto* tgt = new axi::pe::reordering_target<BUSWIDTH>("target");
+            tgt->clk_i(clk);
+            tsck = &tgt->sckt;
+            target.reset(tgt);
+        } else if(cfg.target == "replay") {
+            auto* tgt = new axi::pe::replay_target<BUSWIDTH>("target");
+            tgt->clk_i(clk);
+            tgt->rst_i(rst);
+            tsck = &tgt->sckt;
+            target.reset(tgt);
+        } else {
+            target_sckt.reset(new axi::axi_target_socket<BUSWIDTH>("tsck"));
+            auto* tgt = new axi::pe::simple_target<BUSWIDTH>("target", *target_sckt);
+            tgt->clk_i(clk);
+            tsck = target_sckt.get();
+            target.reset(tgt);
+        }
+        // the checker is part of the recorders, without recording a recorder with disabled tracing is inserted
+        if(cfg.recording == "scv") {
+            auto* rec = new axi::scv::axi_recorder_module<BUSWIDTH>("recorder");
+            isck(rec->tsckt);
+            rec->isckt(*tsck);
+            recorder.reset(rec);
+        } else if(cfg.recording == "lwtr" || cfg.checker) {
+            auto* rec = new axi::lwtr::axi_lwtr_recorder<BUSWIDTH>("recorder", cfg.recording == "lwtr");
+            isck(rec->ts);
+            rec->is(*tsck);
+            recorder.reset(rec);
+        } else
+            isck(*tsck);
+    }
+
+private:
+    std::unique_ptr<axi::axi_target_socket<BUSWIDTH>> target_sckt;
+    std::unique_ptr<sc_core::sc_module> initiator, target, recorder;
+};
+} // namespace
+
+int sc_main(int argc, char* argv[]) {
+    scc::init_logging(scc::LogConfig().logLevel(scc::log::WARNING).logAsync(false));
+    bench_config cfg(argc, argv);
+    if(cfg.checker)
+        cci::cci_get_global_broker(cci::cci_originator("sc_main"))
+            .set_preset_cci_value("tb.recorder.enableProtocolChecker", cci::cci_value(true));
+    std::unique_ptr<scc::tracer> trace;
+    if(cfg.recording != "none")
+        trace.reset(new scc::tracer("throughput_bench", scc::tracer::file_type::FTR, false));
+    testbench tb("tb", cfg);
+    sc_core::sc_start();
+    auto const& drv = tb.driver;
+    auto wall_s = bench::elapsed_ns(drv.start_time, drv.end_time) / 1e9;
+    auto delta_cycles = drv.end_delta_count - drv.start_delta_count;
+    auto sim_cycles = static_cast<uint64_t>(sc_core::sc_time_stamp() / tb.clk.period());
+    if(cfg.csv) {
+        std::printf("scenario,transactions,sim_cycles,wall_s,tx_per_s,delta_cycles_per_s,peak_rss_kb\n");
+        std::printf("%s,%llu,%llu,%.6f,%.1f,%.1f,%llu\n", cfg.scenario().c_str(), static_cast<unsigned long long>(cfg.transactions),
+                    static_cast<unsigned long long>(sim_cycles), wall_s, cfg.transactions / wall_s, delta_cycles / wall_s,
+                    static_cast<unsigned long long>(bench::peak_rss_kb()));
+    } else {
+        std::printf("scenario:           %s\n", cfg.scenario().c_str());
+        std::printf("transactions:       %llu\n", static_cast<unsigned long long>(cfg.transactions));
+        std::printf("simulated cycles:   %llu\n", static_cast<unsigned long long>(sim_cycles));
+        std::printf("wall clock:         %.3f s\n", wall_s);
+        std::printf("tx/s:               %.1f\n", cfg.transactions / wall_s);
+        std::printf("delta cycles/s:     %.1f\n", delta_cycles / wall_s);
+        std::printf("peak RSS:           %llu KiB\n", static_cast<unsigned long long>(bench::peak_rss_kb()));
+    }
+    return 0;
+}
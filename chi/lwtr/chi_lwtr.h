@@ -21,10 +21,16 @@
 #endif
 
 #include <array>
+#include <axi/extension_recorder_list.h>
+#include <axi/lwtr/async_writer.h>
+#include <axi/recording_filter.h>
+#include <axi/trace_file.h>
+#include <axi/tx_state_ext.h>
 #include <cci_configuration>
 #include <chi/chi_tlm.h>
 #include <regex>
 #include <scc/peq.h>
+#include <scc/report.h>
 #include <string>
 #include <tlm/scc/lwtr/tlm2_lwtr.h>
 #include <tlm/scc/tlm_mm.h>
@@ -48,10 +54,17 @@ template <typename BEGIN = ::lwtr::no_data, typename END = ::lwtr::no_data> usin
 using tx_handle = ::lwtr::tx_handle;
 using mm = tlm::scc::tlm_mm<>;
 using namespace tlm::scc::lwtr;
+using async_writer = axi::lwtr::async_writer;
+using async_job = axi::lwtr::async_job;
+using async_job_handler = axi::lwtr::async_job_handler;
+using async_rec_entry = axi::lwtr::async_rec_entry;
+using recording_filter = axi::recording_filter;
 
 struct nb_chi_rec_entry : public nb_rec_entry {
     const bool snoop;
     const bool credit;
+    //! the per transaction state of the recorder, referenced until the entry is processed
+    axi::tx_state_base* state{nullptr};
     nb_chi_rec_entry(tlm::scc::tlm_gp_shared_ptr tr, tlm::tlm_phase const ph, uintptr_t const id, tx_handle parent, bool snoop = false,
                      bool credit = false)
     : nb_rec_entry{tr, ph, id, parent}
@@ -69,7 +82,9 @@ extern bool registered;
  * e.g. further down the path can link to it.
  */
 template <typename TYPES = chi::chi_protocol_types>
-class chi_lwtr : public virtual chi::chi_fw_transport_if<TYPES>, public virtual chi::chi_bw_transport_if<TYPES> {
+class chi_lwtr : public virtual chi::chi_fw_transport_if<TYPES>,
+                 public virtual chi::chi_bw_transport_if<TYPES>,
+                 private async_job_handler {
 public:
     //! \brief the attribute to selectively enable/disable recording of blocking protocol tx
     cci::cci_param<bool> enableBlTracing;
@@ -80,9 +95,30 @@ public:
     //! \brief the attribute to selectively enable/disable timed recording
     cci::cci_param<bool> enableTimedTracing{"enableTimedTracing", true};
 
+    //! \brief the number of recorded phases after which the recorders of extensions never found in a payload are skipped,
+    //! 0 calls all registered extension recorders
+    cci::cci_param<unsigned> extensionRecordingWarmUp{"extensionRecordingWarmUp", 0};
+
     //! \brief the attribute to selectively enable/disable DMI recording
     cci::cci_param<bool> enableDmiTracing{"enableDmiTracing", false};
 
+    /*! \brief the attribute to enable/disable asynchronous recording of non-blocking tx
+     *
+     * If enabled the non-blocking tx are recorded by the background thread of the async_writer, the recorder only
+     * takes a snapshot of the payload. All recorders writing to the same database need to use the same setting.
+     */
+    cci::cci_param<bool> enableAsyncTracing{"enableAsyncTracing", false};
+
+    /*! \brief the name of a compact binary trace file, if set the tx are written there instead of the database
+     *
+     * The trace holds one fixed-width record per phase in delta and varint encoded columns (see axi::trace_writer).
+     * Recorders using the same file name share the file.
+     */
+    cci::cci_param<std::string> traceFile{"traceFile", ""};
+
+    //! \brief the filter selecting the recorded transactions by address, TxnID, type, sampling and time window
+    recording_filter filter;
+
     /*! \brief The constructor of the component
      *
      * \param name is the SystemC module name of the recorder
@@ -94,6 +130,7 @@ public:
     chi_lwtr(char const* full_name, unsigned bus_width, bool recording_enabled = true, tx_db* tr_db = tx_db::get_default_db())
     : enableBlTracing("enableBlTracing", recording_enabled)
     , enableNbTracing("enableNbTracing", recording_enabled)
+    , filter(full_name)
     , full_name(full_name)
     , nb_timed_peq()
     , bus_width(bus_width)
@@ -103,17 +140,16 @@ public:
         opts.dont_initialize();
         opts.set_sensitivity(&nb_timed_peq.event());
         sc_core::sc_spawn([this]() { nbtx_cb(); }, nullptr, &opts);
+        opts.set_sensitivity(&nb_async_peq.event());
+        sc_core::sc_spawn([this]() { nbtx_async_cb(); }, nullptr, &opts);
         initialize_streams();
     }
 
     virtual ~chi_lwtr() override {
-        nbtx_req_handle_map.clear();
-        nbtx_last_req_handle_map.clear();
-        nbtx_resp_handle_map.clear();
-        nbtx_last_resp_handle_map.clear();
-        nbtx_data_handle_map.clear();
-        nbtx_last_data_handle_map.clear();
-        nbtx_ack_handle_map.clear();
+        if(async) {
+            async_writer::get().flush();
+            async_writer::get().drop(this);
+        }
         delete dmi_trInvalidateHandle;
         delete dmi_trGetHandle;
         delete dmi_streamHandle;
@@ -122,6 +158,8 @@ public:
         delete nb_streamHandleTimed;
         for(auto* p : nb_trHandle)
             delete p; // NOLINT
+        for(auto* p : nb_trAsyncHandle)
+            delete p; // NOLINT
         delete nb_streamHandle;
         for(auto* p : b_trTimedHandle)
             delete p; // NOLINT
@@ -200,13 +238,13 @@ public:
      * \return if true transaction recording is enabled otherwise transaction
      * recording is bypassed
      */
-    inline bool isRecordingBlockingTxEnabled() const { return m_db && enableBlTracing.get_value(); }
+    inline bool isRecordingBlockingTxEnabled() const { return (m_db || trace) && enableBlTracing.get_value(); }
     /*! \brief get the current state of transaction recording
      *
      * \return if true transaction recording is enabled otherwise transaction
      * recording is bypassed
      */
-    inline bool isRecordingNonBlockingTxEnabled() const { return m_db && enableNbTracing.get_value(); }
+    inline bool isRecordingNonBlockingTxEnabled() const { return (m_db || trace) && enableNbTracing.get_value(); }
 
 protected:
     //! \brief the port where fw accesses are forwarded to
@@ -217,6 +255,23 @@ protected:
 
 private:
     std::string const full_name;
+    //! the registered extension recorders, built when the first transaction is recorded
+    axi::extension_recorder_list<lwtr4tlm2_extension_registry_if<TYPES>> ext_recorder_list;
+    inline axi::extension_recorder_list<lwtr4tlm2_extension_registry_if<TYPES>>& ext_recorders() {
+        if(!ext_recorder_list.is_initialized())
+            ext_recorder_list.init(lwtr4tlm2_extension_registry<TYPES>::inst().get(), extensionRecordingWarmUp.get_value());
+        return ext_recorder_list;
+    }
+    //! the handles of the open timed transactions of a payload
+    struct nb_tx_handles {
+        tx_handle req, last_req, resp, last_resp, data, last_data, ack;
+        bool empty() const {
+            return !req.is_valid() && !last_req.is_valid() && !resp.is_valid() && !last_resp.is_valid() && !data.is_valid() &&
+                   !last_data.is_valid() && !ack.is_valid();
+        }
+    };
+    //! the handles kept in the tx_state_ext of the payload
+    using nb_tx_state = axi::tx_state<nb_tx_handles>;
     //! event queue to hold time points of non-blocking transactions
     ::scc::peq<nb_chi_rec_entry> nb_timed_peq;
     /*! \brief The thread processing the non-blocking requests with their
@@ -224,7 +279,45 @@ private:
      * to generate the timed view of non-blocking tx
      */
     void nbtx_cb();
+    //! records a timed non-blocking phase at the current time (at == nullptr) or at the given time
+    void nbtx_record(tlm::tlm_phase const& ph, nb_tx_handles& st, tx_handle parent, tlm::tlm_generic_payload& tr, bool credit,
+                     sc_core::sc_time const* at);
+    //! event queue to hold time points of non-blocking transactions in async mode
+    ::scc::peq<async_rec_entry> nb_async_peq;
+    //! hands the timed non-blocking phases over to the async_writer
+    void nbtx_async_cb();
+    //! the non-blocking transport in async mode
+    tlm::tlm_sync_enum nb_transport_async(uint8_t dir, typename TYPES::tlm_payload_type& trans, typename TYPES::tlm_phase_type& phase,
+                                          sc_core::sc_time& delay);
+    //! executes the jobs posted in async mode on the recording thread
+    void process(async_job& job) override;
+    //! the compact trace the tx are written to instead of the database, nullptr if traceFile is not set
+    axi::trace_writer* trace{nullptr};
+    //! the stream id of this recorder in the compact trace
+    uint16_t trace_stream{0};
+    //! writes a phase to the compact trace
+    void trace_phase(uint8_t flags, typename TYPES::tlm_payload_type& trans, tlm::tlm_phase const& phase, sc_core::sc_time const& delay);
+    //! the non-blocking transport writing to the compact trace
+    tlm::tlm_sync_enum nb_transport_trace(uint8_t dir, typename TYPES::tlm_payload_type& trans, typename TYPES::tlm_phase_type& phase,
+                                          sc_core::sc_time& delay);
+    //! waits for the recording thread before recording on the simulation thread
+    void sync_recording() {
+        if(async)
+            async_writer::get().flush();
+    }
+    tx_handle timed_begin(tx_generator<>* gen, sc_core::sc_time const* at) { return at ? gen->begin_tx_delayed(*at) : gen->begin_tx(); }
+    tx_handle timed_begin(tx_generator<>* gen, tx_handle const& parent, sc_core::sc_time const* at) {
+        return at ? gen->begin_tx_delayed(*at, par_chld_hndl, parent) : gen->begin_tx(par_chld_hndl, parent);
+    }
+    void timed_end(tx_handle& h, sc_core::sc_time const* at) {
+        if(at)
+            h.end_tx_delayed(*at);
+        else
+            h.end_tx();
+    }
     const unsigned bus_width{0};
+    //! true if the non-blocking tx are recorded asynchronously
+    bool async{false};
     //! transaction recording database
     tx_db* m_db{nullptr};
     //! the relationship name handles
@@ -247,15 +340,17 @@ private:
     tx_fiber* nb_streamHandleTimed{nullptr};
     //! transaction generator handle for non-blocking transactions
     std::array<tx_generator<std::string, std::string>*, 5> nb_trHandle{{nullptr, nullptr, nullptr, nullptr, nullptr}};
+    //! transaction generator handle for non-blocking transactions in async mode, the phases are recorded as attributes
+    std::array<tx_generator<>*, 2> nb_trAsyncHandle{{nullptr, nullptr}};
     //! transaction generator handle for non-blocking transactions with annotated delays
     std::array<tx_generator<>*, 5> nb_trTimedHandle{{nullptr, nullptr}};
-    std::unordered_map<uint64_t, tx_handle> nbtx_req_handle_map;
-    std::unordered_map<uint64_t, tx_handle> nbtx_last_req_handle_map;
-    std::unordered_map<uint64_t, tx_handle> nbtx_resp_handle_map;
-    std::unordered_map<uint64_t, tx_handle> nbtx_last_resp_handle_map;
-    std::unordered_map<uint64_t, tx_handle> nbtx_data_handle_map;
-    std::unordered_map<uint64_t, tx_handle> nbtx_last_data_handle_map;
-    std::unordered_map<uint64_t, tx_handle> nbtx_ack_handle_map;
+    //! the handles in async mode, only accessed by the recording thread
+    std::unordered_map<uint64_t, nb_tx_handles> nbtx_async_handles;
+    //! attaches the per transaction state of the payload to a timed entry
+    void attach_state(nb_chi_rec_entry& rec, typename TYPES::tlm_payload_type& trans) {
+        rec.state = axi::get_tx_state<nb_tx_state>(trans, this);
+        rec.state->acquire();
+    }
     //! dmi transaction recording stream handle
     tx_fiber* dmi_streamHandle{nullptr};
     //! transaction generator handle for DMI transactions
@@ -264,11 +359,21 @@ private:
 
 protected:
     void initialize_streams() {
+        filter.init();
+        if(!trace && !traceFile.get_value().empty()) {
+            auto& writer = axi::trace_writer::get(traceFile.get_value());
+            if(writer.is_open()) {
+                trace = &writer;
+                trace_stream = writer.add_stream(full_name);
+            } else {
+                SCCERR(full_name.c_str()) << "could not open trace file '" << traceFile.get_value() << "', recording to the database";
+            }
+        }
         if(m_db) {
             pred_succ_hndl = m_db->create_relation("PREDECESSOR_SUCCESSOR");
             par_chld_hndl = m_db->create_relation("PARENT_CHILD");
         }
-        if(isRecordingBlockingTxEnabled() && !b_streamHandle) {
+        if(m_db && !trace && isRecordingBlockingTxEnabled() && !b_streamHandle) {
             b_streamHandle = new tx_fiber((full_name + "_bl").c_str(), "[TLM][chi][b]", m_db);
             b_trHandle[tlm::TLM_READ_COMMAND] =
                 new tx_generator<sc_core::sc_time, sc_core::sc_time>("read", *b_streamHandle, "start_delay", "end_delay");
@@ -283,10 +388,16 @@ protected:
                 b_trTimedHandle[tlm::TLM_IGNORE_COMMAND] = new tx_generator<>("ignore", *b_streamHandleTimed);
             }
         }
-        if(isRecordingNonBlockingTxEnabled() && !nb_streamHandle) {
+        if(m_db && !trace && isRecordingNonBlockingTxEnabled() && !nb_streamHandle) {
             nb_streamHandle = new tx_fiber((full_name + "_nb").c_str(), "[TLM][chi][nb]", m_db);
-            nb_trHandle[FW] = new tx_generator<std::string, std::string>("fw", *nb_streamHandle, "tlm_phase", "tlm_phase[return_path]");
-            nb_trHandle[BW] = new tx_generator<std::string, std::string>("bw", *nb_streamHandle, "tlm_phase", "tlm_phase[return_path]");
+            async = enableAsyncTracing.get_value();
+            if(async) {
+                nb_trAsyncHandle[FW] = new tx_generator<>("fw", *nb_streamHandle);
+                nb_trAsyncHandle[BW] = new tx_generator<>("bw", *nb_streamHandle);
+            } else {
+                nb_trHandle[FW] = new tx_generator<std::string, std::string>("fw", *nb_streamHandle, "tlm_phase", "tlm_phase[return_path]");
+                nb_trHandle[BW] = new tx_generator<std::string, std::string>("bw", *nb_streamHandle, "tlm_phase", "tlm_phase[return_path]");
+            }
             if(enableTimedTracing.get_value()) {
                 nb_streamHandleTimed = new tx_fiber((full_name + "_nb_timed").c_str(), "[TLM][chi][nb][timed]", m_db);
                 nb_trTimedHandle[REQ] = new tx_generator<>("request", *nb_streamHandleTimed);
@@ -305,6 +416,38 @@ protected:
     }
 
 private:
+    inline unsigned get_txn_id(typename TYPES::tlm_payload_type& trans) {
+        if(auto* ext = trans.template get_extension<chi::chi_ctrl_extension>())
+            return ext->get_txn_id();
+        if(auto* ext = trans.template get_extension<chi::chi_snp_extension>())
+            return ext->get_txn_id();
+        if(auto* ext = trans.template get_extension<chi::chi_data_extension>())
+            return ext->get_txn_id();
+        return 0;
+    }
+    inline recording_filter::tx_kind get_kind(typename TYPES::tlm_payload_type& trans) {
+        if(trans.template get_extension<chi::chi_snp_extension>())
+            return recording_filter::tx_kind::SNOOP;
+        return trans.is_write() ? recording_filter::tx_kind::WRITE : recording_filter::tx_kind::READ;
+    }
+    inline bool is_recorded(typename TYPES::tlm_payload_type& trans) {
+        return !filter.is_active() || filter.accept(trans.get_address(), get_txn_id(trans), get_kind(trans));
+    }
+    // CHI transactions (and snoops) always start with BEGIN_REQ, the decision is replaced there
+    inline bool is_nb_recorded(typename TYPES::tlm_payload_type& trans, const tlm::tlm_phase& p) {
+        if(!filter.is_active())
+            return true;
+        auto id = reinterpret_cast<uintptr_t>(&trans);
+        if(p == tlm::BEGIN_REQ)
+            return filter.start_nb(id, trans.get_address(), get_txn_id(trans), get_kind(trans));
+        return filter.accept_nb(id, false, trans.get_address(), get_txn_id(trans), get_kind(trans));
+    }
+    // a completed phase finishes the transaction, the same condition unlinks the recorded phases
+    inline tlm::tlm_sync_enum finish_nb(typename TYPES::tlm_payload_type& trans, tlm::tlm_sync_enum status) {
+        if(status == tlm::TLM_COMPLETED)
+            filter.finish_nb(reinterpret_cast<uintptr_t>(&trans));
+        return status;
+    }
     inline std::string phase2string(const tlm::tlm_phase& p) {
         std::stringstream ss;
         ss << p;
@@ -333,10 +476,17 @@ public:
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 template <typename TYPES> void chi_lwtr<TYPES>::b_transport(typename TYPES::tlm_payload_type& trans, sc_core::sc_time& delay) {
-    if(!isRecordingBlockingTxEnabled()) {
+    if(!isRecordingBlockingTxEnabled() || !is_recorded(trans)) {
+        fw_port->b_transport(trans, delay);
+        return;
+    }
+    if(trace) {
+        trace_phase(axi::TRACE_BLOCKING, trans, tlm::BEGIN_REQ, delay);
         fw_port->b_transport(trans, delay);
+        trace_phase(axi::TRACE_BLOCKING | axi::TRACE_RETURN, trans, tlm::END_RESP, delay);
         return;
     }
+    sync_recording();
     // Get a handle for the new transaction
     tx_handle h = b_trHandle[trans.get_command()]->begin_tx(delay);
     tx_handle htim;
@@ -346,13 +496,11 @@ template <typename TYPES> void chi_lwtr<TYPES>::b_transport(typename TYPES::tlm_
     if(b_streamHandleTimed)
         htim = b_trTimedHandle[trans.get_command()]->begin_tx_delayed(sc_core::sc_time_stamp() + delay, par_chld_hndl, h);
 
-    if(registered)
-        for(auto& extensionRecording : lwtr4tlm2_extension_registry<TYPES>::inst().get())
-            if(extensionRecording) {
-                extensionRecording->recordBeginTx(h, trans);
-                if(htim.is_valid())
-                    extensionRecording->recordBeginTx(htim, trans);
-            }
+    if(registered) {
+        ext_recorders().record_begin(h, trans);
+        if(htim.is_valid())
+            ext_recorders().record_begin(htim, trans, false);
+    }
     link_pred_ext* preExt = nullptr;
 
     trans.get_extension(preExt);
@@ -368,6 +516,7 @@ template <typename TYPES> void chi_lwtr<TYPES>::b_transport(typename TYPES::tlm_
     tx_handle preTx(preExt->txHandle);
     preExt->txHandle = h;
     fw_port->b_transport(trans, delay);
+    sync_recording();
     trans.get_extension(preExt);
     if(preExt->creator == this) {
         // clean-up the extension if this is the original creator
@@ -380,13 +529,11 @@ template <typename TYPES> void chi_lwtr<TYPES>::b_transport(typename TYPES::tlm_
     }
 
     h.record_attribute("trans", trans);
-    if(registered)
-        for(auto& extensionRecording : lwtr4tlm2_extension_registry<TYPES>::inst().get())
-            if(extensionRecording) {
-                extensionRecording->recordEndTx(h, trans);
-                if(htim.is_active())
-                    extensionRecording->recordEndTx(htim, trans);
-            }
+    if(registered) {
+        ext_recorders().record_end(h, trans);
+        if(htim.is_active())
+            ext_recorders().record_end(htim, trans);
+    }
     // End the transaction
     h.end_tx(delay);
     // and now the stuff for the timed tx
@@ -397,10 +544,17 @@ template <typename TYPES> void chi_lwtr<TYPES>::b_transport(typename TYPES::tlm_
 }
 
 template <typename TYPES> void chi_lwtr<TYPES>::b_snoop(typename TYPES::tlm_payload_type& trans, sc_core::sc_time& delay) {
-    if(!b_streamHandleTimed) {
+    if(trace && enableBlTracing.get_value() && is_recorded(trans)) {
+        trace_phase(axi::TRACE_BLOCKING | axi::TRACE_BW | axi::TRACE_SNOOP, trans, tlm::BEGIN_REQ, delay);
         bw_port->b_snoop(trans, delay);
+        trace_phase(axi::TRACE_BLOCKING | axi::TRACE_BW | axi::TRACE_SNOOP | axi::TRACE_RETURN, trans, tlm::END_RESP, delay);
         return;
     }
+    if(!b_streamHandleTimed || !is_recorded(trans)) {
+        bw_port->b_snoop(trans, delay);
+        return;
+    }
+    sync_recording();
     // Get a handle for the new transaction
     tx_handle h = b_trHandle[trans.get_command()]->begin_tx(delay);
     tx_handle htim;
@@ -410,13 +564,11 @@ template <typename TYPES> void chi_lwtr<TYPES>::b_snoop(typename TYPES::tlm_payl
     if(b_streamHandleTimed)
         htim = b_trTimedHandle[trans.get_command()]->begin_tx_delayed(sc_core::sc_time_stamp() + delay, par_chld_hndl, h);
 
-    if(registered)
-        for(auto& extensionRecording : lwtr4tlm2_extension_registry<TYPES>::inst().get())
-            if(extensionRecording) {
-                extensionRecording->recordBeginTx(h, trans);
-                if(htim.is_valid())
-                    extensionRecording->recordBeginTx(htim, trans);
-            }
+    if(registered) {
+        ext_recorders().record_begin(h, trans);
+        if(htim.is_valid())
+            ext_recorders().record_begin(htim, trans, false);
+    }
     link_pred_ext* preExt = nullptr;
 
     trans.get_extension(preExt);
@@ -429,6 +581,7 @@ template <typename TYPES> void chi_lwtr<TYPES>::b_snoop(typename TYPES::tlm_payl
     tx_handle preTx(preExt->txHandle);
     preExt->txHandle = h;
     bw_port->b_snoop(trans, delay);
+    sync_recording();
     trans.get_extension(preExt);
     if(preExt->creator == this) {
         // clean-up the extension if this is the original creator
@@ -440,13 +593,11 @@ template <typename TYPES> void chi_lwtr<TYPES>::b_snoop(typename TYPES::tlm_payl
     }
 
     h.record_attribute("trans", trans);
-    if(registered)
-        for(auto& extensionRecording : lwtr4tlm2_extension_registry<TYPES>::inst().get())
-            if(extensionRecording) {
-                extensionRecording->recordEndTx(h, trans);
-                if(htim.is_active())
-                    extensionRecording->recordEndTx(htim, trans);
-            }
+    if(registered) {
+        ext_recorders().record_end(h, trans);
+        if(htim.is_active())
+            ext_recorders().record_end(htim, trans);
+    }
     // End the transaction
     h.end_tx(delay);
     // and now the stuff for the timed tx
@@ -459,9 +610,13 @@ template <typename TYPES> void chi_lwtr<TYPES>::b_snoop(typename TYPES::tlm_payl
 template <typename TYPES>
 tlm::tlm_sync_enum chi_lwtr<TYPES>::nb_transport_fw(typename TYPES::tlm_payload_type& trans, typename TYPES::tlm_phase_type& phase,
                                                     sc_core::sc_time& delay) {
-    if(!isRecordingNonBlockingTxEnabled()) {
-        return fw_port->nb_transport_fw(trans, phase, delay);
+    if(!isRecordingNonBlockingTxEnabled() || !is_nb_recorded(trans, phase)) {
+        return finish_nb(trans, fw_port->nb_transport_fw(trans, phase, delay));
     }
+    if(trace)
+        return finish_nb(trans, nb_transport_trace(FW, trans, phase, delay));
+    if(async)
+        return finish_nb(trans, nb_transport_async(FW, trans, phase, delay));
     /*************************************************************************
      * prepare recording
      *************************************************************************/
@@ -485,9 +640,7 @@ tlm::tlm_sync_enum chi_lwtr<TYPES>::nb_transport_fw(typename TYPES::tlm_payload_
     preExt->txHandle = h;
     h.record_attribute("delay", delay);
     if(registered)
-        for(auto& extensionRecording : lwtr4tlm2_extension_registry<TYPES>::inst().get())
-            if(extensionRecording)
-                extensionRecording->recordBeginTx(h, trans);
+        ext_recorders().record_begin(h, trans);
     /*************************************************************************
      * do the timed notification
      *************************************************************************/
@@ -496,6 +649,7 @@ tlm::tlm_sync_enum chi_lwtr<TYPES>::nb_transport_fw(typename TYPES::tlm_payload_
                              (trans.template get_extension<chi::chi_snp_extension>() != nullptr),
                              (phase == tlm::BEGIN_REQ) && has_credit(trans));
         rec.tr->deep_copy_from(trans);
+        attach_state(rec, trans);
         nb_timed_peq.notify(rec, delay);
     }
     /*************************************************************************
@@ -509,9 +663,7 @@ tlm::tlm_sync_enum chi_lwtr<TYPES>::nb_transport_fw(typename TYPES::tlm_payload_
     h.record_attribute("delay[return_path]", delay);
     h.record_attribute("trans", trans);
     if(registered)
-        for(auto& extensionRecording : lwtr4tlm2_extension_registry<TYPES>::inst().get())
-            if(extensionRecording)
-                extensionRecording->recordEndTx(h, trans);
+        ext_recorders().record_end(h, trans);
     // get the extension and free the memory if it was mine
     if(status == tlm::TLM_COMPLETED) {
         // the transaction is finished
@@ -529,24 +681,33 @@ tlm::tlm_sync_enum chi_lwtr<TYPES>::nb_transport_fw(typename TYPES::tlm_payload_
             nb_chi_rec_entry rec{mm::get().allocate(), (phase == tlm::BEGIN_REQ) ? tlm::END_RESP : phase,
                                  reinterpret_cast<uint64_t>(&trans), h}; // TODO: check phase
             rec.tr->deep_copy_from(trans);
+            attach_state(rec, trans);
             nb_timed_peq.notify(rec, delay);
         }
+        // payloads with memory manager release the state with their extensions
+        if(!trans.has_mm())
+            axi::release_tx_state(trans, this);
     } else if(nb_streamHandleTimed && status == tlm::TLM_UPDATED) {
         nb_chi_rec_entry rec{mm::get().allocate(), phase, reinterpret_cast<uint64_t>(&trans), h};
         rec.tr->deep_copy_from(trans);
+        attach_state(rec, trans);
         nb_timed_peq.notify(rec, delay);
     }
     // End the transaction
     nb_trHandle[FW]->end_tx(h, phase2string(phase));
-    return status;
+    return finish_nb(trans, status);
 }
 
 template <typename TYPES>
 tlm::tlm_sync_enum chi_lwtr<TYPES>::nb_transport_bw(typename TYPES::tlm_payload_type& trans, typename TYPES::tlm_phase_type& phase,
                                                     sc_core::sc_time& delay) {
-    if(!isRecordingNonBlockingTxEnabled()) {
-        return bw_port->nb_transport_bw(trans, phase, delay);
+    if(!isRecordingNonBlockingTxEnabled() || !is_nb_recorded(trans, phase)) {
+        return finish_nb(trans, bw_port->nb_transport_bw(trans, phase, delay));
     }
+    if(trace)
+        return finish_nb(trans, nb_transport_trace(BW, trans, phase, delay));
+    if(async)
+        return finish_nb(trans, nb_transport_async(BW, trans, phase, delay));
     /*************************************************************************
      * prepare recording
      *************************************************************************/
@@ -569,9 +730,7 @@ tlm::tlm_sync_enum chi_lwtr<TYPES>::nb_transport_bw(typename TYPES::tlm_payload_
     }
     // and set the extension handle to this transaction
     h.record_attribute("delay", delay);
-    for(auto& extensionRecording : lwtr4tlm2_extension_registry<TYPES>::inst().get())
-        if(extensionRecording)
-            extensionRecording->recordBeginTx(h, trans);
+    ext_recorders().record_begin(h, trans);
     /*************************************************************************
      * do the timed notification
      *************************************************************************/
@@ -580,6 +739,7 @@ tlm::tlm_sync_enum chi_lwtr<TYPES>::nb_transport_bw(typename TYPES::tlm_payload_
                              (trans.template get_extension<chi::chi_snp_extension>() != nullptr),
                              (phase == tlm::BEGIN_REQ) && has_credit(trans));
         rec.tr->deep_copy_from(trans);
+        attach_state(rec, trans);
         nb_timed_peq.notify(rec, delay);
     }
     /*************************************************************************
@@ -593,9 +753,7 @@ tlm::tlm_sync_enum chi_lwtr<TYPES>::nb_transport_bw(typename TYPES::tlm_payload_
     h.record_attribute("delay[return_path]", delay);
     h.record_attribute("trans", trans);
     if(registered)
-        for(auto& extensionRecording : lwtr4tlm2_extension_registry<TYPES>::inst().get())
-            if(extensionRecording)
-                extensionRecording->recordEndTx(h, trans);
+        ext_recorders().record_end(h, trans);
     // End the transaction
     nb_trHandle[BW]->end_tx(h, phase2string(phase));
     // get the extension and free the memory if it was mine
@@ -615,113 +773,239 @@ tlm::tlm_sync_enum chi_lwtr<TYPES>::nb_transport_bw(typename TYPES::tlm_payload_
             nb_chi_rec_entry rec{mm::get().allocate(), (phase == tlm::BEGIN_REQ) ? tlm::END_RESP : phase,
                                  reinterpret_cast<uint64_t>(&trans), h, phase == tlm::BEGIN_REQ};
             rec.tr->deep_copy_from(trans);
+            attach_state(rec, trans);
             nb_timed_peq.notify(rec, delay);
         }
+        // payloads with memory manager release the state with their extensions
+        if(!trans.has_mm())
+            axi::release_tx_state(trans, this);
     } else if(nb_streamHandleTimed && status == tlm::TLM_UPDATED) {
         nb_chi_rec_entry rec{mm::get().allocate(), phase, reinterpret_cast<uint64_t>(&trans), h, phase == tlm::BEGIN_REQ};
         rec.tr->deep_copy_from(trans);
+        attach_state(rec, trans);
         nb_timed_peq.notify(rec, delay);
     }
-    return status;
+    return finish_nb(trans, status);
 }
 
 template <typename TYPES> void chi_lwtr<TYPES>::nbtx_cb() {
     auto opt = nb_timed_peq.get_next();
     if(opt) {
         auto& e = opt.get();
-        tx_handle h;
-        // Now process outstanding recordings
-        if(e.credit) {
-            nb_trTimedHandle[CREDIT]->begin_tx().end_tx();
-        } else if(e.ph == tlm::BEGIN_REQ) {
-            h = nb_trTimedHandle[REQ]->begin_tx(par_chld_hndl, e.parent);
-            nbtx_req_handle_map[e.id] = h;
-        } else if(e.ph == tlm::END_REQ) {
-            auto it = nbtx_req_handle_map.find(e.id);
-            if(it != nbtx_req_handle_map.end()) {
-                h = it->second;
-                nbtx_req_handle_map.erase(it);
-                h.record_attribute("trans", *e.tr);
-                h.end_tx();
-                nbtx_last_req_handle_map[e.id] = h;
-            }
-        } else if(e.ph == tlm::BEGIN_RESP) {
-            auto it = nbtx_req_handle_map.find(e.id);
-            if(it != nbtx_req_handle_map.end()) {
-                h = it->second;
-                nbtx_req_handle_map.erase(it);
-                h.record_attribute("trans", *e.tr);
-                h.end_tx();
-                nbtx_last_req_handle_map[e.id] = h;
-            }
-            h = nb_trTimedHandle[RESP]->begin_tx(par_chld_hndl, e.parent);
-            nbtx_resp_handle_map[e.id] = h;
-            it = nbtx_last_req_handle_map.find(e.id);
-            if(it != nbtx_last_req_handle_map.end()) {
-                tx_handle& pred = it->second;
-                h.add_relation(pred_succ_hndl, pred);
-                nbtx_last_req_handle_map.erase(it);
-            } else {
-                it = nbtx_last_resp_handle_map.find(e.id);
-                if(it != nbtx_last_resp_handle_map.end()) {
-                    tx_handle& pred = it->second;
-                    h.add_relation(pred_succ_hndl, pred);
-                    nbtx_last_resp_handle_map.erase(it);
-                }
-            }
-        } else if(e.ph == tlm::END_RESP) {
-            auto it = nbtx_resp_handle_map.find(e.id);
-            if(it != nbtx_resp_handle_map.end()) {
-                h = it->second;
-                nbtx_resp_handle_map.erase(it);
-                h.record_attribute("trans", *e.tr);
-                h.end_tx();
-            }
-        } else if(e.ph == chi::BEGIN_DATA || e.ph == chi::BEGIN_PARTIAL_DATA) {
-            auto it = nbtx_req_handle_map.find(e.id);
-            if(it != nbtx_req_handle_map.end()) {
-                h = it->second;
-                h.end_tx();
-                nbtx_last_req_handle_map[e.id] = h;
-            }
-            h = nb_trTimedHandle[DATA]->begin_tx();
-            h.record_attribute("trans", *e.tr);
-            h.add_relation(par_chld_hndl, e.parent);
-            nbtx_data_handle_map[e.id] = h;
-            it = nbtx_last_data_handle_map.find(e.id);
-            if(it != nbtx_last_data_handle_map.end()) {
-                auto pred = it->second;
-                nbtx_last_data_handle_map.erase(it);
-                h.add_relation(pred_succ_hndl, pred);
-            }
-        } else if(e.ph == chi::END_DATA || e.ph == chi::END_PARTIAL_DATA) {
-            auto it = nbtx_data_handle_map.find(e.id);
-            if(it != nbtx_data_handle_map.end()) {
-                h = it->second;
-                nbtx_data_handle_map.erase(it);
-                h.end_tx();
-            }
-        } else if(e.ph == chi::ACK) {
-            auto it = nbtx_ack_handle_map.find(e.id);
-            if(it == nbtx_ack_handle_map.end()) {
-                auto h = nb_trTimedHandle[ACK]->begin_tx();
-                nbtx_ack_handle_map[e.id] = h;
-                h.add_relation(par_chld_hndl, e.parent);
-            } else {
-                nb_trTimedHandle[ACK]->end_tx(it->second);
-                nbtx_ack_handle_map.erase(it);
-            }
-        } else
-            sc_assert(!"phase not supported!");
+        auto* st = static_cast<nb_tx_state*>(e.state);
+        nbtx_record(e.ph, *st, e.parent, *e.tr, e.credit, nullptr);
+        st->release();
     }
     return;
 }
 
+template <typename TYPES>
+void chi_lwtr<TYPES>::nbtx_record(tlm::tlm_phase const& ph, nb_tx_handles& st, tx_handle parent, tlm::tlm_generic_payload& tr,
+                                  bool credit, sc_core::sc_time const* at) {
+    tx_handle h;
+    // Now process outstanding recordings
+    if(credit) {
+        h = timed_begin(nb_trTimedHandle[CREDIT], at);
+        timed_end(h, at);
+    } else if(ph == tlm::BEGIN_REQ) {
+        st.req = timed_begin(nb_trTimedHandle[REQ], parent, at);
+    } else if(ph == tlm::END_REQ) {
+        if(st.req.is_valid()) {
+            st.req.record_attribute("trans", tr);
+            timed_end(st.req, at);
+            st.last_req = st.req;
+            st.req = tx_handle();
+        }
+    } else if(ph == tlm::BEGIN_RESP) {
+        if(st.req.is_valid()) {
+            st.req.record_attribute("trans", tr);
+            timed_end(st.req, at);
+            st.last_req = st.req;
+            st.req = tx_handle();
+        }
+        h = timed_begin(nb_trTimedHandle[RESP], parent, at);
+        st.resp = h;
+        if(st.last_req.is_valid()) {
+            h.add_relation(pred_succ_hndl, st.last_req);
+            st.last_req = tx_handle();
+        } else if(st.last_resp.is_valid()) {
+            h.add_relation(pred_succ_hndl, st.last_resp);
+            st.last_resp = tx_handle();
+        }
+    } else if(ph == tlm::END_RESP) {
+        if(st.resp.is_valid()) {
+            st.resp.record_attribute("trans", tr);
+            timed_end(st.resp, at);
+            st.resp = tx_handle();
+        }
+    } else if(ph == chi::BEGIN_DATA || ph == chi::BEGIN_PARTIAL_DATA) {
+        if(st.req.is_valid()) {
+            timed_end(st.req, at);
+            st.last_req = st.req;
+        }
+        h = timed_begin(nb_trTimedHandle[DATA], at);
+        h.record_attribute("trans", tr);
+        h.add_relation(par_chld_hndl, parent);
+        st.data = h;
+        if(st.last_data.is_valid()) {
+            h.add_relation(pred_succ_hndl, st.last_data);
+            st.last_data = tx_handle();
+        }
+    } else if(ph == chi::END_DATA || ph == chi::END_PARTIAL_DATA) {
+        if(st.data.is_valid()) {
+            timed_end(st.data, at);
+            st.data = tx_handle();
+        }
+    } else if(ph == chi::ACK) {
+        if(!st.ack.is_valid()) {
+            st.ack = timed_begin(nb_trTimedHandle[ACK], at);
+            st.ack.add_relation(par_chld_hndl, parent);
+        } else {
+            if(at)
+                st.ack.end_tx_delayed(*at);
+            else
+                nb_trTimedHandle[ACK]->end_tx(st.ack);
+            st.ack = tx_handle();
+        }
+    } else
+        sc_assert(!"phase not supported!");
+}
+
+template <typename TYPES>
+void chi_lwtr<TYPES>::trace_phase(uint8_t flags, typename TYPES::tlm_payload_type& trans, tlm::tlm_phase const& phase,
+                               sc_core::sc_time const& delay) {
+    axi::trace_record r;
+    r.time = (sc_core::sc_time_stamp() + delay).value();
+    r.tx = reinterpret_cast<uint64_t>(&trans);
+    r.phase = static_cast<unsigned>(phase);
+    r.stream = trace_stream;
+    r.addr = trans.get_address();
+    r.id = get_txn_id(trans);
+    if(trans.is_write())
+        r.flags |= axi::TRACE_WRITE;
+    if(auto* ext = trans.template get_extension<chi::chi_ctrl_extension>()) {
+        r.flags |= axi::TRACE_CHI;
+        if(ext->req.is_exp_comp_ack())
+            r.flags |= axi::TRACE_ACK;
+        if(chi::is_dataless(ext))
+            r.flags |= axi::TRACE_DATALESS;
+        r.opcode = static_cast<uint16_t>(ext->req.get_opcode());
+        r.size = ext->req.get_size();
+        r.resp = static_cast<uint8_t>(ext->resp.get_resp());
+    } else if(auto* ext = trans.template get_extension<chi::chi_snp_extension>()) {
+        r.flags |= axi::TRACE_SNOOP | axi::TRACE_CHI;
+        r.opcode = static_cast<uint16_t>(ext->req.get_opcode());
+        r.resp = static_cast<uint8_t>(ext->resp.get_resp());
+    } else if(auto* ext = trans.template get_extension<chi::chi_data_extension>()) {
+        r.flags |= axi::TRACE_CHI;
+        r.opcode = static_cast<uint16_t>(ext->dat.get_opcode());
+        r.resp = static_cast<uint8_t>(ext->dat.get_resp());
+    }
+    r.flags |= flags;
+    trace->write(r);
+}
+
+template <typename TYPES>
+tlm::tlm_sync_enum chi_lwtr<TYPES>::nb_transport_trace(uint8_t dir, typename TYPES::tlm_payload_type& trans,
+                                                       typename TYPES::tlm_phase_type& phase, sc_core::sc_time& delay) {
+    uint8_t const flags = dir == FW ? 0 : axi::TRACE_BW;
+    trace_phase(flags, trans, phase, delay);
+    tlm::tlm_sync_enum status =
+        dir == FW ? fw_port->nb_transport_fw(trans, phase, delay) : bw_port->nb_transport_bw(trans, phase, delay);
+    if(status != tlm::TLM_ACCEPTED)
+        trace_phase(flags | axi::TRACE_RETURN, trans, phase, delay);
+    return status;
+}
+
+template <typename TYPES>
+tlm::tlm_sync_enum chi_lwtr<TYPES>::nb_transport_async(uint8_t dir, typename TYPES::tlm_payload_type& trans,
+                                                       typename TYPES::tlm_phase_type& phase, sc_core::sc_time& delay) {
+    auto& writer = async_writer::get();
+    auto const slot = writer.new_slot();
+    auto const pred = writer.link(trans, slot, this, phase == tlm::BEGIN_REQ);
+    auto const id = reinterpret_cast<uint64_t>(&trans);
+    // the handle is referenced by the end of the call, the link extension and the timed entry
+    writer.post_begin(this, dir, slot, pred, nb_streamHandleTimed ? 3 : 2, phase, delay, trans);
+    auto const begin_phase = phase;
+    auto const begin_delay = delay;
+    uint8_t const begin_credit = (phase == tlm::BEGIN_REQ) && has_credit(trans);
+    tlm::tlm_sync_enum status =
+        dir == FW ? fw_port->nb_transport_fw(trans, phase, delay) : bw_port->nb_transport_bw(trans, phase, delay);
+    auto const timed_end = nb_streamHandleTimed && (status == tlm::TLM_COMPLETED || status == tlm::TLM_UPDATED);
+    // a single snapshot taken after the call is shared by the end of the call and the timed entries
+    auto* snap = writer.snapshot(trans, 1 + (nb_streamHandleTimed ? 1 : 0) + (timed_end ? 1 : 0));
+    if(nb_streamHandleTimed)
+        nb_async_peq.notify(async_rec_entry{snap, begin_phase, id, slot, begin_credit}, begin_delay);
+    if(timed_end) {
+        writer.post_add_ref(slot);
+        // a request completed on the return path finishes the whole transaction, so its timed tx ends like a response
+        auto const ph = status == tlm::TLM_COMPLETED && phase == tlm::BEGIN_REQ ? tlm::END_RESP : phase;
+        nb_async_peq.notify(async_rec_entry{snap, ph, id, slot, false}, delay);
+    }
+    writer.post_end(this, dir, slot, status, phase, delay, trans, snap);
+    if(status == tlm::TLM_COMPLETED)
+        writer.unlink(trans, this);
+    return status;
+}
+
+template <typename TYPES> void chi_lwtr<TYPES>::nbtx_async_cb() {
+    auto opt = nb_async_peq.get_next();
+    if(opt)
+        async_writer::get().post_timed(this, opt.get());
+}
+
+template <typename TYPES> void chi_lwtr<TYPES>::process(async_job& job) {
+    auto& writer = async_writer::get();
+    switch(job.type) {
+    case async_job::BEGIN: {
+        tx_handle h = nb_trAsyncHandle[job.channel]->begin_tx_delayed(job.time);
+        h.record_attribute("tlm_phase", phase2string(job.phase));
+        if(job.other) {
+            tx_handle pred = writer.get_handle(job.other);
+            if(pred.is_valid())
+                h.add_relation(pred_succ_hndl, pred);
+        }
+        h.record_attribute("delay", job.delay);
+        writer.set_handle(job.slot, h, job.refs, this);
+        if(job.other)
+            writer.release_handle(job.other);
+        break;
+    }
+    case async_job::END: {
+        tx_handle h = writer.get_handle(job.slot);
+        h.record_attribute("status", job.status);
+        h.record_attribute("delay[return_path]", job.delay);
+        h.record_attribute("trans", *job.trans);
+        // the extensions are recorded from the snapshot taken after the call
+        if(registered) {
+            ext_recorders().record_begin(h, *job.trans);
+            ext_recorders().record_end(h, *job.trans);
+        }
+        h.record_attribute("tlm_phase[return_path]", phase2string(job.phase));
+        h.end_tx_delayed(job.time);
+        writer.release_handle(job.slot);
+        break;
+    }
+    case async_job::TIMED: {
+        auto& st = nbtx_async_handles[job.id];
+        nbtx_record(job.phase, st, writer.get_handle(job.other), *job.trans, job.flags != 0, &job.time);
+        if(st.empty())
+            nbtx_async_handles.erase(job.id);
+        writer.release_handle(job.other);
+        break;
+    }
+    default:
+        break;
+    }
+}
+
 template <typename TYPES> bool chi_lwtr<TYPES>::get_direct_mem_ptr(typename TYPES::tlm_payload_type& trans, tlm::tlm_dmi& dmi_data) {
     if(!(m_db && enableDmiTracing.get_value()))
         return fw_port->get_direct_mem_ptr(trans, dmi_data);
+    sync_recording();
     tx_handle h = dmi_trGetHandle->begin_tx();
     bool status = fw_port->get_direct_mem_ptr(trans, dmi_data);
+    sync_recording();
     h.record_attribute("trans", trans);
     h.record_attribute("dmi_data", dmi_data);
     h.end_tx();
@@ -738,8 +1022,10 @@ template <typename TYPES> void chi_lwtr<TYPES>::invalidate_direct_mem_ptr(sc_dt:
         bw_port->invalidate_direct_mem_ptr(start_addr, end_addr);
         return;
     }
+    sync_recording();
     tx_handle h = dmi_trInvalidateHandle->begin_tx(start_addr);
     bw_port->invalidate_direct_mem_ptr(start_addr, end_addr);
+    sync_recording();
     dmi_trInvalidateHandle->end_tx(h, end_addr);
     return;
 }
@@ -35,7 +35,9 @@ namespace {
 uint8_t log2n(uint8_t siz) { return ((siz > 1) ? 1 + log2n(siz >> 1) : 0); }
 inline uintptr_t to_id(tlm::tlm_generic_payload& t) { return reinterpret_cast<uintptr_t>(&t); }
 inline uintptr_t to_id(tlm::tlm_generic_payload* t) { return reinterpret_cast<uintptr_t>(t); }
-void convert_axi4ace_to_chi(tlm::tlm_generic_payload& gp, char const* name, bool legacy_mapping = false) {
+} // anonymous namespace
+
+void chi::pe::convert_axi4ace_to_chi(tlm::tlm_generic_payload& gp, char const* name, bool legacy_mapping) {
     if(gp.get_data_length() > 64) {
         SCCWARN(__FUNCTION__) << "Data length of " << gp.get_data_length() << " is not supported by CHI, shortening payload";
         gp.set_data_length(64);
@@ -386,6 +388,8 @@ void convert_axi4ace_to_chi(tlm::tlm_generic_payload& gp, char const* name, bool
     gp.set_extension(axi4_ext);
 }
 
+namespace {
+
 void setExpCompAck(chi::chi_ctrl_extension* const req_e) {
     switch(req_e->req.get_opcode()) {
     // Ref : Sec 2.8.3 pg 97
@@ -531,6 +535,24 @@ chi::pe::chi_rn_initiator_b::~chi_rn_initiator_b() {
         delete p;
 }
 
+void chi::pe::chi_rn_initiator_b::end_of_elaboration() {
+    clk_if = dynamic_cast<sc_core::sc_clock*>(clk_i.get_interface());
+    collect_statistics = enable_statistics.get_value();
+    statistics.set_window_cycles(statistics_window.get_value());
+}
+
+void chi::pe::chi_rn_initiator_b::end_of_simulation() {
+    if(!collect_statistics)
+        return;
+    auto file_name = statistics_file_name.get_value().length() ? statistics_file_name.get_value() : std::string(name()) + ".stats.json";
+    auto period_ps = static_cast<uint64_t>((clk_if ? clk_if->period() : clk_period) / sc_time(1, SC_PS));
+    if(statistics.write_json(file_name, name(), period_ps)) {
+        SCCINFO(SCMOD) << "wrote statistics to " << file_name;
+    } else {
+        SCCERR(SCMOD) << "could not write statistics to " << file_name;
+    }
+}
+
 void chi::pe::chi_rn_initiator_b::clk_counter() {
     if(m_clock_counter > 1){
         if(m_clock_counter < 3 && ProvidedSnpCreditCounter.get() < 15 && snp_counter.get() < snp_req_limit.get_value()) {
@@ -963,6 +985,11 @@ void chi::pe::chi_rn_initiator_b::exec_read_write_protocol(const unsigned int tx
             }
         } else if(trans.is_read() && (phase == chi::BEGIN_PARTIAL_DATA || phase == chi::BEGIN_DATA)) {
             SCCTRACE(SCMOD) << "RDAT flit received. Beat count: " << beat_cnt << ", addr: 0x" << std::hex << trans.get_address();
+            if(!txs->data_received) {
+                txs->data_received = true;
+                txs->first_data_cycle = get_clk_cnt();
+            }
+            txs->last_data_cycle = get_clk_cnt();
             phase = phase == chi::BEGIN_PARTIAL_DATA ? (tlm::tlm_phase)chi::END_PARTIAL_DATA : (tlm::tlm_phase)END_DATA;
             delay = clk_if ? ::scc::time_to_next_posedge(clk_if) - 1_ps : SC_ZERO_TIME;
             socket_fw->nb_transport_fw(trans, phase, delay);
@@ -1058,6 +1085,11 @@ void chi::pe::chi_rn_initiator_b::exec_atomic_protocol(const unsigned int txn_id
                 auto data_ext = trans.get_extension<chi::chi_data_extension>();
                 sc_assert(data_ext);
                 input_beat_cnt++;
+                if(!txs->data_received) {
+                    txs->data_received = true;
+                    txs->first_data_cycle = get_clk_cnt();
+                }
+                txs->last_data_cycle = get_clk_cnt();
                 SCCDEBUG(SCMOD) << "Atomic received data (txn_id,opcode,cmd,addr,len)=(" << txn_id << ","
                                 << to_char(data_ext->dat.get_opcode()) << "," << trans.get_command() << ",0x" << std::hex
                                 << trans.get_address() << "," << trans.get_data_length() << "), beat=" << input_beat_cnt << "/"
@@ -1113,7 +1145,9 @@ void chi::pe::chi_rn_initiator_b::transport(payload_type& trans, bool blocking)
             tx_state_pool.pop_back();
         }
         auto& txs = it->second;
+        txs->data_received = false;
         auto const txn_id = req_ext->get_txn_id();
+        auto const arrival_cycle = get_clk_cnt();
         if(chi::is_request_order(req_ext)) {
             req_order.wait();
         }
@@ -1138,12 +1172,17 @@ void chi::pe::chi_rn_initiator_b::transport(payload_type& trans, bool blocking)
                 }
             }
         } // no timing info in case of STL
+        auto req_cycle = arrival_cycle;
         {
             sem_lock lck(req_chnl);
             // Check if Link-credits are available for sending this transaction and wait if not
             ReceivedReqCreditCounter.wait();
             tx_outstanding++;
             tx_waiting4crd--;
+            req_cycle = get_clk_cnt();
+            if(collect_statistics)
+                statistics.record(stats::initiator_stats::CREDIT_WAIT, trans.is_write(), txn_id, req_ext->get_qos(),
+                                  req_cycle - arrival_cycle);
             SCCTRACE(SCMOD) << "starting transaction with txn_id=" << txn_id;
             m_prev_clk_cnt = get_clk_cnt();
             SCCTRACE(SCMOD) << "Send REQ, addr: 0x" << std::hex << trans.get_address() << ", TxnID: 0x" << std::hex << txn_id;
@@ -1168,10 +1207,13 @@ void chi::pe::chi_rn_initiator_b::transport(payload_type& trans, bool blocking)
             wait(clk_i.posedge_event()); // sync to clock before releasing resource
         }
 
-        if((req_optype_e::AtomicLoadAdd <= req_ext->req.get_opcode()) && (req_ext->req.get_opcode() <= req_optype_e::AtomicCompare))
+        auto completion_cycle = req_cycle;
+        if((req_optype_e::AtomicLoadAdd <= req_ext->req.get_opcode()) && (req_ext->req.get_opcode() <= req_optype_e::AtomicCompare)) {
             exec_atomic_protocol(txn_id, trans, txs);
-        else {
+            completion_cycle = get_clk_cnt();
+        } else {
             exec_read_write_protocol(txn_id, trans, txs);
+            completion_cycle = get_clk_cnt();
             bool is_atomic =
                 req_ext->req.get_opcode() >= req_optype_e::AtomicStoreAdd && req_ext->req.get_opcode() <= req_optype_e::AtomicCompare;
             bool compack_allowed = true;
@@ -1203,6 +1245,15 @@ void chi::pe::chi_rn_initiator_b::transport(payload_type& trans, bool blocking)
             if(!is_atomic && compack_allowed && req_ext->req.is_exp_comp_ack())
                 send_comp_ack(trans, txs);
         }
+        if(collect_statistics) {
+            auto const qos = req_ext->get_qos();
+            if(txs->data_received)
+                statistics.record(stats::initiator_stats::REQ_TO_FIRST_DATA, trans.is_write(), txn_id, qos,
+                                  txs->first_data_cycle - req_cycle);
+            auto last_cycle = txs->data_received ? txs->last_data_cycle : completion_cycle;
+            statistics.record(stats::initiator_stats::REQ_TO_LAST_DATA, trans.is_write(), txn_id, qos, last_cycle - req_cycle);
+            statistics.record_transfer(trans.is_write(), completion_cycle, trans.get_data_length());
+        }
 
         trans.set_response_status(tlm::TLM_OK_RESPONSE);
         wait(clk_i.posedge_event()); // sync to clock
@@ -1372,8 +1423,11 @@ void chi::pe::chi_rn_initiator_b::snoop_handler(payload_type* trans) {
     if(cycles < std::numeric_limits<unsigned>::max()) {
         // we handle the snoop response ourselfs
         auto clock_count = sc_core::sc_time_stamp().value() / clk_if->period().value();
-        auto e = new atp::timing_params(clock_count + cycles - 2);
-        trans->set_auto_extension(e);
+        if(auto e = trans->get_extension<atp::timing_params>()) {
+            e->reset();
+            e->start_soonest = clock_count + cycles - 2;
+        } else
+            trans->set_auto_extension(atp::timing_params::create(clock_count + cycles - 2));
 
         handle_snoop_response(*trans, txs);
         tx_state_pool.push_back(it->second);
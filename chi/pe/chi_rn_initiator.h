@@ -21,6 +21,7 @@
 #include <scc/ordered_semaphore.h>
 #include <scc/peq.h>
 #include <scc/sc_variable.h>
+#include <stats/initiator_stats.h>
 #include <systemc>
 #include <tlm/scc/pe/intor_if.h>
 #include <tlm_utils/peq_with_get.h>
@@ -31,6 +32,15 @@ namespace chi {
 namespace pe {
 
 enum channel_e { REQ = 0, WDAT, SRSP, CRSP, RDAT, SNP, CH_CNT };
+/**
+ * @brief replace the AXI4 or ACE extension of a payload by the equivalent CHI request extension
+ *
+ * @param gp the payload carrying an axi::axi4_extension or axi::ace_extension
+ * @param name the name used for logging
+ * @param legacy_mapping use the legacy mapping of AXI cache attributes to CHI MemAttr
+ */
+void convert_axi4ace_to_chi(tlm::tlm_generic_payload& gp, char const* name, bool legacy_mapping = false);
+
 
 class chi_rn_initiator_b : public sc_core::sc_module,
                            public chi::chi_bw_transport_if<chi::chi_protocol_types>,
@@ -103,6 +113,12 @@ public:
     cci::cci_param<unsigned> cresp_req_credit_limit{"cresp_credit_limit", std::numeric_limits<unsigned>::max()};
 
     cci::cci_param<unsigned> rdat_req_credit_limit{"rdat_credit_limit", std::numeric_limits<unsigned>::max()};
+    //! collect latency histograms and windowed bandwidth of the non-blocking transactions
+    cci::cci_param<bool> enable_statistics{"enable_statistics", false};
+    //! the length of a bandwidth window in clock cycles
+    cci::cci_param<unsigned> statistics_window{"statistics_window", 1000};
+    //! the JSON file the statistics are written to at the end of simulation, defaults to <name>.stats.json
+    cci::cci_param<std::string> statistics_file_name{"statistics_file_name", ""};
 
     void add_protocol_cb(channel_e e, cb_function_t cb) {
         assert(e < CH_CNT);
@@ -110,7 +126,9 @@ public:
     }
 
 protected:
-    void end_of_elaboration() override { clk_if = dynamic_cast<sc_core::sc_clock*>(clk_i.get_interface()); }
+    void end_of_elaboration() override;
+
+    void end_of_simulation() override;
 
     unsigned calculate_beats(payload_type& p) {
         // sc_assert(p.get_data_length() > 0);
@@ -141,6 +159,9 @@ protected:
 
     struct tx_state {
         scc::peq<std::tuple<payload_type*, tlm::tlm_phase>> peq;
+        //! the clock cycles the first and the last read data beat have been received
+        unsigned first_data_cycle{0}, last_data_cycle{0};
+        bool data_received{false};
         tx_state(std::string const& name)
         : peq(sc_core::sc_gen_unique_name(name.c_str())) {}
     };
@@ -172,6 +193,8 @@ protected:
 
     sc_core::sc_time clk_period{10, sc_core::SC_NS};
 
+    stats::initiator_stats statistics;
+
 private:
     void send_wdata(payload_type& trans, chi::pe::chi_rn_initiator_b::tx_state* txs);
     void handle_snoop_response(payload_type& trans, chi::pe::chi_rn_initiator_b::tx_state* txs);
@@ -188,6 +211,7 @@ private:
 
     unsigned m_clock_counter{0};
     unsigned m_prev_clk_cnt{0};
+    bool collect_statistics{false};
 
     sc_core::sc_clock* clk_if{nullptr};
     uint64_t peq_cnt{0};
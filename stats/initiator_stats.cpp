@@ -0,0 +1,91 @@
+/*
+ * Copyright 2021 Arteris IP
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "initiator_stats.h"
+#include <algorithm>
+#include <fstream>
+#include <ostream>
+
+namespace stats {
+namespace {
+char const* metric_names[] = {"credit_wait", "req_to_first_data", "req_to_last_data"};
+char const* cmd_names[] = {"read", "write"};
+
+void write_histogram(std::ostream& os, log_histogram const& h) {
+    os << "{\"count\":" << h.get_count() << ",\"min\":" << h.get_min() << ",\"max\":" << h.get_max() << ",\"mean\":" << h.get_mean()
+       << ",\"p50\":" << h.get_percentile(50) << ",\"p90\":" << h.get_percentile(90) << ",\"p99\":" << h.get_percentile(99)
+       << ",\"p999\":" << h.get_percentile(99.9) << ",\"buckets\":[";
+    auto first = true;
+    for(auto i = 0U; i < log_histogram::BUCKETS; ++i) {
+        if(!h.get_bucket(i))
+            continue;
+        os << (first ? "" : ",") << "[" << log_histogram::lower_bound(i) << "," << h.get_bucket(i) << "]";
+        first = false;
+    }
+    os << "]}";
+}
+} // namespace
+
+void initiator_stats::write_json(std::ostream& os, std::string const& name, uint64_t clk_period_ps) const {
+    os << "{\"name\":\"" << name << "\",\"unit\":\"cycles\",\"clock_period_ps\":" << clk_period_ps << ",\"latency\":{";
+    for(auto m = 0U; m < METRIC_CNT; ++m) {
+        os << (m ? "," : "") << "\"" << metric_names[m] << "\":{";
+        for(auto w = 0U; w < 2; ++w) {
+            auto const& mh = metrics[m];
+            os << (w ? "," : "") << "\"" << cmd_names[w] << "\":{\"all\":";
+            write_histogram(os, mh.by_cmd[w]);
+            std::vector<unsigned> ids;
+            ids.reserve(mh.by_id[w].size());
+            for(auto const& e : mh.by_id[w])
+                ids.push_back(e.first);
+            std::sort(ids.begin(), ids.end());
+            os << ",\"by_id\":{";
+            for(auto i = 0U; i < ids.size(); ++i) {
+                os << (i ? "," : "") << "\"" << ids[i] << "\":";
+                write_histogram(os, mh.by_id[w].at(ids[i]));
+            }
+            os << "},\"by_qos\":{";
+            auto first = true;
+            for(auto q = 0U; q < mh.by_qos[w].size(); ++q) {
+                if(!mh.by_qos[w][q].get_count())
+                    continue;
+                os << (first ? "" : ",") << "\"" << q << "\":";
+                write_histogram(os, mh.by_qos[w][q]);
+                first = false;
+            }
+            os << "}}";
+        }
+        os << "}";
+    }
+    os << "},\"bandwidth\":{\"window_cycles\":" << window_cycles;
+    for(auto w = 0U; w < 2; ++w) {
+        os << ",\"" << cmd_names[w] << "\":{\"transactions\":" << txn_count[w] << ",\"bytes\":" << total_bytes[w] << ",\"windows\":[";
+        for(auto i = 0U; i < windows[w].size(); ++i)
+            os << (i ? "," : "") << windows[w][i];
+        os << "]}";
+    }
+    os << "}}\n";
+}
+
+bool initiator_stats::write_json(std::string const& file_name, std::string const& name, uint64_t clk_period_ps) const {
+    std::ofstream ofs(file_name);
+    if(!ofs.is_open())
+        return false;
+    write_json(ofs, name, clk_period_ps);
+    return ofs.good();
+}
+
+} // namespace stats
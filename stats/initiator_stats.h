@@ -0,0 +1,115 @@
+/*
+ * Copyright 2021 Arteris IP
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <iosfwd>
+#include <stats/log_histogram.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace stats {
+/**
+ * @brief latency and bandwidth statistics of an initiator protocol engine
+ *
+ * All times are given in clock cycles of the initiator. Latencies are collected in log_histogram instances per
+ * command (read/write), per transaction ID and per QoS value. The transferred bytes are accumulated in windows of a
+ * configurable number of cycles to show the bandwidth over time. The statistics are written as a JSON document.
+ */
+class initiator_stats {
+public:
+    enum metric_e {
+        //! cycles from the arrival of a transaction at the PE until its request is sent (channel arbitration and credits)
+        CREDIT_WAIT,
+        //! cycles from sending the request until the first data beat is received
+        REQ_TO_FIRST_DATA,
+        //! cycles from sending the request until the last data beat or the (write) response is received
+        REQ_TO_LAST_DATA,
+        METRIC_CNT
+    };
+    /**
+     * @brief the constructor
+     * @param window_cycles the length of a bandwidth window in clock cycles
+     */
+    initiator_stats(uint64_t window_cycles = 1000)
+    : window_cycles(window_cycles ? window_cycles : 1) {}
+
+    void set_window_cycles(uint64_t cycles) { window_cycles = cycles ? cycles : 1; }
+    /**
+     * @brief add a latency sample
+     * @param m the metric
+     * @param write true if the sample belongs to a write transaction
+     * @param id the transaction ID
+     * @param qos the QoS value, values above 15 are clamped
+     * @param cycles the latency in clock cycles
+     */
+    void record(metric_e m, bool write, unsigned id, unsigned qos, uint64_t cycles) {
+        auto& mh = metrics[m];
+        mh.by_cmd[write].add(cycles);
+        mh.by_id[write][id].add(cycles);
+        mh.by_qos[write][qos < 16 ? qos : 15].add(cycles);
+    }
+    /**
+     * @brief account transferred data
+     * @param write true if the data belongs to a write transaction
+     * @param cycle the clock cycle the transfer finished
+     * @param bytes the number of bytes transferred
+     */
+    void record_transfer(bool write, uint64_t cycle, uint64_t bytes) {
+        auto idx = cycle / window_cycles;
+        auto& w = windows[write];
+        if(idx >= w.size())
+            w.resize(idx + 1, 0);
+        w[idx] += bytes;
+        total_bytes[write] += bytes;
+        txn_count[write]++;
+    }
+
+    log_histogram const& get_histogram(metric_e m, bool write) const { return metrics[m].by_cmd[write]; }
+
+    uint64_t get_total_bytes(bool write) const { return total_bytes[write]; }
+
+    uint64_t get_transaction_count(bool write) const { return txn_count[write]; }
+    /**
+     * @brief write the statistics as JSON object
+     * @param os the stream to write to
+     * @param name the name of the initiator
+     * @param clk_period_ps the clock period in ps, used to convert cycles into absolute numbers
+     */
+    void write_json(std::ostream& os, std::string const& name, uint64_t clk_period_ps) const;
+    /**
+     * @brief write the statistics as JSON document to a file
+     * @return false if the file could not be written
+     */
+    bool write_json(std::string const& file_name, std::string const& name, uint64_t clk_period_ps) const;
+
+private:
+    struct metric_histograms {
+        std::array<log_histogram, 2> by_cmd;
+        std::array<std::unordered_map<unsigned, log_histogram>, 2> by_id;
+        std::array<std::array<log_histogram, 16>, 2> by_qos;
+    };
+    std::array<metric_histograms, METRIC_CNT> metrics;
+    std::array<std::vector<uint64_t>, 2> windows;
+    std::array<uint64_t, 2> total_bytes{{0, 0}};
+    std::array<uint64_t, 2> txn_count{{0, 0}};
+    uint64_t window_cycles;
+};
+
+} // namespace stats
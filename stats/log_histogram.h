@@ -0,0 +1,111 @@
+/*
+ * Copyright 2021 Arteris IP
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+
+//! statistics collected by the protocol engines
+namespace stats {
+/**
+ * @brief a histogram with logarithmic (power of 2) bucket sizes
+ *
+ * Bucket 0 holds the value 0, bucket n holds the values [2^(n-1), 2^n). Adding a sample costs a bit scan and an
+ * increment so the histogram can stay enabled in long running simulations. Percentiles are estimated as the upper
+ * bound of the bucket containing the requested rank, clamped to the observed minimum and maximum.
+ */
+class log_histogram {
+public:
+    static constexpr unsigned BUCKETS = 65;
+
+    void add(uint64_t value) {
+        buckets[bucket_of(value)]++;
+        count++;
+        sum += value;
+        min = std::min(min, value);
+        max = std::max(max, value);
+    }
+
+    void merge(log_histogram const& o) {
+        for(auto i = 0U; i < BUCKETS; ++i)
+            buckets[i] += o.buckets[i];
+        count += o.count;
+        sum += o.sum;
+        min = std::min(min, o.min);
+        max = std::max(max, o.max);
+    }
+
+    uint64_t get_count() const { return count; }
+
+    uint64_t get_sum() const { return sum; }
+
+    uint64_t get_min() const { return count ? min : 0; }
+
+    uint64_t get_max() const { return max; }
+
+    double get_mean() const { return count ? static_cast<double>(sum) / count : 0.0; }
+
+    uint64_t get_bucket(unsigned idx) const { return buckets[idx]; }
+    /**
+     * @brief estimate a percentile
+     * @param p the percentile in the range (0, 100]
+     * @return the upper bound of the bucket holding the percentile
+     */
+    uint64_t get_percentile(double p) const {
+        if(!count)
+            return 0;
+        auto rank = static_cast<uint64_t>(p / 100.0 * count + 0.5);
+        rank = std::max<uint64_t>(1, std::min(rank, count));
+        uint64_t acc = 0;
+        for(auto i = 0U; i < BUCKETS; ++i) {
+            acc += buckets[i];
+            if(acc >= rank)
+                return std::max(get_min(), std::min(max, upper_bound(i)));
+        }
+        return max;
+    }
+    //! the smallest value of the given bucket
+    static uint64_t lower_bound(unsigned idx) { return idx ? uint64_t(1) << (idx - 1) : 0; }
+    //! the largest value of the given bucket
+    static uint64_t upper_bound(unsigned idx) {
+        return idx == 0 ? 0 : idx == 64 ? std::numeric_limits<uint64_t>::max() : (uint64_t(1) << idx) - 1;
+    }
+
+    static unsigned bucket_of(uint64_t value) {
+        if(!value)
+            return 0;
+#if defined(__GNUC__) || defined(__clang__)
+        return 64 - __builtin_clzll(value);
+#else
+        unsigned res = 0;
+        for(; value; value >>= 1)
+            ++res;
+        return res;
+#endif
+    }
+
+private:
+    std::array<uint64_t, BUCKETS> buckets{};
+    uint64_t count{0};
+    uint64_t sum{0};
+    uint64_t min{std::numeric_limits<uint64_t>::max()};
+    uint64_t max{0};
+};
+
+} // namespace stats
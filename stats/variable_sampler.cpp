@@ -0,0 +1,162 @@
+/*
+ * Copyright 2021 Arteris IP
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "variable_sampler.h"
+#include <chrono>
+#include <scc/report.h>
+#include <scc/sc_variable.h>
+
+namespace stats {
+namespace {
+template <typename T> int64_t read_variable(sc_core::sc_object const* obj) {
+    return static_cast<int64_t>(static_cast<scc::sc_variable<T> const*>(obj)->get());
+}
+
+template <typename T> bool try_type(sc_core::sc_object const* obj, int64_t (*&read)(sc_core::sc_object const*)) {
+    if(!dynamic_cast<scc::sc_variable<T> const*>(obj))
+        return false;
+    read = &read_variable<T>;
+    return true;
+}
+} // namespace
+
+variable_sampler::variable_sampler(sc_core::sc_module_name const& nm)
+: sc_core::sc_module(nm) {
+#if SYSTEMC_VERSION < 20250221
+    SC_HAS_PROCESS(variable_sampler);
+#endif
+    SC_THREAD(sample_thread);
+}
+
+variable_sampler::~variable_sampler() { stop_writer(); }
+
+void variable_sampler::end_of_elaboration() { clk_if = dynamic_cast<sc_core::sc_clock*>(clk_i.get_interface()); }
+
+void variable_sampler::collect(sc_core::sc_object const* obj) {
+    int64_t (*read)(sc_core::sc_object const*) = nullptr;
+    if(try_type<unsigned>(obj, read) || try_type<int>(obj, read) || try_type<uint64_t>(obj, read) || try_type<int64_t>(obj, read) ||
+       try_type<bool>(obj, read))
+        columns.push_back({obj->name(), obj, read});
+    for(auto* child : obj->get_child_objects())
+        collect(child);
+}
+
+void variable_sampler::start_of_simulation() {
+    if(!file_name.get_value().length())
+        return;
+    if(scope.get_value().length()) {
+        if(auto* obj = sc_core::sc_find_object(scope.get_value().c_str()))
+            collect(obj);
+        else
+            SCCWARN(SCMOD) << "scope " << scope.get_value() << " not found, no variables are sampled";
+    } else
+        for(auto* obj : sc_core::sc_get_top_level_objects())
+            collect(obj);
+    buffer.resize(1 << 16);
+    ofs.rdbuf()->pubsetbuf(buffer.data(), buffer.size());
+    write_binary = binary.get_value();
+    ofs.open(file_name.get_value(), write_binary ? std::ios::binary | std::ios::out : std::ios::out);
+    if(!ofs.is_open()) {
+        SCCERR(SCMOD) << "Could not open sample file " << file_name.get_value();
+        return;
+    }
+    row_width = columns.size() + 1;
+    ring_rows = std::max(2U, ring_size.get_value());
+    ring.resize(ring_rows * row_width);
+    write_header();
+    writer_thread = std::thread([this]() { writer_loop(); });
+    SCCINFO(SCMOD) << "sampling " << columns.size() << " variables every " << sample_period.get_value() << " cycles into "
+                   << file_name.get_value();
+}
+
+void variable_sampler::end_of_simulation() { stop_writer(); }
+
+void variable_sampler::write_header() {
+    if(write_binary) {
+        ofs.write(SAMPLE_BINARY_MAGIC, sizeof(SAMPLE_BINARY_MAGIC));
+        uint32_t cnt = columns.size();
+        ofs.write(reinterpret_cast<char const*>(&cnt), sizeof(cnt));
+        for(auto const& c : columns) {
+            uint32_t len = c.name.length();
+            ofs.write(reinterpret_cast<char const*>(&len), sizeof(len));
+            ofs.write(c.name.data(), len);
+        }
+    } else {
+        ofs << "cycle";
+        for(auto const& c : columns)
+            ofs << "," << c.name;
+        ofs << "\n";
+    }
+}
+
+void variable_sampler::sample_thread() {
+    wait(sc_core::SC_ZERO_TIME);
+    if(!writer_thread.joinable())
+        return;
+    auto const period = std::max(1U, sample_period.get_value());
+    uint64_t cycle = 0;
+    while(true) {
+        auto h = head.load(std::memory_order_relaxed);
+        while(h - tail.load(std::memory_order_acquire) >= ring_rows)
+            std::this_thread::yield();
+        auto* row = &ring[(h % ring_rows) * row_width];
+        row[0] = static_cast<int64_t>(cycle);
+        for(size_t i = 0; i < columns.size(); ++i)
+            row[i + 1] = columns[i].read(columns[i].var);
+        head.store(h + 1, std::memory_order_release);
+        if(clk_if)
+            wait(clk_if->period() * period);
+        else
+            for(auto i = 0U; i < period; ++i)
+                wait(clk_i.posedge_event());
+        cycle += period;
+    }
+}
+
+void variable_sampler::writer_loop() {
+    while(true) {
+        auto t = tail.load(std::memory_order_relaxed);
+        auto h = head.load(std::memory_order_acquire);
+        if(t == h) {
+            if(stop.load(std::memory_order_acquire) && t == head.load(std::memory_order_acquire))
+                break;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            continue;
+        }
+        for(; t != h; ++t) {
+            auto const* row = &ring[(t % ring_rows) * row_width];
+            if(write_binary)
+                ofs.write(reinterpret_cast<char const*>(row), row_width * sizeof(int64_t));
+            else {
+                ofs << row[0];
+                for(size_t i = 1; i < row_width; ++i)
+                    ofs << ',' << row[i];
+                ofs << '\n';
+            }
+            tail.store(t + 1, std::memory_order_release);
+        }
+    }
+    ofs.close();
+}
+
+void variable_sampler::stop_writer() {
+    if(!writer_thread.joinable())
+        return;
+    stop.store(true, std::memory_order_release);
+    writer_thread.join();
+}
+
+} // namespace stats
@@ -0,0 +1,88 @@
+/*
+ * Copyright 2021 Arteris IP
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cci_configuration>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <systemc>
+#include <thread>
+#include <vector>
+
+namespace stats {
+//! the magic identifying the binary sample file format
+constexpr char SAMPLE_BINARY_MAGIC[8] = {'S', 'C', 'V', 'S', 'M', 'P', 'L', '1'};
+/**
+ * @brief a sampler writing the values of all scc::sc_variable counters (e.g. OutstandingRd, TxOutstanding or
+ * ProvidedSnpCreditCounter) every sample_period clock cycles to a file
+ *
+ * The variables are collected at start of simulation from the object hierarchy below scope. The simulation thread
+ * only copies the values into a lock-free single-producer/single-consumer ring, a background thread formats and
+ * writes them. The CSV format has a header line 'cycle,<variable names>' followed by a line per sample. The binary
+ * format starts with the 8 byte magic SAMPLE_BINARY_MAGIC, the number of columns as uint32_t and for each variable
+ * the length of its name as uint32_t followed by the name. Each sample is a record of (columns + 1) int64_t values
+ * in host byte order, the first being the clock cycle.
+ */
+class variable_sampler : public sc_core::sc_module {
+public:
+    sc_core::sc_in<bool> clk_i{"clk_i"};
+    //! the file to write to, sampling is disabled if empty
+    cci::cci_param<std::string> file_name{"file_name", ""};
+    //! the number of clock cycles between two samples
+    cci::cci_param<unsigned> sample_period{"sample_period", 100};
+    //! write the binary format instead of CSV
+    cci::cci_param<bool> binary{"binary", false};
+    //! the hierarchical name of the object whose variables are sampled, all variables are sampled if empty
+    cci::cci_param<std::string> scope{"scope", ""};
+    //! the number of samples the ring between simulation and writer thread can hold
+    cci::cci_param<unsigned> ring_size{"ring_size", 4096};
+
+    variable_sampler(sc_core::sc_module_name const& nm);
+
+    virtual ~variable_sampler();
+
+protected:
+    struct column {
+        std::string name;
+        sc_core::sc_object const* var;
+        int64_t (*read)(sc_core::sc_object const*);
+    };
+    void end_of_elaboration() override;
+    void start_of_simulation() override;
+    void end_of_simulation() override;
+    void collect(sc_core::sc_object const* obj);
+    void sample_thread();
+    void writer_loop();
+    void write_header();
+    void stop_writer();
+    sc_core::sc_clock* clk_if{nullptr};
+    std::vector<column> columns;
+    size_t row_width{0};
+    size_t ring_rows{0};
+    std::vector<int64_t> ring;
+    std::atomic<uint64_t> head{0};
+    std::atomic<uint64_t> tail{0};
+    std::atomic<bool> stop{false};
+    bool write_binary{false};
+    std::ofstream ofs;
+    std::vector<char> buffer;
+    std::thread writer_thread;
+};
+
+} // namespace stats
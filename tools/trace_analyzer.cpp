@@ -0,0 +1,500 @@
+/*
+ * Copyright 2023 Arteris IP
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * An offline analyzer for the compact traces written by the LWTR recorders (see the traceFile parameter). It
+ * reconstructs the transactions from the recorded phases and reports per stream the latency distribution, the
+ * bandwidth and the number of outstanding transactions over time.
+ *
+ * The trace is processed in windows of data blocks: the blocks of a window are decoded in parallel and their records
+ * are split by transaction into one partition per worker thread. Afterwards each worker reconstructs the transactions
+ * of its partition. As all phases of a transaction end up in the same partition and the blocks are processed in file
+ * order, the workers do not need to synchronize. The per partition statistics are merged at the end.
+ *
+ * Usage: trace_analyzer [--threads=<n>] [--window=<blocks>] [--interval=<ns>] [--csv] <trace file>
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <axi/trace_file.h>
+#include <cerrno>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <stats/log_histogram.h>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+//! the role of a phase when reconstructing a transaction
+enum class role : uint8_t { OTHER, REQUEST, RESPONSE, RESP_END, DATA_END, ACK };
+
+role role_of(std::string const& phase, bool bw) {
+    if(phase == "BEGIN_REQ" || phase == "BEGIN_PARTIAL_REQ")
+        return role::REQUEST;
+    if(phase == "BEGIN_RESP" || phase == "BEGIN_PARTIAL_RESP")
+        return role::RESPONSE;
+    // CHI read data is the response of the request
+    if(bw && (phase == "BEGIN_DATA" || phase == "BEGIN_PARTIAL_DATA"))
+        return role::RESPONSE;
+    if(phase == "END_RESP")
+        return role::RESP_END;
+    // the last beat of CHI read or write data
+    if(phase == "END_DATA")
+        return role::DATA_END;
+    if(phase == "ACK")
+        return role::ACK;
+    return role::OTHER;
+}
+//! the parts of a transaction which need to be finished before it is complete
+enum tx_part : uint8_t { PART_RESP = 1, PART_DATA = 2 };
+/**
+ * @brief checks if all parts of a transaction are finished
+ *
+ * AXI/ACE transactions end with their response. CHI reads end with their last data beat, CHI writes need the write
+ * data and the completion response, dataless CHI requests need the response only and snoops end with either of them.
+ */
+inline bool is_finished(uint8_t flags, uint8_t done) {
+    if(!(flags & axi::TRACE_CHI) || (flags & axi::TRACE_DATALESS))
+        return done & PART_RESP;
+    if(flags & axi::TRACE_SNOOP)
+        return done != 0;
+    if(flags & axi::TRACE_WRITE)
+        return done == (PART_RESP | PART_DATA);
+    return done & PART_DATA;
+}
+//! the roles of the phase ids, the forward roles are at even and the backward roles at odd indexes
+struct phase_roles {
+    std::vector<role> roles;
+
+    void update(std::vector<std::string> const& phases) {
+        for(auto i = roles.size() / 2; i < phases.size(); ++i) {
+            roles.push_back(role_of(phases[i], false));
+            roles.push_back(role_of(phases[i], true));
+        }
+    }
+
+    role get(axi::trace_record const& r) const {
+        auto idx = 2 * r.phase + (r.flags & axi::TRACE_BW ? 1 : 0);
+        return idx < roles.size() ? roles[idx] : role::OTHER;
+    }
+};
+
+struct interval_stats {
+    uint64_t completed{0};
+    uint64_t bytes{0};
+    //! the sum of the time the transactions were outstanding within the interval
+    uint64_t busy{0};
+};
+
+struct stream_stats {
+    stats::log_histogram latency;
+    stats::log_histogram response_latency;
+    uint64_t reads{0};
+    uint64_t writes{0};
+    uint64_t snoops{0};
+    uint64_t incomplete{0};
+    uint64_t bytes{0};
+    uint64_t busy{0};
+    uint64_t first{std::numeric_limits<uint64_t>::max()};
+    uint64_t last{0};
+    std::vector<interval_stats> intervals;
+
+    uint64_t completed() const { return reads + writes + snoops; }
+
+    interval_stats& interval(size_t idx) {
+        if(idx >= intervals.size())
+            intervals.resize(idx + 1);
+        return intervals[idx];
+    }
+
+    void merge(stream_stats const& o) {
+        latency.merge(o.latency);
+        response_latency.merge(o.response_latency);
+        reads += o.reads;
+        writes += o.writes;
+        snoops += o.snoops;
+        incomplete += o.incomplete;
+        bytes += o.bytes;
+        busy += o.busy;
+        first = std::min(first, o.first);
+        last = std::max(last, o.last);
+        for(auto i = 0U; i < o.intervals.size(); ++i) {
+            auto& iv = interval(i);
+            iv.completed += o.intervals[i].completed;
+            iv.bytes += o.intervals[i].bytes;
+            iv.busy += o.intervals[i].busy;
+        }
+    }
+};
+/**
+ * @brief the transactions of one partition of the trace, owned by one worker thread
+ */
+class partition {
+public:
+    partition(phase_roles const& roles, uint64_t interval)
+    : roles(roles)
+    , interval(interval) {}
+
+    void process(axi::trace_record const& r) {
+        if(r.stream >= open.size()) {
+            open.resize(r.stream + 1);
+            streams.resize(r.stream + 1);
+        }
+        auto& txs = open[r.stream];
+        switch(roles.get(r)) {
+        case role::REQUEST: {
+            if(r.flags & axi::TRACE_RETURN)
+                break;
+            auto it = txs.find(r.tx);
+            if(it != txs.end()) {
+                // further request phases belong to the open transaction, an ended one is replaced by the next one
+                if(!it->second.ended)
+                    break;
+                complete(streams[r.stream], it->second, it->second.end);
+                txs.erase(it);
+            }
+            auto& tx = txs[r.tx];
+            tx.start = r.time;
+            tx.flags = r.flags;
+            tx.bytes = static_cast<uint64_t>(std::max<uint16_t>(r.len, 1)) << r.size;
+        } break;
+        case role::RESPONSE: {
+            auto it = txs.find(r.tx);
+            if(it != txs.end() && !it->second.responded) {
+                it->second.response = r.time;
+                it->second.responded = true;
+            }
+        } break;
+        case role::RESP_END:
+            progress(txs, r, PART_RESP);
+            break;
+        case role::DATA_END:
+            progress(txs, r, PART_DATA);
+            break;
+        case role::ACK: {
+            auto it = txs.find(r.tx);
+            if(it != txs.end()) {
+                complete(streams[r.stream], it->second, r.time);
+                txs.erase(it);
+            }
+        } break;
+        default:
+            break;
+        }
+    }
+    //! completes the ended transactions and counts the ones still open at the end of the trace as incomplete
+    void finish() {
+        for(auto i = 0U; i < open.size(); ++i) {
+            for(auto& e : open[i])
+                if(e.second.ended)
+                    complete(streams[i], e.second, e.second.end);
+                else
+                    streams[i].incomplete++;
+            open[i].clear();
+        }
+    }
+
+    std::vector<stream_stats> streams;
+
+private:
+    struct open_tx {
+        uint64_t start{0};
+        uint64_t response{0};
+        uint64_t bytes{0};
+        //! the time the transaction ended if it may still be followed by an ACK
+        uint64_t end{0};
+        uint8_t flags{0};
+        //! the finished tx_parts
+        uint8_t done{0};
+        bool responded{false};
+        bool ended{false};
+    };
+
+    void progress(std::unordered_map<uint64_t, open_tx>& txs, axi::trace_record const& r, tx_part part) {
+        auto it = txs.find(r.tx);
+        if(it == txs.end() || it->second.ended)
+            return;
+        auto& tx = it->second;
+        // e.g. a CHI MakeReadUnique is only known to be dataless once its response is known
+        tx.flags = (tx.flags & ~axi::TRACE_DATALESS) | (r.flags & axi::TRACE_DATALESS);
+        tx.done |= part;
+        if(!is_finished(tx.flags, tx.done))
+            return;
+        if(tx.flags & axi::TRACE_ACK) {
+            // the ACK ends the transaction if present, otherwise it ends now
+            tx.end = r.time;
+            tx.ended = true;
+        } else {
+            complete(streams[r.stream], tx, r.time);
+            txs.erase(it);
+        }
+    }
+
+    void complete(stream_stats& s, open_tx const& tx, uint64_t end) {
+        end = std::max(end, tx.start);
+        s.latency.add(end - tx.start);
+        if(tx.responded)
+            s.response_latency.add(std::max(tx.response, tx.start) - tx.start);
+        if(tx.flags & axi::TRACE_SNOOP)
+            s.snoops++;
+        else {
+            if(tx.flags & axi::TRACE_WRITE)
+                s.writes++;
+            else
+                s.reads++;
+            s.bytes += tx.bytes;
+        }
+        s.busy += end - tx.start;
+        s.first = std::min(s.first, tx.start);
+        s.last = std::max(s.last, end);
+        if(!interval)
+            return;
+        auto& iv = s.interval(end / interval);
+        iv.completed++;
+        if(!(tx.flags & axi::TRACE_SNOOP))
+            iv.bytes += tx.bytes;
+        for(auto t = tx.start; t < end;) {
+            auto idx = t / interval;
+            auto next = std::min((idx + 1) * interval, end);
+            s.interval(idx).busy += next - t;
+            t = next;
+        }
+    }
+
+    phase_roles const& roles;
+    uint64_t const interval;
+    std::vector<std::unordered_map<uint64_t, open_tx>> open;
+};
+
+inline unsigned partition_of(axi::trace_record const& r, unsigned partitions) {
+    auto const hash = (r.tx ^ (static_cast<uint64_t>(r.stream) << 48)) * 0x9e3779b97f4a7c15ULL;
+    return static_cast<unsigned>(hash >> 32) % partitions;
+}
+
+template <typename FUNC> void run_parallel(unsigned threads, FUNC const& func) {
+    std::vector<std::thread> workers;
+    for(auto i = 1U; i < threads; ++i)
+        workers.emplace_back(func, i);
+    func(0);
+    for(auto& w : workers)
+        w.join();
+}
+
+std::string get_option(int argc, char* argv[], char const* prefix, std::string const& default_value = "") {
+    auto const len = std::strlen(prefix);
+    for(auto i = 1; i < argc; ++i)
+        if(std::strncmp(argv[i], prefix, len) == 0)
+            return argv[i] + len;
+    return default_value;
+}
+
+//! parses an unsigned decimal option value, returns false if it is malformed or out of range
+bool parse_option(std::string const& opt, unsigned& val) {
+    auto const* str = opt.c_str();
+    char* end = nullptr;
+    errno = 0;
+    auto v = std::strtoul(str, &end, 10);
+    if(end == str || *end || errno || *str == '-' || v > std::numeric_limits<unsigned>::max())
+        return false;
+    val = static_cast<unsigned>(v);
+    return true;
+}
+//! parses a non-negative option value, returns false if it is malformed or out of range
+bool parse_option(std::string const& opt, double& val) {
+    auto const* str = opt.c_str();
+    char* end = nullptr;
+    errno = 0;
+    auto v = std::strtod(str, &end);
+    if(end == str || *end || errno || !std::isfinite(v) || v < 0)
+        return false;
+    val = v;
+    return true;
+}
+
+bool has_flag(int argc, char* argv[], char const* flag) {
+    for(auto i = 1; i < argc; ++i)
+        if(std::strcmp(argv[i], flag) == 0)
+            return true;
+    return false;
+}
+
+struct analyzer_config {
+    unsigned threads{0};
+    unsigned window{0};
+    //! the interval of the timeline in ns, 0 disables the timeline
+    double interval_ns{0};
+    bool csv;
+    //! false if an option value is malformed
+    bool valid;
+    std::string file;
+
+    analyzer_config(int argc, char* argv[])
+    : csv(has_flag(argc, argv, "--csv"))
+    , valid(parse_option(get_option(argc, argv, "--threads=", "0"), threads) &&
+            parse_option(get_option(argc, argv, "--window=", "0"), window) &&
+            parse_option(get_option(argc, argv, "--interval=", "0"), interval_ns)) {
+        for(auto i = 1; i < argc; ++i)
+            if(std::strncmp(argv[i], "--", 2) != 0)
+                file = argv[i];
+        if(!threads)
+            threads = std::max(1U, std::thread::hardware_concurrency());
+        if(!window)
+            window = 4 * threads;
+    }
+};
+
+void print_report(analyzer_config const& cfg, std::vector<std::string> const& names, std::vector<stream_stats> const& streams,
+                  double ns_per_unit, uint64_t interval) {
+    auto ns = [ns_per_unit](double v) { return v * ns_per_unit; };
+    if(cfg.csv)
+        std::printf("stream,reads,writes,snoops,incomplete,lat_min_ns,lat_mean_ns,lat_p50_ns,lat_p90_ns,lat_p99_ns,lat_max_ns,"
+                    "resp_mean_ns,resp_p99_ns,bytes,bandwidth_mbps,avg_outstanding\n");
+    for(auto i = 0U; i < streams.size(); ++i) {
+        auto const& s = streams[i];
+        if(!s.completed() && !s.incomplete)
+            continue;
+        auto const name = i < names.size() ? names[i] : std::to_string(i);
+        auto const duration = s.last > s.first ? s.last - s.first : 0;
+        auto const bandwidth = duration ? s.bytes / ns(duration) * 1e3 : 0.0;
+        auto const outstanding = duration ? static_cast<double>(s.busy) / duration : 0.0;
+        auto const& l = s.latency;
+        auto const& r = s.response_latency;
+        if(cfg.csv) {
+            std::printf("%s,%llu,%llu,%llu,%llu,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%llu,%.3f,%.3f\n", name.c_str(),
+                        static_cast<unsigned long long>(s.reads), static_cast<unsigned long long>(s.writes),
+                        static_cast<unsigned long long>(s.snoops), static_cast<unsigned long long>(s.incomplete),
+                        ns(l.get_min()), ns(l.get_mean()), ns(l.get_percentile(50)), ns(l.get_percentile(90)),
+                        ns(l.get_percentile(99)), ns(l.get_max()), ns(r.get_mean()), ns(r.get_percentile(99)),
+                        static_cast<unsigned long long>(s.bytes), bandwidth, outstanding);
+        } else {
+            std::printf("%s\n", name.c_str());
+            std::printf("  transactions:     %llu reads, %llu writes, %llu snoops, %llu incomplete\n",
+                        static_cast<unsigned long long>(s.reads), static_cast<unsigned long long>(s.writes),
+                        static_cast<unsigned long long>(s.snoops), static_cast<unsigned long long>(s.incomplete));
+            std::printf("  latency:          min %.3f ns, mean %.3f ns, p50 %.3f ns, p90 %.3f ns, p99 %.3f ns, max %.3f ns\n",
+                        ns(l.get_min()), ns(l.get_mean()), ns(l.get_percentile(50)), ns(l.get_percentile(90)),
+                        ns(l.get_percentile(99)), ns(l.get_max()));
+            std::printf("  response latency: mean %.3f ns, p99 %.3f ns\n", ns(r.get_mean()), ns(r.get_percentile(99)));
+            std::printf("  bandwidth:        %.3f MB/s (%llu bytes in %.3f ns)\n", bandwidth,
+                        static_cast<unsigned long long>(s.bytes), ns(duration));
+            std::printf("  avg outstanding:  %.3f\n", outstanding);
+        }
+    }
+    if(!interval)
+        return;
+    // the labels use the interval the records were bucketed with, it is truncated to the time resolution
+    auto const interval_ns = ns(interval);
+    std::printf(cfg.csv ? "\nstream,start_ns,completed,bytes,bandwidth_mbps,avg_outstanding\n"
+                        : "\ntimeline (stream, start [ns], completed, bytes, bandwidth [MB/s], avg outstanding)\n");
+    for(auto i = 0U; i < streams.size(); ++i) {
+        auto const name = i < names.size() ? names[i] : std::to_string(i);
+        auto const& ivs = streams[i].intervals;
+        for(auto j = 0U; j < ivs.size(); ++j)
+            std::printf(cfg.csv ? "%s,%.3f,%llu,%llu,%.3f,%.3f\n" : "  %s %.3f %llu %llu %.3f %.3f\n", name.c_str(),
+                        j * interval_ns, static_cast<unsigned long long>(ivs[j].completed),
+                        static_cast<unsigned long long>(ivs[j].bytes), ivs[j].bytes / interval_ns * 1e3,
+                        static_cast<double>(ivs[j].busy) / interval);
+    }
+}
+} // namespace
+
+int main(int argc, char* argv[]) {
+    analyzer_config cfg(argc, argv);
+    if(!cfg.valid || cfg.file.empty()) {
+        std::fprintf(stderr, "usage: %s [--threads=<n>] [--window=<blocks>] [--interval=<ns>] [--csv] <trace file>\n", argv[0]);
+        return 1;
+    }
+    axi::trace_reader reader;
+    if(!reader.open(cfg.file)) {
+        std::fprintf(stderr, "could not open trace file '%s'\n", cfg.file.c_str());
+        return 1;
+    }
+    phase_roles roles;
+    std::vector<partition> partitions;
+    std::vector<std::string> raw(cfg.window);
+    // the records of the blocks of a window split by partition, indexed by block * threads + partition
+    std::vector<std::vector<axi::trace_record>> chunks(cfg.window * cfg.threads);
+    std::atomic<uint64_t> records{0};
+    std::atomic<bool> corrupted{false};
+    uint64_t blocks = 0;
+    double ns_per_unit = 0;
+    // the interval of the timeline in units of the time resolution
+    uint64_t interval = 0;
+    while(true) {
+        auto n = 0U;
+        while(n < cfg.window && reader.read_raw(raw[n]))
+            ++n;
+        if(!n)
+            break;
+        blocks += n;
+        // the names of the phases used in a data block are written before the block
+        roles.update(reader.get_phases());
+        if(partitions.empty()) {
+            ns_per_unit = reader.get_resolution() / 1e6;
+            interval = ns_per_unit > 0 ? static_cast<uint64_t>(cfg.interval_ns / ns_per_unit) : 0;
+            if(cfg.interval_ns > 0 && !interval) {
+                std::fprintf(stderr, "the interval is smaller than the time resolution of the trace\n");
+                return 1;
+            }
+            for(auto i = 0U; i < cfg.threads; ++i)
+                partitions.emplace_back(roles, interval);
+        }
+        run_parallel(cfg.threads, [&](unsigned w) {
+            std::vector<axi::trace_record> block;
+            for(auto i = w; i < n; i += cfg.threads) {
+                if(!axi::trace_reader::decode(raw[i], block)) {
+                    corrupted = true;
+                    continue;
+                }
+                records += block.size();
+                for(auto& r : block)
+                    chunks[i * cfg.threads + partition_of(r, cfg.threads)].push_back(r);
+            }
+        });
+        run_parallel(cfg.threads, [&](unsigned w) {
+            for(auto i = 0U; i < n; ++i) {
+                auto& chunk = chunks[i * cfg.threads + w];
+                for(auto& r : chunk)
+                    partitions[w].process(r);
+                chunk.clear();
+            }
+        });
+    }
+    // a truncated block is not the end of the trace
+    if(reader.is_corrupted())
+        corrupted = true;
+    if(corrupted)
+        std::fprintf(stderr, "the trace file '%s' contains corrupted blocks\n", cfg.file.c_str());
+    std::vector<stream_stats> streams;
+    for(auto& p : partitions) {
+        p.finish();
+        if(p.streams.size() > streams.size())
+            streams.resize(p.streams.size());
+        for(auto i = 0U; i < p.streams.size(); ++i)
+            streams[i].merge(p.streams[i]);
+    }
+    if(!cfg.csv)
+        std::printf("trace:            %s (%llu records in %llu blocks)\n", cfg.file.c_str(),
+                    static_cast<unsigned long long>(records), static_cast<unsigned long long>(blocks));
+    print_report(cfg, reader.get_streams(), streams, ns_per_unit, interval);
+    return corrupted ? 1 : 0;
+}